@@ -0,0 +1,325 @@
+/**
+ * @file bench_modAlphaCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Замер производительности шифра Гронсфельда
+ * @details Без аргументов режима перебирает длины текста от 8 символов до
+ *          1 ГБ в UTF-8, длины ключа и варианты интерфейса и печатает
+ *          наносекунды на символ, МБ/с, выделения памяти на вызов и
+ *          выделенные байты на символ в CSV (--json - в JSON). По последнему
+ *          столбцу видны промежуточные копии текста: у однопроходных
+ *          encrypt и decrypt остаётся только строка результата (4 байта на
+ *          символ для wide). Для самых длинных текстов нужно около четырёх
+ *          размеров текста оперативной памяти, предел задаётся --max-mb.
+ *          Режим batch сравнивает пакетную обработку сообщений с вызовом
+ *          encrypt на каждое сообщение, режим errors - обработку потока с
+ *          долей ошибочных сообщений через encryptInto с перехватом
+ *          исключений и через tryEncryptInto. Режим pipeline сравнивает
+ *          последовательную обработку файла размером --max-mb с конвейером
+ *          filePipeline.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "modAlphaCipher.h"
+#include "gronsfeldFixed.h"
+#include "gronsfeldPipeline.h"
+#include "../common/benchSuite.h"
+
+/// Ключ из 16 букв для шифра с ключом на этапе компиляции
+constexpr wchar_t fixedKey[] = L"ФИКСИРОВАННЫЙКЛЮ";
+
+/**
+ * @brief Сравнение пакетной обработки с вызовом encrypt на каждое сообщение
+ * @details Печатает наносекунды на сообщение для сообщений из 16, 256 и 4096 символов
+ */
+void runBatch()
+{
+    const std::wstring sample = L"Съешь же ещё этих мягких французских булок, да выпей чаю ";
+    modAlphaCipher cipher(L"ПАКЕТНЫЙКЛЮЧ");
+
+    std::printf("chars,messages,wide_per_call_ns,utf8_per_call_ns,batch_ns,speedup\n");
+    for (size_t chars : {16, 256, 4096}) {
+        const size_t count = chars == 4096 ? 1000 : 100000 / (chars / 16);
+        std::vector<std::wstring> wide(count);
+        std::vector<std::string> utf8(count);
+        std::string text;
+        std::vector<size_t> offsets(1, 0);
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < chars; j++) {
+                wide[i] += sample[(i + j) % sample.size()];
+            }
+            utf8[i] = benchUtf8(wide[i]);
+            text += utf8[i];
+            offsets.push_back(text.size());
+        }
+
+        const int rounds = 20;
+        double wideNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::wstring& m : wide) {
+                n += cipher.encrypt(m).size();
+            }
+            return n;
+        }, count, rounds);
+        double utf8Ns = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : utf8) {
+                n += cipher.encrypt(std::string_view(m)).size();
+            }
+            return n;
+        }, count, rounds);
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<modAlphaCipher::textStatus> status;
+        double batchNs = benchNsPerMessage([&] {
+            cipher.encryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, status);
+            return arena.size();
+        }, count, rounds);
+        std::printf("%zu,%zu,%.1f,%.1f,%.1f,%.1f\n", chars, count, wideNs, utf8Ns, batchNs, utf8Ns / batchNs);
+    }
+}
+
+/**
+ * @brief Сравнение обработки ошибочных сообщений исключениями и кодами ошибок
+ * @details Сообщения из 64 символов, ошибочные не содержат русских букв и
+ *          составляют 0, 5, 10 или 50 процентов потока. Печатает наносекунды
+ *          на сообщение для encryptInto с перехватом cipher_error и для
+ *          tryEncryptInto с тем же буфером.
+ */
+void runErrors()
+{
+    const std::wstring sample = L"Съешь же ещё этих мягких французских булок, да выпей чаю ";
+    const std::string malformed = "2025-12-03 00:00:00 #000000000 -- 0000000000000000000000000000000";
+    modAlphaCipher cipher(L"ПАКЕТНЫЙКЛЮЧ");
+    const size_t count = 100000;
+    const int rounds = 20;
+    std::vector<char> out(2 * malformed.size());
+
+    std::printf("malformed_percent,messages,throw_ns,try_ns,speedup\n");
+    for (size_t percent : {0, 5, 10, 50}) {
+        std::vector<std::string> messages(count);
+        // Ошибочные сообщения распределены по потоку равномерно
+        for (size_t i = 0; i < count; i++) {
+            if (i * percent % 100 + percent >= 100) {
+                messages[i] = malformed;
+                continue;
+            }
+            std::wstring m;
+            for (size_t j = 0; j < malformed.size(); j++) {
+                m += sample[(i + j) % sample.size()];
+            }
+            messages[i] = benchUtf8(m);
+        }
+
+        double throwNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                try {
+                    n += cipher.encryptInto(std::string_view(m), out.data(), out.size());
+                } catch (const cipher_error&) {
+                    n++;
+                }
+            }
+            return n;
+        }, count, rounds);
+        double tryNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                modAlphaCipher::result r = cipher.tryEncryptInto(std::string_view(m), out.data(), out.size());
+                n += r ? r.size : 1;
+            }
+            return n;
+        }, count, rounds);
+        std::printf("%zu,%zu,%.1f,%.1f,%.2f\n", percent, count, throwNs, tryNs, throwNs / tryNs);
+    }
+}
+
+/**
+ * @brief Сравнение последовательной обработки файла с конвейером
+ * @details Создаёт во временном каталоге (TMPDIR или /tmp) файл размером
+ *          --max-mb, зашифровывает его целиком через отображение в память,
+ *          как файловый режим программы табличного шифра, и конвейером с 1,
+ *          2, 4 рабочими потоками и по числу ядер, затем так же
+ *          расшифровывает шифртекст. Для замера на нескольких гигабайтах
+ *          задаётся, например, --max-mb 4096; файлы остаются в кэше
+ *          страниц, если хватает оперативной памяти.
+ * @param options Параметры запуска
+ * @return 0 при успешном выполнении, 1 при ошибке файлов или расхождении размеров результата
+ */
+int runPipeline(const benchOptions& options)
+{
+    const char* dir = std::getenv("TMPDIR") != nullptr ? std::getenv("TMPDIR") : "/tmp";
+    const std::string input = std::string(dir) + "/bench_gronsfeld_in.txt";
+    const std::string encrypted = std::string(dir) + "/bench_gronsfeld_enc.txt";
+    const std::string output = std::string(dir) + "/bench_gronsfeld_out.txt";
+    if (!benchWriteFile(input.c_str(), options.maxBytes)) {
+        std::fprintf(stderr, "Не удалось создать %s\n", input.c_str());
+        return 1;
+    }
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> workers = {1, 2, 4, cores};
+    std::sort(workers.begin(), workers.end());
+    workers.erase(std::unique(workers.begin(), workers.end()), workers.end());
+
+    const modAlphaCipher cipher(L"КОНВЕЙЕРНЫЙКЛЮЧ");
+    int code = 0;
+    std::printf("module,operation,api,workers,bytes,seconds,mb_per_s,read_s,transform_s,write_s\n");
+    try {
+        for (bool decrypting : {false, true}) {
+            const char* operation = decrypting ? "decrypt" : "encrypt";
+            const std::string& from = decrypting ? encrypted : input;
+            const std::string& to = decrypting ? output : encrypted;
+            const filePipeline::report mapped = benchMapped(from.c_str(), to.c_str(),
+                [&](std::string_view text, char* out, size_t capacity) {
+                    return decrypting ? cipher.decryptInto(text, out, capacity)
+                                      : cipher.encryptInto(text, out, capacity);
+                });
+            benchFileRow("gronsfeld", operation, "mapped", 1, mapped);
+            for (unsigned n : workers) {
+                filePipeline::options settings;
+                settings.workers = n;
+                const filePipeline::report r = benchPipeline(gronsfeldPipeline(cipher, decrypting, settings),
+                                                             from.c_str(), to.c_str());
+                benchFileRow("gronsfeld", operation, "pipeline", n, r);
+                if (r.bytesOut != mapped.bytesOut) {
+                    std::fprintf(stderr, "Размер результата конвейера %llu, ожидался %llu\n", r.bytesOut,
+                                 mapped.bytesOut);
+                    code = 1;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Ошибка: %s\n", e.what());
+        code = 1;
+    }
+    unlink(input.c_str());
+    unlink(encrypted.c_str());
+    unlink(output.c_str());
+    return code;
+}
+
+/**
+ * @brief Перебор длин текста, длин ключа и вариантов интерфейса
+ * @param options Параметры запуска
+ */
+void runSuite(const benchOptions& options)
+{
+    // Широкие строки занимают вдвое больше UTF-8, для них длина текста ограничена
+    const size_t maxWideChars = size_t(1) << 26;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    benchReport report(options.json);
+    for (size_t chars = options.minChars; 2 * chars <= options.maxBytes; chars *= 4) {
+        size_t letters = 0;
+        const std::string text = benchText(chars, true, letters);
+        std::string cipherText(text.size(), '\0');
+        std::string out(text.size(), '\0');
+        std::wstring wide;
+        std::wstring wideCipher;
+        std::wstring wideOut;
+        if (chars <= maxWideChars) {
+            wide = benchWide(text);
+            wideOut.resize(wide.size());
+        }
+
+        for (size_t keyLength : {1, 4, 16, 64, 256}) {
+            size_t keyLetters = 0;
+            modAlphaCipher cipher(benchWide(benchText(keyLength, false, keyLetters)));
+            cipherText.resize(cipher.encryptInto(std::string_view(text), &cipherText[0], cipherText.size()));
+            const size_t cipherChars = cipherText.size() / 2;
+
+            auto add = [&](const char* operation, const char* api, size_t n, size_t bytes, unsigned threads, auto f) {
+                report.add("gronsfeld", operation, api, n, bytes, keyLength, threads, benchMeasure(f, n, bytes));
+            };
+            add("encrypt", "utf8", chars, text.size(), 1, [&] {
+                return cipher.encrypt(std::string_view(text)).size();
+            });
+            add("encrypt", "utf8_into", chars, text.size(), 1, [&] {
+                return cipher.encryptInto(std::string_view(text), &out[0], out.size());
+            });
+            add("decrypt", "utf8", cipherChars, cipherText.size(), 1, [&] {
+                return cipher.decrypt(std::string_view(cipherText)).size();
+            });
+            add("decrypt", "utf8_into", cipherChars, cipherText.size(), 1, [&] {
+                return cipher.decryptInto(std::string_view(cipherText), &out[0], out.size());
+            });
+            // Шифр с ключом на этапе компиляции сравнивается с ключом той же длины
+            using fixed = gronsfeldFixed<fixedKey>;
+            if (keyLength == fixed::period) {
+                add("encrypt", "utf8_into_fixed", chars, text.size(), 1, [&] {
+                    return fixed::encryptInto(std::string_view(text), &out[0], out.size());
+                });
+                add("decrypt", "utf8_into_fixed", cipherChars, cipherText.size(), 1, [&] {
+                    return fixed::decryptInto(std::string_view(cipherText), &out[0], out.size());
+                });
+            }
+            if (chars > maxWideChars) {
+                continue;
+            }
+            wideCipher = cipher.encrypt(wide);
+            const size_t wideBytes = wide.size() * sizeof(wchar_t);
+            add("encrypt", "wide", chars, wideBytes, 1, [&] { return cipher.encrypt(wide).size(); });
+            add("encrypt", "wide_into", chars, wideBytes, 1, [&] {
+                return cipher.encryptInto(std::wstring_view(wide), &wideOut[0], wideOut.size());
+            });
+            const size_t cipherBytes = wideCipher.size() * sizeof(wchar_t);
+            if (keyLength == fixed::period) {
+                add("encrypt", "wide_into_fixed", chars, wideBytes, 1, [&] {
+                    return fixed::encryptInto(std::wstring_view(wide), &wideOut[0], wideOut.size());
+                });
+                add("decrypt", "wide_into_fixed", cipherChars, cipherBytes, 1, [&] {
+                    return fixed::decryptInto(std::wstring_view(wideCipher), &wideOut[0], wideOut.size());
+                });
+            }
+            add("decrypt", "wide", cipherChars, cipherBytes, 1, [&] { return cipher.decrypt(wideCipher).size(); });
+            add("decrypt", "wide_into", cipherChars, cipherBytes, 1, [&] {
+                return cipher.decryptInto(std::wstring_view(wideCipher), &wideOut[0], wideOut.size());
+            });
+            // Многопоточный режим замеряется, только когда текста хватает на все ядра
+            if (cores > 1 && chars >= (size_t(cores) << 16)) {
+                add("encrypt", "wide_threads", chars, wideBytes, cores, [&] {
+                    return cipher.encrypt(wide, cores).size();
+                });
+                add("decrypt", "wide_threads", cipherChars, cipherBytes, cores, [&] {
+                    return cipher.decrypt(wideCipher, cores).size();
+                });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Главная функция программы
+ * @param argc Количество аргументов
+ * @param argv Аргументы: [batch|errors|pipeline] [--json|--csv] [--max-mb N] [--min-chars N]
+ * @return 0 при успешном выполнении, 1 при неверных аргументах или ошибке файлов
+ */
+int main(int argc, char** argv)
+{
+    benchOptions options;
+    const bool parsed = options.parse(argc, argv);
+    const std::string mode = options.mode != nullptr ? options.mode : "";
+    if (!parsed || (!mode.empty() && mode != "batch" && mode != "errors" && mode != "pipeline")) {
+        std::fprintf(stderr, "Использование: %s [batch|errors|pipeline] [--json|--csv] [--max-mb N] [--min-chars N]\n", argv[0]);
+        return 1;
+    }
+    if (mode == "batch") {
+        runBatch();
+    } else if (mode == "errors") {
+        runErrors();
+    } else if (mode == "pipeline") {
+        return runPipeline(options);
+    } else {
+        runSuite(options);
+    }
+    return 0;
+}
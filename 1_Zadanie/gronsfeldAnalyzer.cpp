@@ -0,0 +1,370 @@
+/**
+ * @file gronsfeldAnalyzer.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация модуля восстановления ключа шифра Гронсфельда
+ */
+
+#include "gronsfeldAnalyzer.h"
+#include "modAlphaCipher.h"
+#include "../common/russianText.h"
+#include "../common/parallelTasks.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+/// Наименьшая длина строки таблицы при построении гистограмм
+constexpr size_t minRow = 8;
+
+/**
+ * @brief Частоты букв русского языка в процентах
+ * @details Порядок - номера букв модуля: А Б В Г Д Е Ё Ж З И Й К Л М Н О П Р
+ *          С Т У Ф Х Ц Ч Ш Щ Ъ Ы Ь Э Ю Я
+ */
+constexpr double percent[33] = {
+    8.01, 1.59, 4.54, 1.70, 2.98, 8.45, 0.04, 0.94, 1.65, 7.35, 1.21,
+    3.49, 4.40, 3.21, 6.70, 10.97, 2.81, 4.73, 5.47, 6.26, 2.62, 0.26,
+    0.97, 0.48, 1.44, 0.73, 0.36, 0.04, 1.90, 1.74, 0.32, 0.64, 2.01,
+};
+
+/**
+ * @brief Частоты букв, приведённые к сумме 1
+ */
+struct shares {
+    double value[33]; ///< Доля буквы по номеру
+
+    /**
+     * @brief Нормировка процентов на этапе компиляции
+     */
+    constexpr shares() : value()
+    {
+        double total = 0;
+        for (double p : percent) {
+            total += p;
+        }
+        for (int i = 0; i < 33; i++) {
+            value[i] = percent[i] / total;
+        }
+    }
+};
+
+/// Нормированные частоты букв
+constexpr shares russianShares;
+
+}
+
+/**
+ * @brief Конструктор с разбором шифртекста
+ * @details Сообщения об ошибках те же, что у modAlphaCipher::decrypt.
+ * @param cipher_text Шифртекст из заглавных русских букв
+ * @throw cipher_error Если шифртекст пустой или содержит другие символы
+ */
+gronsfeldAnalyzer::gronsfeldAnalyzer(const std::wstring& cipher_text)
+{
+    if (cipher_text.empty()) {
+        throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::emptyCipherText));
+    }
+    letters.resize(cipher_text.size());
+    for (size_t i = 0; i < cipher_text.size(); i++) {
+        int index = russianText::upperIndex(static_cast<char32_t>(cipher_text[i]));
+        if (index < 0) {
+            throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidCipherText));
+        }
+        letters[i] = static_cast<unsigned char>(index);
+    }
+}
+
+/**
+ * @brief Конструктор с разбором шифртекста в кодировке UTF-8
+ * @details Некорректная последовательность UTF-8 считается недопустимым
+ *          символом.
+ * @param cipher_text Шифртекст из заглавных русских букв в UTF-8
+ * @throw cipher_error Если шифртекст пустой или содержит другие символы
+ */
+gronsfeldAnalyzer::gronsfeldAnalyzer(std::string_view cipher_text)
+{
+    if (cipher_text.empty()) {
+        throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::emptyCipherText));
+    }
+    letters.reserve(cipher_text.size() / 2);
+    const char* end = cipher_text.data() + cipher_text.size();
+    for (const char* p = cipher_text.data(); p != end;) {
+        int index = russianText::upperIndex(russianText::decodeUtf8(p, end));
+        if (index < 0) {
+            throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidCipherText));
+        }
+        letters.push_back(static_cast<unsigned char>(index));
+    }
+}
+
+/**
+ * @brief Частоты букв русского языка
+ * @return 33 доли в порядке номеров букв, в сумме 1
+ */
+const double* gronsfeldAnalyzer::frequencies()
+{
+    return russianShares.value;
+}
+
+/**
+ * @brief Гистограммы столбцов шифртекста
+ * @details Счётчики ведутся для строки ширины width, кратной period и не
+ *          меньшей minRow, и в конце сворачиваются в period столбцов. Так
+ *          подряд идущие буквы одного столбца увеличивают разные счётчики и
+ *          не ждут друг друга через память даже при длине ключа 1.
+ * @param data Номера букв, data[0] относится к столбцу 0
+ * @param n Количество номеров
+ * @param period Длина ключа
+ * @param counts Счётчики [столбец * 33 + номер буквы], увеличиваются
+ */
+void gronsfeldAnalyzer::columnHistogram(const unsigned char* data, size_t n, size_t period, uint64_t* counts)
+{
+    const size_t width = period * ((minRow + period - 1) / period);
+    std::vector<uint64_t> local(width * alphaSize, 0);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        const unsigned char* row = data + i;
+        for (size_t j = 0; j < width; j++) {
+            local[j * alphaSize + row[j]]++;
+        }
+    }
+    for (size_t j = 0; i + j < n; j++) {
+        local[j * alphaSize + data[i + j]]++;
+    }
+    for (size_t j = 0; j < width; j++) {
+        uint64_t* column = counts + (j % period) * alphaSize;
+        for (int c = 0; c < alphaSize; c++) {
+            column[c] += local[j * alphaSize + c];
+        }
+    }
+}
+
+/**
+ * @brief Гистограммы столбцов с разбиением текста по потокам
+ * @details Границы частей кратны period, поэтому каждая часть начинается
+ *          с нулевого столбца; счётчики частей складываются.
+ * @param n Количество номеров с начала текста
+ * @param period Длина ключа
+ * @param threads Количество потоков
+ * @return Счётчики [столбец * 33 + номер буквы]
+ */
+std::vector<uint64_t> gronsfeldAnalyzer::histogram(size_t n, size_t period, unsigned threads) const
+{
+    const size_t rows = (n + period - 1) / period;
+    threads = parallelTasks::threadCount(threads, rows / minRow);
+    const size_t chunk = (rows + threads - 1) / threads * period;
+    std::vector<std::vector<uint64_t>> parts(threads, std::vector<uint64_t>(period * alphaSize, 0));
+    parallelTasks::run(threads, [&](unsigned t) {
+        const size_t first = std::min(n, t * chunk);
+        const size_t last = std::min(n, first + chunk);
+        columnHistogram(letters.data() + first, last - first, period, parts[t].data());
+    });
+    for (unsigned t = 1; t < threads; t++) {
+        for (size_t i = 0; i < parts[0].size(); i++) {
+            parts[0][i] += parts[t][i];
+        }
+    }
+    return parts[0];
+}
+
+/**
+ * @brief Подбор ключа и оценка по гистограммам столбцов
+ * @details Для каждого столбца перебираются 33 сдвига; сдвиг s переводит
+ *          букву открытого текста c в букву шифртекста (c + s) mod 33, и
+ *          выбирается сдвиг с наименьшим хи-квадрат. Столбцы короче двух букв
+ *          в индекс совпадений не входят.
+ * @param counts Счётчики [столбец * 33 + номер буквы]
+ * @param period Длина ключа
+ * @return Кандидат с ключом длины period
+ */
+gronsfeldAnalyzer::candidate gronsfeldAnalyzer::fit(const std::vector<uint64_t>& counts, size_t period)
+{
+    const std::wstring& alpha = russianText::alphabet();
+    const double* expected = frequencies();
+    candidate result{std::wstring(period, alpha[0]), 0, 0};
+    size_t scored = 0;
+    for (size_t j = 0; j < period; j++) {
+        const uint64_t* column = counts.data() + j * alphaSize;
+        uint64_t total = 0;
+        uint64_t pairs = 0;
+        for (int c = 0; c < alphaSize; c++) {
+            total += column[c];
+            pairs += column[c] * (column[c] - (column[c] != 0));
+        }
+        if (total >= 2) {
+            result.score += static_cast<double>(pairs) / (static_cast<double>(total) * (total - 1));
+            scored++;
+        }
+
+        double best = 0;
+        int bestShift = 0;
+        for (int s = 0; s < alphaSize; s++) {
+            double chi = 0;
+            for (int c = 0; c < alphaSize; c++) {
+                const double e = expected[c] * total;
+                const double d = static_cast<double>(column[(c + s) % alphaSize]) - e;
+                chi += d * d / e;
+            }
+            if (s == 0 || chi < best) {
+                best = chi;
+                bestShift = s;
+            }
+        }
+        result.key[j] = alpha[bestShift];
+        result.chiSquare += best;
+    }
+    if (scored != 0) {
+        result.score /= scored;
+    }
+    result.chiSquare /= period;
+    return result;
+}
+
+/**
+ * @brief Наименьший период ключа
+ * @details Период должен делить длину ключа: шифр повторяет ключ целиком,
+ *          поэтому только такой более короткий ключ даёт тот же шифртекст.
+ * @param key Ключ
+ * @return Длина наименьшего повторяющегося начала ключа
+ */
+size_t gronsfeldAnalyzer::minimalPeriod(const std::wstring& key)
+{
+    for (size_t q = 1; q < key.size(); q++) {
+        if (key.size() % q != 0) {
+            continue;
+        }
+        bool repeats = true;
+        for (size_t i = q; i < key.size() && repeats; i++) {
+            repeats = key[i] == key[i - q];
+        }
+        if (repeats) {
+            return q;
+        }
+    }
+    return key.size();
+}
+
+/**
+ * @brief Длина ключа, кратной которой является ключ кандидата
+ * @details На коротком тексте длины, кратные верной, получают столбцы из
+ *          немногих букв и случайно высокий индекс совпадений, а их ключ лишь
+ *          в части позиций повторяет верный. Поэтому ключ сводится к ключу
+ *          делителя q своей длины, если совпадает с ним больше чем в половине
+ *          позиций.
+ * @param key Ключ кандидата
+ * @param sampled Кандидаты для длин 1..key.size() (индекс - длина минус 1)
+ * @return Наименьший такой делитель или длина ключа
+ */
+size_t gronsfeldAnalyzer::divisorPeriod(const std::wstring& key, const std::vector<candidate>& sampled)
+{
+    for (size_t q = 1; q < key.size(); q++) {
+        if (key.size() % q != 0) {
+            continue;
+        }
+        const std::wstring& shorter = sampled[q - 1].key;
+        size_t agree = 0;
+        for (size_t i = 0; i < key.size(); i++) {
+            agree += key[i] == shorter[i % q];
+        }
+        if (2 * agree > key.size()) {
+            return q;
+        }
+    }
+    return key.size();
+}
+
+/**
+ * @brief Кандидаты для всех длин ключа по начальному отрезку текста
+ * @details Длины ключа раздаются потокам по одной через общий счётчик.
+ *          Длина ограничивается половиной текста, чтобы в каждом столбце
+ *          было не меньше двух букв.
+ * @param maxPeriod Наибольшая проверяемая длина ключа
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Кандидат для каждой длины 1..maxPeriod (индекс - длина минус 1)
+ * @throw cipher_error Если maxPeriod равен 0
+ */
+std::vector<gronsfeldAnalyzer::candidate> gronsfeldAnalyzer::sampleCandidates(size_t maxPeriod, unsigned threads) const
+{
+    if (maxPeriod == 0) {
+        throw cipher_error("Invalid maximum key length");
+    }
+    const size_t n = std::min(letters.size(), sampleLetters);
+    maxPeriod = std::min(maxPeriod, std::max<size_t>(1, n / 2));
+
+    std::vector<candidate> result(maxPeriod);
+    std::atomic<size_t> next{1};
+    parallelTasks::run(parallelTasks::threadCount(threads, maxPeriod), [&](unsigned) {
+        for (size_t p = next++; p <= maxPeriod; p = next++) {
+            std::vector<uint64_t> counts(p * alphaSize, 0);
+            columnHistogram(letters.data(), n, p, counts.data());
+            result[p - 1] = fit(counts, p);
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Индекс совпадений для каждой длины ключа
+ * @param maxPeriod Наибольшая проверяемая длина ключа
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Средний индекс совпадений столбцов для длин 1..maxPeriod (элемент 0 не используется)
+ * @throw cipher_error Если maxPeriod равен 0
+ */
+std::vector<double> gronsfeldAnalyzer::periodScores(size_t maxPeriod, unsigned threads) const
+{
+    std::vector<candidate> candidates = sampleCandidates(maxPeriod, threads);
+    std::vector<double> result(candidates.size() + 1, 0);
+    for (size_t p = 1; p <= candidates.size(); p++) {
+        result[p] = candidates[p - 1].score;
+    }
+    return result;
+}
+
+/**
+ * @brief Восстановление ключа
+ * @param maxPeriod Наибольшая проверяемая длина ключа
+ * @param count Количество кандидатов в ответе
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Кандидаты по убыванию оценки, не более count
+ * @throw cipher_error Если maxPeriod равен 0
+ */
+std::vector<gronsfeldAnalyzer::candidate> gronsfeldAnalyzer::recover(size_t maxPeriod, size_t count, unsigned threads) const
+{
+    const std::vector<candidate> sampled = sampleCandidates(maxPeriod, threads);
+    std::vector<candidate> ranked;
+    for (const candidate& c : sampled) {
+        const size_t q = divisorPeriod(c.key, sampled);
+        const candidate& reduced = q < c.key.size() ? sampled[q - 1] : c;
+        auto same = [&](const candidate& r) { return r.key == reduced.key; };
+        if (std::find_if(ranked.begin(), ranked.end(), same) == ranked.end()) {
+            ranked.push_back(reduced);
+        }
+    }
+    auto byScore = [](const candidate& a, const candidate& b) { return a.score > b.score; };
+    std::stable_sort(ranked.begin(), ranked.end(), byScore);
+    if (ranked.size() > count) {
+        ranked.resize(count);
+    }
+
+    // Начального отрезка хватает для выбора длины, сдвиги уточняются по всему тексту
+    if (letters.size() > sampleLetters) {
+        std::vector<candidate> refined;
+        for (const candidate& c : ranked) {
+            candidate r = fit(histogram(letters.size(), c.key.size(), threads), c.key.size());
+            const size_t q = minimalPeriod(r.key);
+            if (q < r.key.size()) {
+                r = fit(histogram(letters.size(), q, threads), q);
+            }
+            auto same = [&](const candidate& x) { return x.key == r.key; };
+            if (std::find_if(refined.begin(), refined.end(), same) == refined.end()) {
+                refined.push_back(r);
+            }
+        }
+        std::stable_sort(refined.begin(), refined.end(), byScore);
+        ranked = refined;
+    }
+    return ranked;
+}
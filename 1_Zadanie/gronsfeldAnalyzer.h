@@ -0,0 +1,157 @@
+/**
+ * @file gronsfeldAnalyzer.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для модуля восстановления ключа шифра Гронсфельда
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Восстановление ключа шифра Гронсфельда по шифртексту
+ * @details Длина ключа оценивается по индексу совпадений (метод Фридмана):
+ *          при верной длине каждый столбец шифртекста зашифрован одним
+ *          сдвигом и сохраняет индекс совпадений русского текста (около 0,055),
+ *          при неверной - приближается к 1/33. Сдвиг каждой позиции ключа
+ *          подбирается по минимуму хи-квадрат между частотами расшифрованного
+ *          столбца и частотами букв русского языка в порядке алфавита
+ *          модуля (Ё после Е).
+ *
+ *          Длины ключа проверяются параллельно на начальном отрезке текста
+ *          (sampleLetters букв), лучшие кандидаты уточняются по всему тексту
+ *          с разбиением на части по потокам. Гистограммы столбцов строятся
+ *          по строкам таблицы, так что соседние увеличения счётчиков попадают
+ *          в разные столбцы; для коротких ключей строка расширяется до кратной
+ *          длины не меньше 8, чтобы не было зависимостей через один счётчик.
+ */
+class gronsfeldAnalyzer
+{
+public:
+    /**
+     * @brief Кандидат ключа
+     */
+    struct candidate {
+        std::wstring key; ///< Ключ заглавными буквами
+        double score; ///< Средний индекс совпадений столбцов, чем больше, тем вероятнее
+        double chiSquare; ///< Средний по столбцам хи-квадрат расшифрованного текста
+    };
+
+    static constexpr size_t sampleLetters = size_t(1) << 22; ///< Длина отрезка для оценки длины ключа
+
+private:
+    static constexpr int alphaSize = 33; ///< Количество букв алфавита
+
+    std::vector<unsigned char> letters; ///< Номера букв шифртекста
+
+    /**
+     * @brief Гистограммы столбцов шифртекста
+     * @param data Номера букв
+     * @param n Количество номеров
+     * @param period Длина ключа
+     * @param counts Счётчики [столбец * 33 + номер буквы], увеличиваются
+     */
+    static void columnHistogram(const unsigned char* data, size_t n, size_t period, uint64_t* counts);
+
+    /**
+     * @brief Гистограммы столбцов с разбиением текста по потокам
+     * @param n Количество номеров с начала текста
+     * @param period Длина ключа
+     * @param threads Количество потоков
+     * @return Счётчики [столбец * 33 + номер буквы]
+     */
+    std::vector<uint64_t> histogram(size_t n, size_t period, unsigned threads) const;
+
+    /**
+     * @brief Подбор ключа и оценка по гистограммам столбцов
+     * @param counts Счётчики [столбец * 33 + номер буквы]
+     * @param period Длина ключа
+     * @return Кандидат с ключом длины period
+     */
+    static candidate fit(const std::vector<uint64_t>& counts, size_t period);
+
+    /**
+     * @brief Кандидаты для всех длин ключа по начальному отрезку текста
+     * @param maxPeriod Наибольшая проверяемая длина ключа
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Кандидат для каждой длины 1..maxPeriod (индекс - длина минус 1)
+     * @throw cipher_error Если maxPeriod равен 0
+     */
+    std::vector<candidate> sampleCandidates(size_t maxPeriod, unsigned threads) const;
+
+    /**
+     * @brief Наименьший период ключа
+     * @param key Ключ
+     * @return Длина наименьшего повторяющегося начала ключа
+     */
+    static size_t minimalPeriod(const std::wstring& key);
+
+    /**
+     * @brief Длина ключа, кратной которой является ключ кандидата
+     * @param key Ключ кандидата
+     * @param sampled Кандидаты для длин 1..key.size() (индекс - длина минус 1)
+     * @return Наименьший делитель длины, с ключом которого совпадает больше половины позиций, или длина ключа
+     */
+    static size_t divisorPeriod(const std::wstring& key, const std::vector<candidate>& sampled);
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    gronsfeldAnalyzer() = delete;
+
+    /**
+     * @brief Конструктор с разбором шифртекста
+     * @param cipher_text Шифртекст из заглавных русских букв
+     * @throw cipher_error Если шифртекст пустой или содержит другие символы
+     */
+    explicit gronsfeldAnalyzer(const std::wstring& cipher_text);
+
+    /**
+     * @brief Конструктор с разбором шифртекста в кодировке UTF-8
+     * @param cipher_text Шифртекст из заглавных русских букв в UTF-8
+     * @throw cipher_error Если шифртекст пустой или содержит другие символы
+     */
+    explicit gronsfeldAnalyzer(std::string_view cipher_text);
+
+    /**
+     * @brief Частоты букв русского языка
+     * @return 33 доли в порядке номеров букв, в сумме 1
+     */
+    static const double* frequencies();
+
+    /**
+     * @brief Количество букв шифртекста
+     * @return Длина шифртекста в буквах
+     */
+    size_t length() const { return letters.size(); }
+
+    /**
+     * @brief Индекс совпадений для каждой длины ключа
+     * @details Считается по первым sampleLetters буквам
+     * @param maxPeriod Наибольшая проверяемая длина ключа
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Средний индекс совпадений столбцов для длин 1..maxPeriod (элемент 0 не используется)
+     * @throw cipher_error Если maxPeriod равен 0
+     */
+    std::vector<double> periodScores(size_t maxPeriod, unsigned threads = 0) const;
+
+    /**
+     * @brief Восстановление ключа
+     * @details Для каждой длины 1..maxPeriod подбирается ключ; ключ, который
+     *          в основном повторяет ключ делителя своей длины, сводится к нему.
+     *          Первые count кандидатов по оценке уточняются по всему тексту.
+     * @param maxPeriod Наибольшая проверяемая длина ключа
+     * @param count Количество кандидатов в ответе
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Кандидаты по убыванию оценки, не более count
+     * @throw cipher_error Если maxPeriod равен 0
+     */
+    std::vector<candidate> recover(size_t maxPeriod, size_t count, unsigned threads = 0) const;
+};
@@ -0,0 +1,423 @@
+/**
+ * @file gronsfeldFixed.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Шифр Гронсфельда с ключом, заданным на этапе компиляции
+ */
+
+#pragma once
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "modAlphaCipher.h"
+#include "../common/russianText.h"
+
+/**
+ * @brief Проверка ключа на этапе компиляции
+ * @details Повторяет правила modAlphaCipher::getValidKey: ключ не пустой,
+ *          состоит из русских букв любого регистра, и буквы А и Ё (нулевой
+ *          сдвиг) составляют не больше половины ключа.
+ */
+struct gronsfeldFixedKey {
+    /**
+     * @brief Длина ключа
+     * @param key Ключ, завершённый нулевым символом
+     * @return Количество символов ключа
+     */
+    static constexpr size_t length(const wchar_t* key)
+    {
+        size_t n = 0;
+        while (key[n] != L'\0') {
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Проверка, что ключ состоит из русских букв
+     * @param key Ключ, завершённый нулевым символом
+     * @return true, если все символы - русские буквы
+     */
+    static constexpr bool letters(const wchar_t* key)
+    {
+        for (size_t i = 0; key[i] != L'\0'; i++) {
+            if (russianText::constLetterIndex(key[i]) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Проверка на слабый ключ
+     * @param key Ключ, завершённый нулевым символом
+     * @return true, если букв с нулевым сдвигом больше половины
+     */
+    static constexpr bool weak(const wchar_t* key)
+    {
+        size_t n = 0;
+        for (size_t i = 0; key[i] != L'\0'; i++) {
+            const int index = russianText::constLetterIndex(key[i]);
+            n += index == 0 || index == 6;
+        }
+        return 2 * n > length(key);
+    }
+};
+
+/**
+ * @brief Поток сдвигов ключа, развёрнутый на этапе компиляции
+ * @details Ключ повторён подряд на всю длину блока, поэтому сдвиг блока,
+ *          начинающегося с начала периода, - поэлементное сложение без
+ *          отслеживания позиции в ключе.
+ * @tparam Size Длина потока, кратная длине ключа
+ */
+template <size_t Size>
+struct gronsfeldFixedShifts {
+    unsigned char stream[Size]; ///< Сдвиг по позиции в блоке
+
+    /**
+     * @brief Построение потока сдвигов
+     * @param key Ключ, прошедший проверку gronsfeldFixedKey
+     * @param period Длина ключа
+     * @param decrypting true - обратные сдвиги
+     */
+    constexpr gronsfeldFixedShifts(const wchar_t* key, size_t period, bool decrypting) : stream()
+    {
+        constexpr int alphaSize = russianText::alphaSize;
+        for (size_t i = 0; i < Size; i++) {
+            const int k = russianText::constLetterIndex(key[i % period]);
+            stream[i] = static_cast<unsigned char>(decrypting ? (alphaSize - k) % alphaSize : k);
+        }
+    }
+};
+
+/**
+ * @brief Буквы алфавита по номеру в широкой строке и в UTF-8
+ */
+struct gronsfeldFixedLetters {
+    wchar_t letter[russianText::alphaSize]; ///< Буква по номеру
+    char utf8[russianText::alphaSize][2]; ///< Буква по номеру в UTF-8
+
+    /**
+     * @brief Построение таблиц на этапе компиляции
+     */
+    constexpr gronsfeldFixedLetters() : letter(), utf8()
+    {
+        const char16_t alpha[] = u"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        for (int x = 0; x < russianText::alphaSize; x++) {
+            letter[x] = alpha[x];
+            utf8[x][0] = static_cast<char>(0xC0 | (alpha[x] >> 6));
+            utf8[x][1] = static_cast<char>(0x80 | (alpha[x] & 0x3F));
+        }
+    }
+};
+
+/**
+ * @brief Шифр Гронсфельда с ключом, известным при сборке
+ * @details Ключ проверяется static_assert по правилам modAlphaCipher, поэтому
+ *          неверный ключ не компилируется, а сообщение совпадает с текстом
+ *          исключения cipher_error. Объект не хранит состояния: поток
+ *          сдвигов - константа класса, в которой период ключа развёрнут на
+ *          длину блока, поэтому ядро не вычисляет позицию в ключе и не берёт
+ *          остаток от длины ключа на каждую букву.
+ *          Результат совпадает с modAlphaCipher для того же ключа, ошибки
+ *          в тексте сообщаются тем же cipher_error с тем же сообщением.
+ *
+ *          Пример:
+ *          @code
+ *          constexpr wchar_t key[] = L"КЛЮЧ";
+ *          std::string c = gronsfeldFixed<key>::encrypt(std::string_view(text));
+ *          @endcode
+ * @tparam Key Ключ - массив со статическим временем жизни, завершённый нулевым символом
+ */
+template <const wchar_t* Key>
+class gronsfeldFixed
+{
+public:
+    static constexpr size_t period = gronsfeldFixedKey::length(Key); ///< Длина ключа
+
+    static_assert(period > 0, "Empty key");
+    static_assert(gronsfeldFixedKey::letters(Key), "Invalid key - contains non-Russian characters");
+    static_assert(!gronsfeldFixedKey::weak(Key), "Weak key - too many zero-shift characters");
+
+private:
+    static constexpr size_t blockSize = period * (period < 4096 ? 4096 / period : 1); ///< Блок номеров букв, кратный периоду
+    static constexpr gronsfeldFixedShifts<blockSize> encShifts{Key, period, false}; ///< Сдвиги зашифровывания
+    static constexpr gronsfeldFixedShifts<blockSize> decShifts{Key, period, true}; ///< Сдвиги расшифровывания
+    static constexpr gronsfeldFixedLetters letters{}; ///< Буквы по номеру
+
+    /**
+     * @brief Очередной символ текста
+     * @param p Текущая позиция, сдвигается за символ
+     * @param end Конец текста
+     * @return Кодовая точка
+     */
+    template <typename Char>
+    static char32_t nextChar(const Char*& p, const Char* end)
+    {
+        if constexpr (sizeof(Char) == 1) {
+            return russianText::decodeUtf8(p, end);
+        } else {
+            return static_cast<char32_t>(*p++);
+        }
+    }
+
+    /**
+     * @brief Сдвиг номера буквы по модулю размера алфавита
+     * @details Как и в gronsfeldKernel, min(s, s - 33) без знака даёт s - 33
+     *          при s >= 33 и s иначе; такой цикл компилятор векторизует.
+     * @param x Номер буквы
+     * @param shift Сдвиг
+     * @return Номер буквы результата
+     */
+    static constexpr unsigned char reduce(unsigned char x, unsigned char shift)
+    {
+        const unsigned char s = static_cast<unsigned char>(x + shift);
+        const unsigned char t = static_cast<unsigned char>(s - russianText::alphaSize);
+        return s < t ? s : t;
+    }
+
+    /**
+     * @brief Сдвиг блока номеров букв, начинающегося с начала периода, и запись результата
+     * @param block Номера букв, изменяются на месте
+     * @param n Количество номеров
+     * @param out Позиция записи
+     * @param shift Поток сдвигов ключа не короче n
+     * @return Позиция записи после блока
+     */
+    template <typename Char>
+    static Char* emit(unsigned char* block, size_t n, Char* out, const unsigned char* shift)
+    {
+        for (size_t i = 0; i < n; i++) {
+            block[i] = reduce(block[i], shift[i]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            if constexpr (sizeof(Char) == 1) {
+                std::memcpy(out, letters.utf8[block[i]], 2);
+                out += 2;
+            } else {
+                *out++ = letters.letter[block[i]];
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    template <typename Char>
+    static size_t encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity)
+    {
+        constexpr size_t units = sizeof(Char) == 1 ? 2 : 1;
+        const Char* end = open_text.data() + open_text.size();
+        // Буква результата занимает не больше места, чем буква текста
+        if (capacity < open_text.size()) {
+            size_t letters = 0;
+            bool hasNonSpace = false;
+            for (const Char* p = open_text.data(); p != end;) {
+                char32_t c = nextChar(p, end);
+                hasNonSpace |= c != U' ';
+                letters += russianText::letterIndex(c) >= 0;
+            }
+            if (!hasNonSpace) {
+                throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::emptyOpenText));
+            }
+            if (letters == 0) {
+                throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidOpenText));
+            }
+            if (capacity < units * letters) {
+                return units * letters;
+            }
+        }
+
+        Char* const start = out;
+        unsigned char block[blockSize];
+        size_t n = 0;
+        bool hasNonSpace = false;
+        for (const Char* p = open_text.data(); p != end;) {
+            char32_t c = nextChar(p, end);
+            if (c == U' ') {
+                continue;
+            }
+            hasNonSpace = true;
+            int i = russianText::letterIndex(c);
+            if (i < 0) {
+                continue;
+            }
+            block[n++] = static_cast<unsigned char>(i);
+            if (n == blockSize) {
+                out = emit(block, n, out, encShifts.stream);
+                n = 0;
+            }
+        }
+        if (n != 0) {
+            out = emit(block, n, out, encShifts.stream);
+        }
+
+        if (!hasNonSpace) {
+            throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::emptyOpenText));
+        }
+        if (out == start) {
+            throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidOpenText));
+        }
+        return out - start;
+    }
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    template <typename Char>
+    static size_t decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity)
+    {
+        constexpr size_t units = sizeof(Char) == 1 ? 2 : 1;
+        if (cipher_text.empty()) {
+            throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::emptyCipherText));
+        }
+        const Char* end = cipher_text.data() + cipher_text.size();
+        if (capacity < cipher_text.size()) {
+            size_t letters = 0;
+            for (const Char* p = cipher_text.data(); p != end; letters++) {
+                if (russianText::upperIndex(nextChar(p, end)) < 0) {
+                    throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidCipherText));
+                }
+            }
+            if (capacity < units * letters) {
+                return units * letters;
+            }
+        }
+
+        Char* const start = out;
+        unsigned char block[blockSize];
+        size_t n = 0;
+        for (const Char* p = cipher_text.data(); p != end;) {
+            int i = russianText::upperIndex(nextChar(p, end));
+            if (i < 0) {
+                throw cipher_error(modAlphaCipher::statusMessage(modAlphaCipher::textStatus::invalidCipherText));
+            }
+            block[n++] = static_cast<unsigned char>(i);
+            if (n == blockSize) {
+                out = emit(block, n, out, decShifts.stream);
+                n = 0;
+            }
+        }
+        out = emit(block, n, out, decShifts.stream);
+        return out - start;
+    }
+
+public:
+    /**
+     * @brief Зашифровывание открытого текста
+     * @param open_text Открытый текст
+     * @return Зашифрованная строка
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    static std::wstring encrypt(const std::wstring& open_text)
+    {
+        std::wstring result(open_text.size(), L'\0');
+        result.resize(encryptTo(std::wstring_view(open_text), &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывание зашифрованного текста
+     * @param cipher_text Зашифрованный текст
+     * @return Расшифрованная строка
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    static std::wstring decrypt(const std::wstring& cipher_text)
+    {
+        std::wstring result(cipher_text.size(), L'\0');
+        result.resize(decryptTo(std::wstring_view(cipher_text), &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Зашифровывание текста в кодировке UTF-8
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    static std::string encrypt(std::string_view open_text)
+    {
+        std::string result(open_text.size(), '\0');
+        result.resize(encryptTo(open_text, &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывание текста в кодировке UTF-8
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    static std::string decrypt(std::string_view cipher_text)
+    {
+        std::string result(cipher_text.size(), '\0');
+        result.resize(decryptTo(cipher_text, &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    static size_t encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity)
+    {
+        return encryptTo(open_text, out, capacity);
+    }
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    static size_t decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity)
+    {
+        return decryptTo(cipher_text, out, capacity);
+    }
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    static size_t encryptInto(std::string_view open_text, char* out, size_t capacity)
+    {
+        return encryptTo(open_text, out, capacity);
+    }
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    static size_t decryptInto(std::string_view cipher_text, char* out, size_t capacity)
+    {
+        return decryptTo(cipher_text, out, capacity);
+    }
+};
@@ -0,0 +1,205 @@
+/**
+ * @file gronsfeldKernel.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация векторного ядра сдвига шифра Гронсфельда
+ */
+
+#include "gronsfeldKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GRONSFELD_X86 1
+#endif
+
+namespace {
+
+/**
+ * @brief Скалярное ядро
+ * @param in Входные номера букв
+ * @param out Выходные номера букв
+ * @param n Количество номеров
+ * @param stream Развёрнутый поток ключа
+ * @param cycle Длина цикла потока ключа
+ * @param p Начальная позиция в потоке ключа
+ */
+void shiftScalar(const unsigned char* in, unsigned char* out, size_t n,
+                 const unsigned char* stream, size_t cycle, size_t p)
+{
+    for (size_t i = 0; i < n; i++) {
+        unsigned s = in[i] + stream[p];
+        out[i] = static_cast<unsigned char>(s >= gronsfeldKernel::alphaSize ? s - gronsfeldKernel::alphaSize : s);
+        if (++p == cycle) {
+            p = 0;
+        }
+    }
+}
+
+#ifdef GRONSFELD_X86
+
+// Сумма номера и сдвига не превышает 64, поэтому min(s, s - 33) без знака
+// даёт s - 33 при s >= 33 и s иначе (разность переполняется в большое число).
+
+/**
+ * @brief Ядро SSE4.2
+ */
+__attribute__((target("sse4.2")))
+void shiftSse42(const unsigned char* in, unsigned char* out, size_t n,
+                const unsigned char* stream, size_t cycle, size_t p)
+{
+    const __m128i mod = _mm_set1_epi8(gronsfeldKernel::alphaSize);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i s = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(stream + p)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_min_epu8(s, _mm_sub_epi8(s, mod)));
+        p += 16;
+        if (p >= cycle) {
+            p -= cycle;
+        }
+    }
+    shiftScalar(in + i, out + i, n - i, stream, cycle, p);
+}
+
+/**
+ * @brief Ядро AVX2
+ */
+__attribute__((target("avx2")))
+void shiftAvx2(const unsigned char* in, unsigned char* out, size_t n,
+               const unsigned char* stream, size_t cycle, size_t p)
+{
+    const __m256i mod = _mm256_set1_epi8(gronsfeldKernel::alphaSize);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i s = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stream + p)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu8(s, _mm256_sub_epi8(s, mod)));
+        p += 32;
+        if (p >= cycle) {
+            p -= cycle;
+        }
+    }
+    shiftSse42(in + i, out + i, n - i, stream, cycle, p);
+}
+
+/**
+ * @brief Ядро AVX-512BW
+ */
+__attribute__((target("avx512f,avx512bw")))
+void shiftAvx512(const unsigned char* in, unsigned char* out, size_t n,
+                 const unsigned char* stream, size_t cycle, size_t p)
+{
+    const __m512i mod = _mm512_set1_epi8(gronsfeldKernel::alphaSize);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i s = _mm512_add_epi8(_mm512_loadu_si512(in + i), _mm512_loadu_si512(stream + p));
+        _mm512_storeu_si512(out + i, _mm512_min_epu8(s, _mm512_sub_epi8(s, mod)));
+        p += 64;
+        if (p >= cycle) {
+            p -= cycle;
+        }
+    }
+    shiftAvx2(in + i, out + i, n - i, stream, cycle, p);
+}
+
+#endif
+
+}
+
+/**
+ * @brief Конструктор с развёртыванием ключа
+ * @param shifts Сдвиги ключа в диапазоне 0..32
+ */
+gronsfeldKernel::gronsfeldKernel(const std::vector<int>& shifts)
+    : keyLen(shifts.size()), selected(best())
+{
+    // Цикл кратен длине ключа, поэтому после перехода через его конец фаза
+    // сохраняется, а запас в maxWidth байт позволяет читать вектор с любой позиции цикла
+    cycle = (maxWidth + keyLen - 1) / keyLen * keyLen;
+    stream.resize(cycle + maxWidth);
+    for (size_t i = 0; i < stream.size(); i++) {
+        stream[i] = static_cast<unsigned char>(shifts[i % keyLen]);
+    }
+}
+
+/**
+ * @brief Проверка поддержки набора инструкций процессором
+ * @param i Набор инструкций
+ * @return true, если реализация может быть выполнена на текущем процессоре
+ */
+bool gronsfeldKernel::supported(isa i)
+{
+    switch (i) {
+        case isa::scalar:
+            return true;
+#ifdef GRONSFELD_X86
+        case isa::sse42:
+            return __builtin_cpu_supports("sse4.2");
+        case isa::avx2:
+            return __builtin_cpu_supports("avx2");
+        case isa::avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Лучшая реализация для текущего процессора
+ * @return Набор инструкций
+ */
+gronsfeldKernel::isa gronsfeldKernel::best()
+{
+    static const isa chosen = [] {
+        for (isa i : {isa::avx512, isa::avx2, isa::sse42}) {
+            if (supported(i)) {
+                return i;
+            }
+        }
+        return isa::scalar;
+    }();
+    return chosen;
+}
+
+/**
+ * @brief Сдвиг блока номеров букв лучшей реализацией
+ * @param in Входные номера букв (0..32)
+ * @param out Выходные номера букв, может совпадать с in
+ * @param n Количество номеров
+ * @param phase Позиция в ключе для первого номера
+ */
+void gronsfeldKernel::apply(const unsigned char* in, unsigned char* out, size_t n, size_t phase) const
+{
+    apply(selected, in, out, n, phase);
+}
+
+/**
+ * @brief Сдвиг блока номеров букв заданной реализацией
+ * @param i Набор инструкций, должен поддерживаться процессором
+ * @param in Входные номера букв (0..32)
+ * @param out Выходные номера букв, может совпадать с in
+ * @param n Количество номеров
+ * @param phase Позиция в ключе для первого номера
+ */
+void gronsfeldKernel::apply(isa i, const unsigned char* in, unsigned char* out, size_t n, size_t phase) const
+{
+    switch (i) {
+#ifdef GRONSFELD_X86
+        case isa::avx512:
+            shiftAvx512(in, out, n, stream.data(), cycle, phase);
+            return;
+        case isa::avx2:
+            shiftAvx2(in, out, n, stream.data(), cycle, phase);
+            return;
+        case isa::sse42:
+            shiftSse42(in, out, n, stream.data(), cycle, phase);
+            return;
+#endif
+        default:
+            shiftScalar(in, out, n, stream.data(), cycle, phase);
+            return;
+    }
+}
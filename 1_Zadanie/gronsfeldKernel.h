@@ -0,0 +1,94 @@
+/**
+ * @file gronsfeldKernel.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для векторного ядра сдвига шифра Гронсфельда
+ */
+
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Ядро сдвига номеров букв по ключу
+ * @details Работает с однобайтовыми номерами букв алфавита (0..32): к каждому
+ *          номеру прибавляется сдвиг из заранее развёрнутого потока ключа, а
+ *          приведение по модулю 33 выполняется сравнением с вычитанием.
+ *          Реализации SSE4.2, AVX2 и AVX-512 выбираются во время выполнения
+ *          по возможностям процессора, при их отсутствии используется скалярная.
+ */
+class gronsfeldKernel
+{
+public:
+    /**
+     * @brief Набор инструкций реализации ядра
+     */
+    enum class isa {
+        scalar, ///< Скалярная реализация
+        sse42,  ///< SSE4.2, 16 байт за шаг
+        avx2,   ///< AVX2, 32 байта за шаг
+        avx512  ///< AVX-512BW, 64 байта за шаг
+    };
+
+    static constexpr int alphaSize = 33; ///< Модуль сдвига (размер алфавита)
+    static constexpr size_t maxWidth = 64; ///< Наибольшая ширина вектора в байтах
+
+private:
+    std::vector<unsigned char> stream; ///< Ключ, повторённый cycle + maxWidth раз по байту
+    size_t keyLen; ///< Длина ключа
+    size_t cycle; ///< Длина цикла потока ключа, кратная длине ключа и не меньше maxWidth
+    isa selected; ///< Реализация, выбранная для процессора
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    gronsfeldKernel() = delete;
+
+    /**
+     * @brief Конструктор с развёртыванием ключа
+     * @param shifts Сдвиги ключа в диапазоне 0..32
+     */
+    explicit gronsfeldKernel(const std::vector<int>& shifts);
+
+    /**
+     * @brief Проверка поддержки набора инструкций процессором
+     * @param i Набор инструкций
+     * @return true, если реализация может быть выполнена на текущем процессоре
+     */
+    static bool supported(isa i);
+
+    /**
+     * @brief Лучшая реализация для текущего процессора
+     * @details Определяется по cpuid один раз на процесс
+     * @return Набор инструкций
+     */
+    static isa best();
+
+    /**
+     * @brief Сдвиг блока номеров букв лучшей реализацией
+     * @param in Входные номера букв (0..32)
+     * @param out Выходные номера букв, может совпадать с in
+     * @param n Количество номеров
+     * @param phase Позиция в ключе для первого номера (0..длина ключа - 1)
+     */
+    void apply(const unsigned char* in, unsigned char* out, size_t n, size_t phase) const;
+
+    /**
+     * @brief Сдвиг блока номеров букв заданной реализацией
+     * @param i Набор инструкций, должен поддерживаться процессором
+     * @param in Входные номера букв (0..32)
+     * @param out Выходные номера букв, может совпадать с in
+     * @param n Количество номеров
+     * @param phase Позиция в ключе для первого номера (0..длина ключа - 1)
+     */
+    void apply(isa i, const unsigned char* in, unsigned char* out, size_t n, size_t phase) const;
+
+    /**
+     * @brief Длина ключа
+     * @return Количество сдвигов в ключе
+     */
+    size_t period() const { return keyLen; }
+};
@@ -0,0 +1,69 @@
+/**
+ * @file gronsfeldPipeline.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация конвейерной обработки файлов шифром Гронсфельда
+ */
+
+#include "gronsfeldPipeline.h"
+
+/**
+ * @brief Конструктор с общим для преобразования блоков признаком
+ * @param cipher Шифр
+ * @param d true - расшифровывание, false - зашифровывание
+ * @param settings Параметры конвейера
+ * @param flag Признак символа, отличного от пробела
+ */
+gronsfeldPipeline::gronsfeldPipeline(const modAlphaCipher& cipher, bool d, const filePipeline::options& settings,
+                                     std::shared_ptr<std::atomic<bool>> flag)
+    : filePipeline(settings, [](std::string_view block) {
+          return static_cast<unsigned long long>(modAlphaCipher::letterCount(block));
+      }, [&cipher, d, flag](std::string_view block, unsigned long long phase, std::string& result) {
+          // Буква результата занимает не больше места, чем буква текста
+          result.resize(block.size());
+          modAlphaCipher::result r = d ? cipher.tryDecryptInto(block, &result[0], result.size(), phase)
+                                       : cipher.tryEncryptInto(block, &result[0], result.size(), phase);
+          if (d && !r) {
+              throw cipher_error(modAlphaCipher::statusMessage(r.status));
+          }
+          // Блок без букв не ошибка; текст без букв отличается от пустого
+          // наличием других символов, кроме пробелов
+          if (r.status != modAlphaCipher::textStatus::emptyOpenText) {
+              flag->store(true, std::memory_order_relaxed);
+          }
+          result.resize(r ? r.size : 0);
+      }),
+      decrypting(d), nonSpace(std::move(flag))
+{
+}
+
+/**
+ * @brief Конструктор конвейера шифра
+ * @param cipher Шифр
+ * @param d true - расшифровывание, false - зашифровывание
+ * @param settings Параметры конвейера
+ * @throw filePipeline_error Если размер блока меньше 16 байтов
+ */
+gronsfeldPipeline::gronsfeldPipeline(const modAlphaCipher& cipher, bool d, const filePipeline::options& settings)
+    : gronsfeldPipeline(cipher, d, settings, std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+/**
+ * @brief Результат проверки всего текста
+ * @param r Итоги run этого конвейера
+ * @return Результат проверки, как у tryEncrypt / tryDecrypt для всего файла
+ */
+modAlphaCipher::textStatus gronsfeldPipeline::status(const filePipeline::report& r) const
+{
+    if (r.blocks == 0) {
+        return decrypting ? modAlphaCipher::textStatus::emptyCipherText : modAlphaCipher::textStatus::emptyOpenText;
+    }
+    if (!decrypting && r.measured == 0) {
+        return nonSpace->load(std::memory_order_relaxed) ? modAlphaCipher::textStatus::invalidOpenText
+                                                          : modAlphaCipher::textStatus::emptyOpenText;
+    }
+    return modAlphaCipher::textStatus::ok;
+}
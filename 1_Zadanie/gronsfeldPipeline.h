@@ -0,0 +1,64 @@
+/**
+ * @file gronsfeldPipeline.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для конвейерной обработки файлов шифром Гронсфельда
+ */
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include "modAlphaCipher.h"
+#include "../common/filePipeline.h"
+
+/**
+ * @brief Конвейер filePipeline с шифром Гронсфельда
+ * @details Мера блока - количество его букв, так что каждый блок
+ *          преобразуется с фазой ключа, с которой до него дошёл бы шифр
+ *          всего текста, и результат совпадает с encrypt / decrypt файла
+ *          целиком. Блок без букв при зашифровывании не ошибка, потому что
+ *          буквы могут быть в других блоках; проверка всего текста
+ *          выполняется по итогам run методом status. Шифр не копируется и
+ *          должен существовать, пока существует конвейер.
+ */
+class gronsfeldPipeline : public filePipeline
+{
+private:
+    bool decrypting; ///< true - расшифровывание, false - зашифровывание
+    std::shared_ptr<std::atomic<bool>> nonSpace; ///< Встречен ли символ, отличный от пробела
+
+    /**
+     * @brief Конструктор с общим для преобразования блоков признаком
+     * @param cipher Шифр
+     * @param d true - расшифровывание, false - зашифровывание
+     * @param settings Параметры конвейера
+     * @param flag Признак символа, отличного от пробела
+     */
+    gronsfeldPipeline(const modAlphaCipher& cipher, bool d, const filePipeline::options& settings,
+                      std::shared_ptr<std::atomic<bool>> flag);
+
+public:
+    /**
+     * @brief Конструктор конвейера шифра
+     * @param cipher Шифр
+     * @param d true - расшифровывание, false - зашифровывание
+     * @param settings Параметры конвейера
+     * @throw filePipeline_error Если размер блока меньше 16 байтов
+     */
+    gronsfeldPipeline(const modAlphaCipher& cipher, bool d,
+                      const filePipeline::options& settings = filePipeline::options());
+
+    /**
+     * @brief Результат проверки всего текста
+     * @details Ошибки отдельных блоков при расшифровывании run сообщает
+     *          исключением сразу; здесь проверяются пустой вход и, при
+     *          зашифровывании, текст без русских букв. Признак символа,
+     *          отличного от пробела, накапливается за все прогоны run, поэтому
+     *          status верен только для конвейера с одним прогоном.
+     * @param r Итоги run этого конвейера
+     * @return Результат проверки, как у tryEncrypt / tryDecrypt для всего файла
+     */
+    modAlphaCipher::textStatus status(const filePipeline::report& r) const;
+};
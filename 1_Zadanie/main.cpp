@@ -4,13 +4,35 @@
  * @version 1.0
  * @date 03.12.2025
  * @copyright ИБСТ ПГУ
- * @brief Главный модуль для тестирования шифра Гронсфельда
+ * @brief Главный модуль программы шифрования шифром Гронсфельда
+ * @details Программа работает как фильтр: читает записи по одной на строку из
+ *          стандартного ввода и выводит по одной строке результата.
+ *          Ключом --analyze шифртекст без ключа читается целиком и выводятся
+ *          вероятные ключи. Демонстрационные тесты запускаются ключом --demo.
+ *          Ключ --stats выводит в stderr счётчики шифра в JSON (при сборке
+ *          с -DCIPHER_STATS, иначе нули). С ключами -i и -o файл шифруется
+ *          целиком как один текст конвейером filePipeline.
  */
 
 #include <iostream>
 #include <locale>
 #include <codecvt>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 #include "modAlphaCipher.h"
+#include "gronsfeldAnalyzer.h"
+#include "gronsfeldPipeline.h"
+#include "../common/filePipeline.h"
+#include "../common/russianText.h"
 
 using namespace std;
 
@@ -75,20 +97,396 @@ void testAlphaCipher() {
     wcout << L"=== Конец тестов для шифра Гронсфельда ===" << endl << endl;
 }
 
+/**
+ * @brief Действие при ошибке в записи
+ */
+enum class errorPolicy {
+    skip, ///< Запись пропускается
+    mark, ///< Вместо результата выводится строка с '#' и текстом ошибки
+    abort ///< Обработка прекращается с кодом 1
+};
+
+/**
+ * @brief Параметры фильтра
+ */
+struct filterOptions {
+    bool decrypting = false; ///< Расшифровывание вместо зашифровывания
+    unsigned threads = 1; ///< Количество потоков
+    errorPolicy policy = errorPolicy::abort; ///< Действие при ошибке в записи
+};
+
+/**
+ * @brief Результат обработки участка ввода одним потоком
+ */
+struct chunkResult {
+    std::string out; ///< Выходные строки участка
+    size_t records = 0; ///< Количество обработанных записей
+    bool aborted = false; ///< Обработка остановлена на ошибочной записи
+    std::string error; ///< Текст ошибки, остановившей обработку
+};
+
+/**
+ * @brief Размер блока чтения стандартного ввода
+ */
+const size_t readBlock = 8 << 20;
+
+/**
+ * @brief Декодирование UTF-8 в wstring без локали
+ * @param s Строка в UTF-8
+ * @return Строка в wstring
+ */
+wstring fromUtf8(const char* s)
+{
+    wstring result;
+    const char* end = s + std::strlen(s);
+    while (s != end) {
+        result.push_back(static_cast<wchar_t>(russianText::decodeUtf8(s, end)));
+    }
+    return result;
+}
+
+/**
+ * @brief Обработка записей участка ввода
+ * @details Каждая запись шифруется прямо в выходной буфер участка, без
+ *          промежуточных строк; буфер переиспользуется между блоками.
+ * @param cipher Шифратор
+ * @param options Параметры фильтра
+ * @param first Начало участка, начало записи
+ * @param last Конец участка, конец записи
+ * @param result Результат участка
+ */
+void processChunk(const modAlphaCipher& cipher, const filterOptions& options,
+                  const char* first, const char* last, chunkResult& result)
+{
+    result.out.clear();
+    result.records = 0;
+    result.aborted = false;
+    while (first < last) {
+        const char* eol = static_cast<const char*>(std::memchr(first, '\n', last - first));
+        const char* next = eol ? eol + 1 : last;
+        if (!eol) {
+            eol = last;
+        }
+        if (eol > first && eol[-1] == '\r') {
+            eol--;
+        }
+        std::string_view record(first, eol - first);
+        first = next;
+
+        // Каждая буква в выходе занимает два байта, во входе - не меньше двух
+        const size_t pos = result.out.size();
+        result.out.resize(pos + record.size() + 1);
+        try {
+            size_t n = options.decrypting ? cipher.decryptInto(record, &result.out[pos], record.size())
+                                          : cipher.encryptInto(record, &result.out[pos], record.size());
+            result.out.resize(pos + n);
+            result.out.push_back('\n');
+        } catch (const cipher_error& e) {
+            result.out.resize(pos);
+            if (options.policy == errorPolicy::abort) {
+                result.aborted = true;
+                result.error = e.what();
+                return;
+            }
+            if (options.policy == errorPolicy::mark) {
+                result.out.push_back('#');
+                result.out.append(e.what());
+                result.out.push_back('\n');
+            }
+        }
+        result.records++;
+    }
+}
+
+/**
+ * @brief Обработка блока целых записей
+ * @details Блок делится между потоками по границам строк; выходы участков
+ *          выводятся по порядку, поэтому порядок записей сохраняется.
+ * @param cipher Шифратор
+ * @param options Параметры фильтра
+ * @param first Начало блока
+ * @param last Конец блока
+ * @param results Результаты участков, по одному на поток
+ * @param records Номер первой записи блока, увеличивается на число записей
+ * @return true, если обработку нужно прекратить
+ */
+bool processBlock(const modAlphaCipher& cipher, const filterOptions& options,
+                  const char* first, const char* last, std::vector<chunkResult>& results, size_t& records)
+{
+    const unsigned threads = static_cast<unsigned>(results.size());
+    std::vector<const char*> bounds(threads + 1, last);
+    bounds[0] = first;
+    for (unsigned t = 1; t < threads; t++) {
+        // Граница сдвигается за ближайший перевод строки
+        const char* b = std::max(bounds[t - 1], first + (last - first) / threads * t);
+        const char* eol = static_cast<const char*>(std::memchr(b, '\n', last - b));
+        bounds[t] = eol ? eol + 1 : last;
+    }
+
+    auto task = [&](unsigned t) { processChunk(cipher, options, bounds[t], bounds[t + 1], results[t]); };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back(task, t);
+    }
+    task(0u);
+    for (std::thread& w : workers) {
+        w.join();
+    }
+
+    for (chunkResult& r : results) {
+        std::fwrite(r.out.data(), 1, r.out.size(), stdout);
+        records += r.records;
+        if (r.aborted) {
+            std::fflush(stdout);
+            std::fprintf(stderr, "Ошибка в записи %zu: %s\n", records + 1, r.error.c_str());
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Фильтр стандартного ввода
+ * @details Ввод читается блоками по readBlock байт, неполная последняя
+ *          строка блока переносится в следующий блок.
+ * @param cipher Шифратор
+ * @param options Параметры фильтра
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runFilter(const modAlphaCipher& cipher, const filterOptions& options)
+{
+    static char outBuffer[1 << 20];
+    std::setvbuf(stdout, outBuffer, _IOFBF, sizeof outBuffer);
+
+    std::vector<chunkResult> results(options.threads);
+    std::vector<char> buffer(readBlock);
+    size_t filled = 0;
+    size_t records = 0;
+    while (true) {
+        if (filled == buffer.size()) {
+            // Строка длиннее блока: блок увеличивается
+            buffer.resize(buffer.size() * 2);
+        }
+        size_t n = std::fread(buffer.data() + filled, 1, buffer.size() - filled, stdin);
+        filled += n;
+        if (n == 0) {
+            break;
+        }
+        const char* data = buffer.data();
+        const char* lastEol = static_cast<const char*>(memrchr(data, '\n', filled));
+        if (!lastEol) {
+            continue;
+        }
+        const size_t complete = lastEol + 1 - data;
+        if (processBlock(cipher, options, data, data + complete, results, records)) {
+            return 1;
+        }
+        std::memmove(buffer.data(), data + complete, filled - complete);
+        filled -= complete;
+    }
+    if (std::ferror(stdin)) {
+        std::fprintf(stderr, "Ошибка чтения стандартного ввода: %s\n", std::strerror(errno));
+        return 1;
+    }
+    if (filled > 0 && processBlock(cipher, options, buffer.data(), buffer.data() + filled, results, records)) {
+        return 1;
+    }
+    return std::fflush(stdout) == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Восстановление ключа по шифртексту со стандартного ввода
+ * @details Переводы строк в шифртексте пропускаются. Выводится по строке на
+ *          кандидата: ключ, индекс совпадений и хи-квадрат через табуляцию.
+ * @param threads Количество потоков
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runAnalyze(unsigned threads)
+{
+    std::string text;
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (buffer[i] != '\n' && buffer[i] != '\r') {
+                text += buffer[i];
+            }
+        }
+    }
+    if (std::ferror(stdin)) {
+        std::fprintf(stderr, "Ошибка чтения: %s\n", std::strerror(errno));
+        return 1;
+    }
+    try {
+        gronsfeldAnalyzer analyzer{std::string_view(text)};
+        for (const gronsfeldAnalyzer::candidate& c : analyzer.recover(64, 5, threads)) {
+            std::string key;
+            for (wchar_t letter : c.key) {
+                char utf8[2];
+                russianText::encodeLetter(letter, utf8);
+                key.append(utf8, 2);
+            }
+            std::printf("%s\t%.4f\t%.1f\n", key.c_str(), c.score, c.chiSquare);
+        }
+    } catch (const cipher_error& e) {
+        std::fprintf(stderr, "Ошибка: %s\n", e.what());
+        return 1;
+    }
+    return std::fflush(stdout) == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Шифрование файла конвейером
+ * @details Файл обрабатывается как один текст: результат совпадает с
+ *          encrypt или decrypt всего файла без завершающего перевода строки
+ *          (при зашифровывании переводы строк, как и прочие символы кроме
+ *          русских букв, отбрасываются). Блоки шифруются параллельно, фаза
+ *          ключа блока - количество букв перед ним. Проверки текста в целом
+ *          (пустой текст, нет русских букв) выполняются по итогам конвейера.
+ * @param cipher Шифратор
+ * @param options Параметры: направление и количество рабочих потоков
+ * @param inputPath Имя входного файла
+ * @param outputPath Имя выходного файла; при ошибке удаляется
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runFileMode(const modAlphaCipher& cipher, const filterOptions& options, const char* inputPath,
+                const char* outputPath)
+{
+    const int in = open(inputPath, O_RDONLY);
+    if (in < 0) {
+        std::fprintf(stderr, "Ошибка: не удалось открыть %s: %s\n", inputPath, std::strerror(errno));
+        return 1;
+    }
+    const int out = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        std::fprintf(stderr, "Ошибка: не удалось создать %s: %s\n", outputPath, std::strerror(errno));
+        close(in);
+        return 1;
+    }
+
+    filePipeline::options settings;
+    settings.workers = options.threads;
+    const gronsfeldPipeline pipeline(cipher, options.decrypting, settings);
+
+    int code = 0;
+    try {
+        const filePipeline::report report = pipeline.run(in, out);
+        const modAlphaCipher::textStatus whole = pipeline.status(report);
+        if (whole != modAlphaCipher::textStatus::ok) {
+            throw cipher_error(modAlphaCipher::statusMessage(whole));
+        }
+        std::fprintf(stderr, "Обработано %llu байт за %.3f с: %.1f МБ/с (чтение %.3f с, шифрование %.3f с, "
+                             "запись %.3f с)\n", report.bytesIn, report.seconds,
+                     report.seconds > 0 ? report.bytesIn / report.seconds / (1 << 20) : 0.0,
+                     report.readSeconds, report.transformSeconds, report.writeSeconds);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Ошибка: %s\n", e.what());
+        code = 1;
+    }
+    close(in);
+    if (close(out) != 0 && code == 0) {
+        std::fprintf(stderr, "Ошибка: не удалось записать %s: %s\n", outputPath, std::strerror(errno));
+        code = 1;
+    }
+    if (code != 0) {
+        unlink(outputPath);
+    }
+    return code;
+}
+
+/**
+ * @brief Вывод справки
+ * @param name Имя программы
+ */
+void usage(const char* name)
+{
+    std::fprintf(stderr,
+                 "Использование: %s [-d] [-j потоки] [--errors=skip|mark|abort] [--stats] [ключ]\n"
+                 "       %s [-d] [-j потоки] -i входной -o выходной [ключ]\n"
+                 "       %s --analyze [-j потоки]\n"
+                 "       %s --demo\n"
+                 "Ключ берётся из аргумента или переменной окружения GRONSFELD_KEY.\n"
+                 "Записи читаются по одной на строку из стандартного ввода;\n"
+                 "с -i и -o файл шифруется целиком как один текст.\n",
+                 name, name, name, name);
+}
+
 /**
  * @brief Главная функция программы
- * @return 0 при успешном выполнении
+ * @param argc Количество аргументов
+ * @param argv Аргументы командной строки
+ * @return 0 при успешном выполнении, 1 при ошибке
  */
-int main()
+int main(int argc, char** argv)
 {
-    // Настройка локали для работы с русскими символами
-    setlocale(LC_ALL, "ru_RU.UTF-8");
-    locale loc("ru_RU.UTF-8");
-    wcout.imbue(loc);
-    wcin.imbue(loc);
+    if (argc == 2 && std::strcmp(argv[1], "--demo") == 0) {
+        // Настройка локали для работы с русскими символами
+        setlocale(LC_ALL, "ru_RU.UTF-8");
+        locale loc("ru_RU.UTF-8");
+        wcout.imbue(loc);
+        wcin.imbue(loc);
 
-    // Запуск тестов
-    testAlphaCipher();
+        // Запуск тестов
+        testAlphaCipher();
+        return 0;
+    }
 
-    return 0;
+    filterOptions options;
+    bool analyzing = false;
+    bool stats = false;
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+    const char* key = std::getenv("GRONSFELD_KEY");
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--analyze") {
+            analyzing = true;
+        } else if (arg == "-d" || arg == "--decrypt") {
+            options.decrypting = true;
+        } else if (arg == "-e" || arg == "--encrypt") {
+            options.decrypting = false;
+        } else if (arg == "-j" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            if (options.threads == 0) {
+                options.threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+        } else if (arg == "--errors=skip") {
+            options.policy = errorPolicy::skip;
+        } else if (arg == "--errors=mark") {
+            options.policy = errorPolicy::mark;
+        } else if (arg == "--errors=abort") {
+            options.policy = errorPolicy::abort;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "-i" && i + 1 < argc) {
+            inputPath = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            key = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (analyzing) {
+        return runAnalyze(options.threads);
+    }
+    if (key == nullptr || (inputPath == nullptr) != (outputPath == nullptr)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        modAlphaCipher cipher(fromUtf8(key));
+        const int status = inputPath != nullptr ? runFileMode(cipher, options, inputPath, outputPath)
+                                                : runFilter(cipher, options);
+        if (stats) {
+            std::fprintf(stderr, "%s\n", modAlphaCipher::statsSnapshot().toJson("gronsfeld").c_str());
+        }
+        return status;
+    } catch (const cipher_error& e) {
+        std::fprintf(stderr, "Ошибка ключа: %s\n", e.what());
+        return 1;
+    }
 }
@@ -8,21 +8,95 @@
  */
 
 #include "modAlphaCipher.h"
+#include "../common/russianText.h"
+#include "../common/cipherStats.h"
+#include "../common/parallelTasks.h"
 #include <algorithm>
 
+namespace {
+
+using stats = cipherStats<modAlphaCipher>; ///< Счётчики модуля
+
+/**
+ * @brief Учёт вызова и его результата в счётчиках модуля
+ * @param status Результат проверки текста
+ * @param chars Количество единиц входного текста
+ * @return status
+ */
+inline modAlphaCipher::textStatus counted(modAlphaCipher::textStatus status, size_t chars)
+{
+    stats::call(chars);
+    if (status != modAlphaCipher::textStatus::ok) {
+        stats::failure(static_cast<unsigned>(status));
+    }
+    return status;
+}
+
+/**
+ * @brief Количество единиц строки на одну букву
+ * @details Буква занимает один wchar_t или два байта UTF-8
+ */
+template <typename Char>
+constexpr size_t unitsPerLetter = sizeof(Char) == 1 ? 2 : 1;
+
+/**
+ * @brief Очередной символ широкой строки
+ * @param p Текущая позиция, сдвигается на символ
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const wchar_t*& p, const wchar_t*)
+{
+    return static_cast<char32_t>(*p++);
+}
+
+/**
+ * @brief Очередной символ строки UTF-8
+ * @param p Текущая позиция, сдвигается за символ
+ * @param end Конец текста
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const char*& p, const char* end)
+{
+    return russianText::decodeUtf8(p, end);
+}
+
+}
+
+/**
+ * @brief Получение таблиц алфавита
+ * @details Таблицы строятся один раз на процесс при первом обращении
+ * @return Ссылка на таблицы
+ */
+const modAlphaCipher::tables& modAlphaCipher::getTables()
+{
+    static const tables t = [] {
+        const std::wstring& numAlpha = russianText::alphabet();
+        tables r;
+        for (int i = 0; i < alphaSize; i++) {
+            r.letter[i] = numAlpha[i];
+            russianText::encodeLetter(numAlpha[i], r.utf8[i]);
+        }
+        for (int k = 0; k < alphaSize; k++) {
+            for (int i = 0; i < alphaSize; i++) {
+                r.encShift[k][i] = numAlpha[(i + k) % alphaSize];
+                r.decShift[k][i] = numAlpha[(i + alphaSize - k) % alphaSize];
+            }
+        }
+        return r;
+    }();
+    return t;
+}
+
 /**
  * @brief Конструктор класса modAlphaCipher
  * @param skey Ключ шифрования в виде строки
  * @throw cipher_error Если ключ невалиден
  */
 modAlphaCipher::modAlphaCipher(const std::wstring& skey)
+    : key(convert(getValidKey(skey))), // Валидация и установка ключа
+      encKernel(key),
+      decKernel(inverse(key))
 {
-    // Инициализация алфавита и ассоциативного массива
-    for (size_t i = 0; i < numAlpha.size(); i++) {
-        alphaNum[numAlpha[i]] = i;
-    }
-    // Валидация и установка ключа
-    key = convert(getValidKey(skey));
 }
 
 /**
@@ -33,12 +107,7 @@ modAlphaCipher::modAlphaCipher(const std::wstring& skey)
  */
 std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
 {
-    std::wstring text = getValidOpenText(open_text);
-    std::vector<int> work = convert(text);
-    for (size_t i = 0; i < work.size(); i++) {
-        work[i] = (work[i] + key[i % key.size()]) % alphaNum.size();
-    }
-    return convert(work);
+    return transform(open_text, false, 1);
 }
 
 /**
@@ -49,12 +118,636 @@ std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
  */
 std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text)
 {
-    std::wstring text = getValidCipherText(cipher_text);
-    std::vector<int> work = convert(text);
-    for (size_t i = 0; i < work.size(); i++) {
-        work[i] = (work[i] + alphaNum.size() - key[i % key.size()]) % alphaNum.size();
+    return transform(cipher_text, true, 1);
+}
+
+/**
+ * @brief Многопоточный метод зашифровывания
+ * @param open_text Открытый текст для шифрования
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Зашифрованная строка
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ */
+std::wstring modAlphaCipher::encrypt(const std::wstring& open_text, unsigned threads)
+{
+    return transform(open_text, false, threads);
+}
+
+/**
+ * @brief Многопоточный метод расшифровывания
+ * @param cipher_text Зашифрованный текст для расшифрования
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Расшифрованная строка
+ * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ */
+std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text, unsigned threads)
+{
+    return transform(cipher_text, true, threads);
+}
+
+/**
+ * @brief Сдвиг блока номеров букв и запись результата
+ * @param block Номера букв, изменяются на месте
+ * @param n Количество номеров
+ * @param phase Позиция в ключе, продвигается на n
+ * @param kernel Ядро сдвига (encKernel или decKernel)
+ * @param out Позиция записи результата
+ * @param watch Секундомер этапов
+ * @return Позиция записи после блока
+ */
+template <typename Char>
+Char* modAlphaCipher::flush(unsigned char* block, size_t n, size_t& phase,
+                            const gronsfeldKernel& kernel, Char* out, stats::stopwatch& watch) const
+{
+    const tables& t = getTables();
+    kernel.apply(block, block, n, phase);
+    watch.lap(cipherStage::transform);
+    for (size_t i = 0; i < n; i++) {
+        if constexpr (sizeof(Char) == 1) {
+            *out++ = t.utf8[block[i]][0];
+            *out++ = t.utf8[block[i]][1];
+        } else {
+            *out++ = t.letter[block[i]];
+        }
+    }
+    phase = (phase + n) % key.size();
+    watch.lap(cipherStage::encode);
+    return out;
+}
+
+/**
+ * @brief Проверка открытого текста и подсчёт его букв
+ * @param s Открытый текст
+ * @param letters Количество русских букв
+ * @return Результат проверки
+ */
+template <typename Char>
+modAlphaCipher::textStatus modAlphaCipher::openTextLetters(std::basic_string_view<Char> s, size_t& letters)
+{
+    letters = 0;
+    bool hasNonSpace = false;
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        hasNonSpace = true;
+        letters += russianText::letterIndex(c) >= 0;
+    }
+    if (!hasNonSpace) {
+        return textStatus::emptyOpenText;
+    }
+    if (letters == 0) {
+        return textStatus::invalidOpenText;
+    }
+    return textStatus::ok;
+}
+
+/**
+ * @brief Проверка зашифрованного текста и подсчёт его букв
+ * @param s Зашифрованный текст
+ * @param letters Количество букв
+ * @return Результат проверки
+ */
+template <typename Char>
+modAlphaCipher::textStatus modAlphaCipher::cipherTextLetters(std::basic_string_view<Char> s, size_t& letters)
+{
+    letters = 0;
+    if (s.empty()) {
+        return textStatus::emptyCipherText;
+    }
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    while (p != end) {
+        if (russianText::upperIndex(nextChar(p, end)) < 0) {
+            return textStatus::invalidCipherText;
+        }
+        letters++;
+    }
+    return textStatus::ok;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param size Размер результата; если он больше capacity, буфер не заполняется
+ * @param phase Количество букв текста перед open_text
+ * @return Результат проверки текста
+ */
+template <typename Char>
+modAlphaCipher::textStatus modAlphaCipher::encryptStatus(std::basic_string_view<Char> open_text, Char* out,
+                                                         size_t capacity, size_t& size,
+                                                         unsigned long long phase) const
+{
+    size = 0;
+    stats::stopwatch watch;
+    // Буква результата занимает не больше места, чем буква текста
+    if (capacity < open_text.size()) {
+        size_t letters = 0;
+        textStatus status = openTextLetters(open_text, letters);
+        watch.lap(cipherStage::validate);
+        if (status != textStatus::ok) {
+            return status;
+        }
+        if (capacity < unitsPerLetter<Char> * letters) {
+            size = unitsPerLetter<Char> * letters;
+            return textStatus::ok;
+        }
+    }
+
+    Char* const start = out;
+    unsigned char block[blockSize];
+    size_t n = 0;
+    size_t position = phase % key.size();
+    bool hasNonSpace = false;
+
+    const Char* p = open_text.data();
+    const Char* end = p + open_text.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        hasNonSpace = true;
+        int i = russianText::letterIndex(c);
+        if (i < 0) {
+            continue;
+        }
+        block[n++] = static_cast<unsigned char>(i);
+        if (n == blockSize) {
+            watch.lap(cipherStage::normalize);
+            out = flush(block, n, position, encKernel, out, watch);
+            n = 0;
+        }
+    }
+    watch.lap(cipherStage::normalize);
+    out = flush(block, n, position, encKernel, out, watch);
+
+    if (!hasNonSpace) {
+        return textStatus::emptyOpenText;
+    }
+    if (out == start) {
+        return textStatus::invalidOpenText;
+    }
+    size = out - start;
+    return textStatus::ok;
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param size Размер результата; если он больше capacity, буфер не заполняется
+ * @param phase Количество букв текста перед cipher_text
+ * @return Результат проверки текста
+ */
+template <typename Char>
+modAlphaCipher::textStatus modAlphaCipher::decryptStatus(std::basic_string_view<Char> cipher_text, Char* out,
+                                                         size_t capacity, size_t& size,
+                                                         unsigned long long phase) const
+{
+    size = 0;
+    if (cipher_text.empty()) {
+        return textStatus::emptyCipherText;
+    }
+    stats::stopwatch watch;
+    if (capacity < cipher_text.size()) {
+        size_t letters = 0;
+        textStatus status = cipherTextLetters(cipher_text, letters);
+        watch.lap(cipherStage::validate);
+        if (status != textStatus::ok) {
+            return status;
+        }
+        if (capacity < unitsPerLetter<Char> * letters) {
+            size = unitsPerLetter<Char> * letters;
+            return textStatus::ok;
+        }
+    }
+
+    Char* const start = out;
+    unsigned char block[blockSize];
+    size_t n = 0;
+    size_t position = phase % key.size();
+
+    const Char* p = cipher_text.data();
+    const Char* end = p + cipher_text.size();
+    while (p != end) {
+        int i = russianText::upperIndex(nextChar(p, end));
+        if (i < 0) {
+            watch.lap(cipherStage::normalize);
+            return textStatus::invalidCipherText;
+        }
+        block[n++] = static_cast<unsigned char>(i);
+        if (n == blockSize) {
+            watch.lap(cipherStage::normalize);
+            out = flush(block, n, position, decKernel, out, watch);
+            n = 0;
+        }
+    }
+    watch.lap(cipherStage::normalize);
+    out = flush(block, n, position, decKernel, out, watch);
+    size = out - start;
+    return textStatus::ok;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ */
+template <typename Char>
+size_t modAlphaCipher::encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    if (status != textStatus::ok) {
+        throw cipher_error(statusMessage(status));
+    }
+    return size;
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ */
+template <typename Char>
+size_t modAlphaCipher::decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    if (status != textStatus::ok) {
+        throw cipher_error(statusMessage(status));
+    }
+    return size;
+}
+
+/**
+ * @brief Текст ошибки по результату проверки
+ * @param status Результат проверки
+ * @return Сообщение, с которым выбрасывается cipher_error; для ok - пустая строка
+ */
+const char* modAlphaCipher::statusMessage(textStatus status)
+{
+    switch (status) {
+        case textStatus::emptyOpenText:
+            return "Empty open text";
+        case textStatus::invalidOpenText:
+            return "Invalid open text - no Russian letters";
+        case textStatus::emptyCipherText:
+            return "Empty cipher text";
+        case textStatus::invalidCipherText:
+            return "Invalid cipher text - contains non-Russian characters";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief Пакетная обработка сообщений
+ * @param text Буфер всех сообщений в UTF-8
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов в arena, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @return Количество успешно обработанных сообщений
+ */
+size_t modAlphaCipher::transformBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                      std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status,
+                                      bool decrypting) const
+{
+    // Результат сообщения не длиннее самого сообщения, поэтому буфер
+    // размером со все сообщения выделяется один раз на пакет
+    const size_t total = count > 0 ? offsets[count] - offsets[0] : 0;
+    if (total > arena.capacity()) {
+        stats::allocated(total);
+    }
+    arena.resize(total);
+    arenaOffsets.resize(count + 1);
+    status.resize(count);
+
+    size_t pos = 0;
+    size_t done = 0;
+    arenaOffsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        std::string_view message(text + offsets[i], offsets[i + 1] - offsets[i]);
+        size_t n = 0;
+        status[i] = counted(decrypting ? decryptStatus(message, &arena[pos], message.size(), n)
+                                       : encryptStatus(message, &arena[pos], message.size(), n),
+                            message.size());
+        if (status[i] == textStatus::ok) {
+            pos += n;
+            done++;
+        }
+        arenaOffsets[i + 1] = pos;
+    }
+    arena.resize(pos);
+    return done;
+}
+
+/**
+ * @brief Пакетное зашифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно зашифрованных сообщений
+ */
+size_t modAlphaCipher::encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                    std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const
+{
+    return transformBatch(text, offsets, count, arena, arenaOffsets, status, false);
+}
+
+/**
+ * @brief Пакетное расшифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно расшифрованных сообщений
+ */
+size_t modAlphaCipher::decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                    std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const
+{
+    return transformBatch(text, offsets, count, arena, arenaOffsets, status, true);
+}
+
+/**
+ * @brief Метод зашифровывания текста в кодировке UTF-8
+ * @param open_text Открытый текст в UTF-8
+ * @return Зашифрованная строка в UTF-8
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ */
+std::string modAlphaCipher::encrypt(std::string_view open_text) const
+{
+    std::string result(open_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(encryptTo(open_text, &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Метод расшифровывания текста в кодировке UTF-8
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @return Расшифрованная строка в UTF-8
+ * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ */
+std::string modAlphaCipher::decrypt(std::string_view cipher_text) const
+{
+    std::string result(cipher_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(decryptTo(cipher_text, &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата в символах
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ */
+size_t modAlphaCipher::encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const
+{
+    return encryptTo(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата в символах
+ * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ */
+size_t modAlphaCipher::decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const
+{
+    return decryptTo(cipher_text, out, capacity);
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+ * @param open_text Открытый текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата в байтах
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ */
+size_t modAlphaCipher::encryptInto(std::string_view open_text, char* out, size_t capacity) const
+{
+    return encryptTo(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата в байтах
+ * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ */
+size_t modAlphaCipher::decryptInto(std::string_view cipher_text, char* out, size_t capacity) const
+{
+    return decryptTo(cipher_text, out, capacity);
+}
+
+/**
+ * @brief Преобразование в строку вызывающего без исключений
+ * @param s Исходный текст
+ * @param out Строка результата
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @return Результат проверки текста
+ */
+template <typename Char>
+modAlphaCipher::textStatus modAlphaCipher::tryTransform(std::basic_string_view<Char> s, std::basic_string<Char>& out,
+                                                        bool decrypting) const
+{
+    // Первый вызов с имеющимся буфером: при ошибке или нехватке места он
+    // только проверяет текст и считает размер результата
+    size_t size = 0;
+    textStatus status = decrypting ? decryptStatus(s, &out[0], out.size(), size)
+                                   : encryptStatus(s, &out[0], out.size(), size);
+    if (status == textStatus::ok && size > out.size()) {
+        if (size > out.capacity()) {
+            stats::allocated(size * sizeof(Char));
+        }
+        out.resize(size);
+        status = decrypting ? decryptStatus(s, &out[0], out.size(), size)
+                            : encryptStatus(s, &out[0], out.size(), size);
     }
-    return convert(work);
+    out.resize(status == textStatus::ok ? size : 0);
+    return counted(status, s.size());
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Результат проверки и размер результата в символах
+ */
+modAlphaCipher::result modAlphaCipher::tryEncryptInto(std::wstring_view open_text, wchar_t* out,
+                                                      size_t capacity) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Результат проверки и размер результата в символах
+ */
+modAlphaCipher::result modAlphaCipher::tryDecryptInto(std::wstring_view cipher_text, wchar_t* out,
+                                                      size_t capacity) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в буфер вызывающего без исключений
+ * @param open_text Открытый текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Результат проверки и размер результата в байтах
+ */
+modAlphaCipher::result modAlphaCipher::tryEncryptInto(std::string_view open_text, char* out,
+                                                      size_t capacity) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Результат проверки и размер результата в байтах
+ */
+modAlphaCipher::result modAlphaCipher::tryDecryptInto(std::string_view cipher_text, char* out,
+                                                      size_t capacity) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Зашифровывание фрагмента текста в UTF-8 без исключений
+ * @param open_text Фрагмент открытого текста в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @param phase Количество букв текста перед фрагментом
+ * @return Результат проверки и размер результата в байтах
+ */
+modAlphaCipher::result modAlphaCipher::tryEncryptInto(std::string_view open_text, char* out, size_t capacity,
+                                                      unsigned long long phase) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size, phase), open_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Расшифровывание фрагмента текста в UTF-8 без исключений
+ * @param cipher_text Фрагмент шифртекста в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @param phase Количество букв шифртекста перед фрагментом
+ * @return Результат проверки и размер результата в байтах
+ */
+modAlphaCipher::result modAlphaCipher::tryDecryptInto(std::string_view cipher_text, char* out, size_t capacity,
+                                                      unsigned long long phase) const noexcept
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size, phase), cipher_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Количество русских букв в тексте UTF-8
+ * @param text Текст в UTF-8
+ * @return Количество букв
+ */
+size_t modAlphaCipher::letterCount(std::string_view text) noexcept
+{
+    size_t letters = 0;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p != end) {
+        letters += russianText::letterIndex(nextChar(p, end)) >= 0;
+    }
+    return letters;
+}
+
+/**
+ * @brief Зашифровывание в строку вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Зашифрованный текст, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+modAlphaCipher::textStatus modAlphaCipher::tryEncrypt(std::wstring_view open_text, std::wstring& out) const
+{
+    return tryTransform(open_text, out, false);
+}
+
+/**
+ * @brief Расшифровывание в строку вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Расшифрованный текст, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+modAlphaCipher::textStatus modAlphaCipher::tryDecrypt(std::wstring_view cipher_text, std::wstring& out) const
+{
+    return tryTransform(cipher_text, out, true);
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в строку вызывающего без исключений
+ * @param open_text Открытый текст в UTF-8
+ * @param out Зашифрованный текст в UTF-8, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+modAlphaCipher::textStatus modAlphaCipher::tryEncrypt(std::string_view open_text, std::string& out) const
+{
+    return tryTransform(open_text, out, false);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в строку вызывающего без исключений
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Расшифрованный текст в UTF-8, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+modAlphaCipher::textStatus modAlphaCipher::tryDecrypt(std::string_view cipher_text, std::string& out) const
+{
+    return tryTransform(cipher_text, out, true);
 }
 
 /**
@@ -66,45 +759,129 @@ std::vector<int> modAlphaCipher::convert(const std::wstring& s)
 {
     std::vector<int> result;
     for (wchar_t c : s) {
-        if (alphaNum.find(c) != alphaNum.end()) {
-            result.push_back(alphaNum[c]);
+        int i = russianText::upperIndex(c);
+        if (i >= 0) {
+            result.push_back(i);
         }
     }
     return result;
 }
 
 /**
- * @brief Преобразование числового вектора в строку
- * @param v Входной вектор чисел
- * @return Строка, составленная из символов алфавита
+ * @brief Обратные сдвиги ключа
+ * @param k Сдвиги ключа
+ * @return Сдвиги, отменяющие k по модулю размера алфавита
  */
-std::wstring modAlphaCipher::convert(const std::vector<int>& v)
+std::vector<int> modAlphaCipher::inverse(const std::vector<int>& k)
 {
-    std::wstring result;
-    for (int i : v) {
-        if (i >= 0 && i < static_cast<int>(numAlpha.size())) {
-            result.push_back(numAlpha[i]);
-        }
+    std::vector<int> result;
+    for (int e : k) {
+        result.push_back((alphaSize - e) % alphaSize);
     }
     return result;
 }
 
 /**
- * @brief Приведение строки к верхнему регистру с удалением пробелов
+ * @brief Сдвиг букв участка текста по ключу
+ * @param first Начало участка
+ * @param last Конец участка
+ * @param out Буфер результата, вмещающий last - first символов
+ * @param phase Позиция в ключе для первой буквы участка
+ * @param kernel Ядро сдвига (encKernel или decKernel)
+ * @return Количество записанных символов
+ */
+size_t modAlphaCipher::transformRange(const wchar_t* first, const wchar_t* last, wchar_t* out,
+                                      size_t phase, const gronsfeldKernel& kernel) const
+{
+    const tables& t = getTables();
+    wchar_t* const start = out;
+
+    unsigned char block[blockSize];
+    size_t n = 0;
+    auto flush = [&] {
+        kernel.apply(block, block, n, phase);
+        for (size_t i = 0; i < n; i++) {
+            *out++ = t.letter[block[i]];
+        }
+        phase = (phase + n) % key.size();
+        n = 0;
+    };
+
+    for (; first != last; ++first) {
+        int i = russianText::letterIndex(*first);
+        if (i < 0) {
+            continue;
+        }
+        block[n++] = static_cast<unsigned char>(i);
+        if (n == blockSize) {
+            flush();
+        }
+    }
+    flush();
+    return out - start;
+}
+
+/**
+ * @brief Проверка и сдвиг букв строки по ключу
  * @param s Входная строка
- * @return Строка в верхнем регистре без пробелов
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Строка результата
+ * @throw cipher_error Если текст не проходит проверку
  */
-std::wstring modAlphaCipher::toUpper(const std::wstring& s)
+std::wstring modAlphaCipher::transform(std::wstring_view s, bool decrypting, unsigned threads) const
 {
-    std::wstring result;
-    std::locale loc("ru_RU.UTF-8");
+    threads = parallelTasks::threadCount(threads, s.size() / parallelThreshold);
 
-    for (wchar_t c : s) {
-        if (c != L' ') {
-            wchar_t upper_c = std::toupper(c, loc);
-            result.push_back(upper_c);
+    // Буква результата занимает не больше места, чем символ текста
+    std::wstring result(s.size(), L'\0');
+    stats::allocated(result.size() * sizeof(wchar_t));
+    if (threads <= 1) {
+        result.resize(decrypting ? decryptTo(s, &result[0], result.size()) : encryptTo(s, &result[0], result.size()));
+        return result;
+    }
+
+    // Проверка участков и количество букв в каждом из них
+    const size_t chunk = (s.size() + threads - 1) / threads;
+    std::vector<size_t> offsets(threads + 1, 0);
+    std::vector<textStatus> parts(threads);
+    stats::stopwatch watch;
+    parallelTasks::run(threads, [&](unsigned t) {
+        const size_t first = std::min(s.size(), t * chunk);
+        const size_t last = std::min(s.size(), first + chunk);
+        const std::wstring_view part = s.substr(first, last - first);
+        parts[t] = decrypting ? cipherTextLetters(part, offsets[t + 1]) : openTextLetters(part, offsets[t + 1]);
+    });
+    watch.lap(cipherStage::validate);
+    for (unsigned t = 0; t < threads; t++) {
+        offsets[t + 1] += offsets[t];
+    }
+
+    // Ошибка всего текста складывается из ошибок участков так же, как при одном проходе
+    textStatus status = textStatus::ok;
+    if (decrypting) {
+        if (std::find(parts.begin(), parts.end(), textStatus::invalidCipherText) != parts.end()) {
+            status = textStatus::invalidCipherText;
         }
+    } else if (std::all_of(parts.begin(), parts.end(), [](textStatus p) { return p == textStatus::emptyOpenText; })) {
+        status = textStatus::emptyOpenText;
+    } else if (offsets[threads] == 0) {
+        status = textStatus::invalidOpenText;
     }
+    if (counted(status, s.size()) != textStatus::ok) {
+        throw cipher_error(statusMessage(status));
+    }
+
+    // Фаза ключа участка определяется количеством букв перед ним
+    const gronsfeldKernel& kernel = decrypting ? decKernel : encKernel;
+    wchar_t* out = &result[0];
+    parallelTasks::run(threads, [&](unsigned t) {
+        const size_t first = std::min(s.size(), t * chunk);
+        const size_t last = std::min(s.size(), first + chunk);
+        transformRange(s.data() + first, s.data() + last, out + offsets[t], offsets[t] % key.size(), kernel);
+    });
+    watch.lap(cipherStage::transform);
+    result.resize(offsets[threads]);
     return result;
 }
 
@@ -121,12 +898,10 @@ std::wstring modAlphaCipher::getValidKey(const std::wstring& s)
     }
 
     std::wstring tmp;
-    std::locale loc("ru_RU.UTF-8");
 
     // Приведение к верхнему регистру
     for (wchar_t c : s) {
-        wchar_t upper_c = std::toupper(c, loc);
-        tmp.push_back(upper_c);
+        tmp.push_back(static_cast<wchar_t>(russianText::toUpper(c)));
     }
 
     if (tmp.empty()) {
@@ -135,7 +910,7 @@ std::wstring modAlphaCipher::getValidKey(const std::wstring& s)
 
     // Проверка на русские буквы
     for (wchar_t c : tmp) {
-        if (!((c >= L'А' && c <= L'Я') || c == L'Ё')) {
+        if (!russianText::isUpperLetter(c)) {
             throw cipher_error("Invalid key - contains non-Russian characters");
         }
     }
@@ -156,51 +931,18 @@ std::wstring modAlphaCipher::getValidKey(const std::wstring& s)
 }
 
 /**
- * @brief Валидация открытого текста
- * @param s Открытый текст
- * @return Валидированный текст в верхнем регистре
- * @throw cipher_error Если текст пустой или не содержит русских букв
+ * @brief Снимок счётчиков модуля
+ * @return Сумма счётчиков всех потоков
  */
-std::wstring modAlphaCipher::getValidOpenText(const std::wstring& s)
+cipherCounters modAlphaCipher::statsSnapshot()
 {
-    std::wstring tmp = toUpper(s);
-    if (tmp.empty()) {
-        throw cipher_error("Empty open text");
-    }
-
-    // Проверка наличия русских букв
-    bool hasValidChars = false;
-    for (wchar_t c : tmp) {
-        if ((c >= L'А' && c <= L'Я') || c == L'Ё') {
-            hasValidChars = true;
-            break;
-        }
-    }
-
-    if (!hasValidChars) {
-        throw cipher_error("Invalid open text - no Russian letters");
-    }
-
-    return tmp;
+    return stats::snapshot();
 }
 
 /**
- * @brief Валидация зашифрованного текста
- * @param s Зашифрованный текст
- * @return Валидированный зашифрованный текст
- * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ * @brief Обнуление счётчиков модуля
  */
-std::wstring modAlphaCipher::getValidCipherText(const std::wstring& s)
+void modAlphaCipher::resetStats()
 {
-    if (s.empty()) {
-        throw cipher_error("Empty cipher text");
-    }
-
-    // Проверка на русские буквы
-    for (wchar_t c : s) {
-        if (!((c >= L'А' && c <= L'Я') || c == L'Ё')) {
-            throw cipher_error("Invalid cipher text - contains non-Russian characters");
-        }
-    }
-    return s;
+    stats::reset();
 }
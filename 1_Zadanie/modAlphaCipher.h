@@ -10,10 +10,10 @@
 #pragma once
 #include <vector>
 #include <string>
-#include <map>
-#include <locale>
-#include <codecvt>
+#include <string_view>
 #include <stdexcept>
+#include "gronsfeldKernel.h"
+#include "../common/cipherStats.h"
 
 /**
  * @brief Класс-исключение для ошибок шифрования
@@ -43,10 +43,184 @@ public:
  */
 class modAlphaCipher
 {
+    friend class modAlphaStream;
+    friend class productCipher;
+
+public:
+    /**
+     * @brief Результат проверки текста без исключений
+     */
+    enum class textStatus : unsigned char {
+        ok, ///< Текст обработан
+        emptyOpenText, ///< Открытый текст пустой или состоит из пробелов
+        invalidOpenText, ///< В открытом тексте нет русских букв
+        emptyCipherText, ///< Шифртекст пустой
+        invalidCipherText ///< В шифртексте есть символы, кроме заглавных русских букв
+    };
+
+    /**
+     * @brief Результат операции без исключений
+     */
+    struct result {
+        textStatus status; ///< Результат проверки текста
+        size_t size; ///< Размер результата, при ошибке - 0
+
+        /**
+         * @brief Признак успешной операции
+         * @return true, если status равен ok
+         */
+        explicit operator bool() const { return status == textStatus::ok; }
+    };
+
 private:
-    std::wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"; ///< Алфавит по порядку
-    std::map<wchar_t, int> alphaNum; ///< Ассоциативный массив "символ-номер"
+    static constexpr int alphaSize = 33; ///< Количество букв алфавита
+
+    /**
+     * @brief Таблицы прямого доступа для алфавита
+     * @details Номер буквы берётся из общего модуля russianText по смещению
+     *          кодовой точки, а результат сдвига - из таблицы Гронсфельда 33x33,
+     *          где сразу хранится символ результата.
+     */
+    struct tables {
+        wchar_t letter[alphaSize]; ///< Буква по номеру
+        char utf8[alphaSize][2]; ///< Буква по номеру в кодировке UTF-8
+        wchar_t encShift[alphaSize][alphaSize]; ///< Символ шифртекста по [сдвиг ключа][номер буквы]
+        wchar_t decShift[alphaSize][alphaSize]; ///< Символ открытого текста по [сдвиг ключа][номер буквы]
+    };
+
+    static constexpr size_t blockSize = 4096; ///< Размер блока номеров букв для векторного ядра
+    static constexpr size_t parallelThreshold = 1 << 16; ///< Наименьшая длина текста на поток для параллельного режима
+
     std::vector<int> key; ///< Ключ в числовом представлении
+    gronsfeldKernel encKernel; ///< Ядро сдвига для зашифровывания
+    gronsfeldKernel decKernel; ///< Ядро сдвига для расшифровывания (обратные сдвиги)
+
+    /**
+     * @brief Получение таблиц алфавита
+     * @details Таблицы строятся один раз на процесс при первом обращении
+     * @return Ссылка на таблицы
+     */
+    static const tables& getTables();
+
+    /**
+     * @brief Сдвиг блока номеров букв и запись результата
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param block Номера букв, изменяются на месте
+     * @param n Количество номеров
+     * @param phase Позиция в ключе, продвигается на n
+     * @param kernel Ядро сдвига (encKernel или decKernel)
+     * @param out Позиция записи результата
+     * @param watch Секундомер этапов: сдвиг учитывается как transform, запись - как encode
+     * @return Позиция записи после блока
+     */
+    template <typename Char>
+    Char* flush(unsigned char* block, size_t n, size_t& phase, const gronsfeldKernel& kernel, Char* out,
+                cipherStats<modAlphaCipher>::stopwatch& watch) const;
+
+    /**
+     * @brief Проверка открытого текста и подсчёт его букв
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Открытый текст
+     * @param letters Количество русских букв
+     * @return Результат проверки
+     */
+    template <typename Char>
+    static textStatus openTextLetters(std::basic_string_view<Char> s, size_t& letters);
+
+    /**
+     * @brief Проверка зашифрованного текста и подсчёт его букв
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Зашифрованный текст
+     * @param letters Количество букв
+     * @return Результат проверки
+     */
+    template <typename Char>
+    static textStatus cipherTextLetters(std::basic_string_view<Char> s, size_t& letters);
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего без исключений
+     * @details Проверка, приведение регистра, удаление пробелов, сдвиг и запись
+     *          результата выполняются за один проход без выделения памяти.
+     *          Если буфер меньше текста, буквы сначала подсчитываются.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param size Размер результата; если он больше capacity, буфер не заполняется
+     * @param phase Количество букв текста перед open_text (для фрагмента текста)
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus encryptStatus(std::basic_string_view<Char> open_text, Char* out, size_t capacity, size_t& size,
+                             unsigned long long phase = 0) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего без исключений
+     * @details Аналогично encryptStatus.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param size Размер результата; если он больше capacity, буфер не заполняется
+     * @param phase Количество букв текста перед cipher_text (для фрагмента текста)
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus decryptStatus(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity, size_t& size,
+                             unsigned long long phase = 0) const;
+
+    /**
+     * @brief Преобразование в строку вызывающего без исключений
+     * @details Строка увеличивается только после успешной проверки текста,
+     *          при ошибке очищается без освобождения памяти.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Исходный текст
+     * @param out Строка результата
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus tryTransform(std::basic_string_view<Char> s, std::basic_string<Char>& out, bool decrypting) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @details Обёртка над encryptStatus, сообщающая об ошибке исключением.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    template <typename Char>
+    size_t encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @details Обёртка над decryptStatus, сообщающая об ошибке исключением.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    template <typename Char>
+    size_t decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity) const;
+
+    /**
+     * @brief Пакетная обработка сообщений
+     * @param text Буфер всех сообщений в UTF-8
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов в arena, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @return Количество успешно обработанных сообщений
+     */
+    size_t transformBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                          std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status, bool decrypting) const;
 
     /**
      * @brief Преобразование строки в числовой вектор
@@ -56,18 +230,44 @@ private:
     std::vector<int> convert(const std::wstring& s);
 
     /**
-     * @brief Преобразование числового вектора в строку
-     * @param v Входной вектор чисел
-     * @return Строка, составленная из символов алфавита
+     * @brief Обратные сдвиги ключа
+     * @param k Сдвиги ключа
+     * @return Сдвиги, отменяющие k по модулю размера алфавита
+     */
+    static std::vector<int> inverse(const std::vector<int>& k);
+
+    /**
+     * @brief Сдвиг букв участка текста по ключу
+     * @details Буквы переводятся в однобайтовые номера блоками по blockSize,
+     *          сдвигаются векторным ядром и сразу переводятся обратно в буквы.
+     *          Буквы принимаются в любом регистре, прочие символы пропускаются,
+     *          фаза ключа продвигается только на буквах алфавита.
+     * @param first Начало участка
+     * @param last Конец участка
+     * @param out Буфер результата, вмещающий last - first символов
+     * @param phase Позиция в ключе для первой буквы участка
+     * @param kernel Ядро сдвига (encKernel или decKernel)
+     * @return Количество записанных символов
      */
-    std::wstring convert(const std::vector<int>& v);
+    size_t transformRange(const wchar_t* first, const wchar_t* last, wchar_t* out,
+                          size_t phase, const gronsfeldKernel& kernel) const;
 
     /**
-     * @brief Приведение строки к верхнему регистру с удалением пробелов
+     * @brief Проверка и сдвиг букв строки по ключу
+     * @details В одном потоке текст проверяется, приводится к верхнему
+     *          регистру, очищается от пробелов, сдвигается и записывается за
+     *          один проход encryptTo или decryptTo, без промежуточных копий.
+     *          При threads > 1 и достаточной длине текст делится на участки:
+     *          сначала параллельно проверяется каждый участок и подсчитываются
+     *          его буквы, что даёт смещение участка в результате и фазу ключа,
+     *          затем участки параллельно записываются в заранее выделенную строку.
      * @param s Входная строка
-     * @return Строка в верхнем регистре без пробелов
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Строка результата
+     * @throw cipher_error Если текст не проходит проверку
      */
-    std::wstring toUpper(const std::wstring& s);
+    std::wstring transform(std::wstring_view s, bool decrypting, unsigned threads) const;
 
     /**
      * @brief Валидация и нормализация ключа
@@ -77,22 +277,6 @@ private:
      */
     std::wstring getValidKey(const std::wstring& s);
 
-    /**
-     * @brief Валидация открытого текста
-     * @param s Открытый текст
-     * @return Валидированный текст в верхнем регистре
-     * @throw cipher_error Если текст пустой или не содержит русских букв
-     */
-    std::wstring getValidOpenText(const std::wstring& s);
-
-    /**
-     * @brief Валидация зашифрованного текста
-     * @param s Зашифрованный текст
-     * @return Валидированный зашифрованный текст
-     * @throw cipher_error Если текст пустой или содержит недопустимые символы
-     */
-    std::wstring getValidCipherText(const std::wstring& s);
-
 public:
     /**
      * @brief Запрет конструктора без параметров
@@ -121,4 +305,277 @@ public:
      * @throw cipher_error Если текст пустой или содержит недопустимые символы
      */
     std::wstring decrypt(const std::wstring& cipher_text);
+
+    /**
+     * @brief Многопоточный метод зашифровывания
+     * @details Результат совпадает с однопоточным encrypt при любом числе потоков.
+     *          Тексты короче parallelThreshold обрабатываются в одном потоке.
+     * @param open_text Открытый текст для шифрования
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Зашифрованная строка
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    std::wstring encrypt(const std::wstring& open_text, unsigned threads);
+
+    /**
+     * @brief Многопоточный метод расшифровывания
+     * @details Результат совпадает с однопоточным decrypt при любом числе потоков.
+     *          Тексты короче parallelThreshold обрабатываются в одном потоке.
+     * @param cipher_text Зашифрованный текст для расшифрования
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Расшифрованная строка
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    std::wstring decrypt(const std::wstring& cipher_text, unsigned threads);
+
+    /**
+     * @brief Метод зашифровывания текста в кодировке UTF-8
+     * @details Двухбайтовые последовательности кириллицы декодируются сразу в
+     *          номера букв, результат записывается в одну заранее выделенную
+     *          строку. Результат совпадает с encrypt для того же текста в wstring.
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Метод расшифровывания текста в кодировке UTF-8
+     * @details Результат совпадает с decrypt для того же текста в wstring.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @details Не выделяет память в куче. Результат совпадает с encrypt.
+     *          Если размер результата больше capacity, буфер не заполняется,
+     *          и вызов можно повторить с буфером нужного размера. Буфера
+     *          размером с открытый текст всегда достаточно.
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата в символах
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    size_t encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @details Не выделяет память в куче. Результат совпадает с decrypt.
+     *          Буфера размером с зашифрованный текст всегда достаточно.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата в символах
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    size_t decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+     * @details Не выделяет память в куче. Буфера размером с открытый текст
+     *          всегда достаточно.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата в байтах
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     */
+    size_t encryptInto(std::string_view open_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+     * @details Не выделяет память в куче. Буфера размером с зашифрованный
+     *          текст всегда достаточно.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата в байтах
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    size_t decryptInto(std::string_view cipher_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего без исключений
+     * @details Ошибки текста возвращаются в result.status без исключений и
+     *          строк сообщений, память в куче не выделяется. Если result.size
+     *          больше capacity, буфер не заполняется.
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Результат проверки и размер результата в символах
+     */
+    result tryEncryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const noexcept;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Результат проверки и размер результата в символах
+     */
+    result tryDecryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const noexcept;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryEncryptInto(std::string_view open_text, char* out, size_t capacity) const noexcept;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryDecryptInto(std::string_view cipher_text, char* out, size_t capacity) const noexcept;
+
+    /**
+     * @brief Зашифровывание фрагмента текста в UTF-8 без исключений
+     * @details Фрагмент - часть текста, перед которой в тексте phase букв.
+     *          Результат совпадает с соответствующей частью шифртекста всего
+     *          текста, так что текст можно делить на части в любом месте между
+     *          символами и обрабатывать части независимо. Фрагмент без букв даёт
+     *          пустой результат со статусом emptyOpenText или invalidOpenText;
+     *          для фрагмента это не ошибка, текст в целом проверяет вызывающий.
+     * @param open_text Фрагмент открытого текста в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @param phase Количество букв текста перед фрагментом
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryEncryptInto(std::string_view open_text, char* out, size_t capacity,
+                          unsigned long long phase) const noexcept;
+
+    /**
+     * @brief Расшифровывание фрагмента текста в UTF-8 без исключений
+     * @details Аналогично tryEncryptInto с фазой; в шифртексте каждая буква
+     *          сдвигает фазу на единицу.
+     * @param cipher_text Фрагмент шифртекста в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @param phase Количество букв шифртекста перед фрагментом
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryDecryptInto(std::string_view cipher_text, char* out, size_t capacity,
+                          unsigned long long phase) const noexcept;
+
+    /**
+     * @brief Количество русских букв любого регистра в тексте UTF-8
+     * @details Фаза следующего фрагмента равна фазе текущего плюс количество
+     *          его букв.
+     * @param text Текст в UTF-8
+     * @return Количество букв
+     */
+    static size_t letterCount(std::string_view text) noexcept;
+
+    /**
+     * @brief Зашифровывание в строку вызывающего без исключений
+     * @details Результат совпадает с encrypt. Строка увеличивается только
+     *          после успешной проверки текста; при ошибке она очищается без
+     *          освобождения памяти, поэтому повторно используемая строка
+     *          не выделяет память ни при ошибках, ни при тексте не длиннее
+     *          прежнего.
+     * @param open_text Открытый текст
+     * @param out Зашифрованный текст, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryEncrypt(std::wstring_view open_text, std::wstring& out) const;
+
+    /**
+     * @brief Расшифровывание в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param cipher_text Зашифрованный текст
+     * @param out Расшифрованный текст, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryDecrypt(std::wstring_view cipher_text, std::wstring& out) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Зашифрованный текст в UTF-8, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryEncrypt(std::string_view open_text, std::string& out) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Расшифрованный текст в UTF-8, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryDecrypt(std::string_view cipher_text, std::string& out) const;
+
+    /**
+     * @brief Пакетное зашифровывание сообщений в UTF-8
+     * @details Сообщение i занимает в text байты [offsets[i], offsets[i + 1]).
+     *          Все результаты записываются подряд в arena, результат i занимает
+     *          байты [arenaOffsets[i], arenaOffsets[i + 1]). Ошибка в сообщении
+     *          не прерывает пакет: её код записывается в status[i], а результат
+     *          сообщения остаётся пустым. Буферы arena, arenaOffsets и status
+     *          изменяются в размере и при повторном использовании не
+     *          выделяют память заново.
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно зашифрованных сообщений
+     */
+    size_t encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const;
+
+    /**
+     * @brief Пакетное расшифровывание сообщений в UTF-8
+     * @details Аналогично encryptBatch.
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно расшифрованных сообщений
+     */
+    size_t decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const;
+
+    /**
+     * @brief Текст ошибки по результату проверки
+     * @param status Результат проверки
+     * @return Сообщение, с которым выбрасывается cipher_error; для ok - пустая строка
+     */
+    static const char* statusMessage(textStatus status);
+
+    /**
+     * @brief Снимок счётчиков модуля
+     * @details Счётчики ведутся только при сборке с -DCIPHER_STATS, иначе
+     *          снимок нулевой. Вызовы и отказы по причинам (индекс -
+     *          значение textStatus) считаются во всех интерфейсах, сообщения
+     *          пакета - по одному. Время однопроходного пути делится на
+     *          normalize (разбор, регистр, пробелы), transform (сдвиг блока)
+     *          и encode (запись блока); validate - отдельный проход подсчёта
+     *          букв, когда буфер меньше текста, и проверка участков в
+     *          многопоточном режиме, где сдвиг и запись учитываются как transform.
+     * @return Сумма счётчиков всех потоков
+     */
+    static cipherCounters statsSnapshot();
+
+    /**
+     * @brief Обнуление счётчиков модуля
+     */
+    static void resetStats();
 };
@@ -0,0 +1,161 @@
+/**
+ * @file modAlphaStream.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация потокового шифрования методом Гронсфельда
+ */
+
+#include "modAlphaStream.h"
+#include "../common/russianText.h"
+
+/**
+ * @brief Конструктор с ключом шифратора
+ * @param cipher Шифратор, ключ которого используется
+ * @param m Направление преобразования
+ */
+modAlphaStream::modAlphaStream(const modAlphaCipher& cipher, streamMode m)
+    : key(cipher.key), mode(m)
+{
+}
+
+/**
+ * @brief Обработка одного декодированного символа
+ * @param c Кодовая точка (U+FFFD для некорректной последовательности)
+ * @param out Строка, в конец которой дописывается результат
+ * @throw cipher_error При расшифровывании, если символ не является заглавной русской буквой
+ */
+void modAlphaStream::put(char32_t c, std::string& out)
+{
+    const modAlphaCipher::tables& t = modAlphaCipher::getTables();
+    int i;
+    if (mode == streamMode::encrypt) {
+        if (c == U' ') {
+            return;
+        }
+        hasNonSpace = true;
+        i = russianText::letterIndex(c);
+        if (i < 0) {
+            return;
+        }
+    } else {
+        hasNonSpace = true;
+        i = russianText::upperIndex(c);
+        if (i < 0) {
+            throw cipher_error("Invalid cipher text - contains non-Russian characters");
+        }
+    }
+
+    const wchar_t r = mode == streamMode::encrypt ? t.encShift[key[phase]][i] : t.decShift[key[phase]][i];
+    if (++phase == key.size()) {
+        phase = 0;
+    }
+    letters++;
+
+    // Все буквы алфавита кодируются в UTF-8 двумя байтами
+    out.push_back(static_cast<char>(0xC0 | (r >> 6)));
+    out.push_back(static_cast<char>(0x80 | (r & 0x3F)));
+}
+
+/**
+ * @brief Обработка очередной порции текста
+ * @param data Указатель на байты UTF-8
+ * @param size Количество байтов
+ * @param out Строка, в конец которой дописывается результат в UTF-8
+ * @throw cipher_error При расшифровывании, если встречен недопустимый символ
+ */
+void modAlphaStream::update(const char* data, size_t size, std::string& out)
+{
+    for (size_t n = 0; n < size; n++) {
+        unsigned char b = static_cast<unsigned char>(data[n]);
+        if (pending > 0) {
+            if ((b & 0xC0) == 0x80) {
+                codePoint = (codePoint << 6) | (b & 0x3F);
+                if (--pending == 0) {
+                    put(russianText::checkedCodePoint(codePoint, sequenceLength), out);
+                }
+                continue;
+            }
+            // Последовательность оборвалась: текущий байт начинает новый символ
+            pending = 0;
+            put(U'\uFFFD', out);
+        }
+        if (b < 0x80) {
+            put(b, out);
+        } else if ((b & 0xE0) == 0xC0) {
+            codePoint = b & 0x1F;
+            pending = 1;
+            sequenceLength = 2;
+        } else if ((b & 0xF0) == 0xE0) {
+            codePoint = b & 0x0F;
+            pending = 2;
+            sequenceLength = 3;
+        } else if ((b & 0xF8) == 0xF0) {
+            codePoint = b & 0x07;
+            pending = 3;
+            sequenceLength = 4;
+        } else {
+            put(U'\uFFFD', out);
+        }
+    }
+}
+
+/**
+ * @brief Обработка очередной порции текста
+ * @param chunk Порция текста в UTF-8
+ * @return Результат обработки порции в UTF-8
+ * @throw cipher_error При расшифровывании, если встречен недопустимый символ
+ */
+std::string modAlphaStream::update(const std::string& chunk)
+{
+    std::string result;
+    result.reserve(chunk.size() + 2);
+    update(chunk.data(), chunk.size(), result);
+    return result;
+}
+
+/**
+ * @brief Завершение потока
+ * @details Проверяет текст в целом и сбрасывает состояние для нового потока.
+ *          Оборванная в конце последовательность UTF-8 считается недопустимым символом.
+ * @throw cipher_error Если текст пустой, не содержит русских букв или
+ *        при расшифровывании обрывается посреди последовательности UTF-8
+ */
+void modAlphaStream::finish()
+{
+    const bool truncated = pending > 0;
+    const bool empty = !hasNonSpace && !truncated;
+    const bool noLetters = letters == 0;
+    const streamMode m = mode;
+    reset();
+
+    if (m == streamMode::decrypt) {
+        if (truncated) {
+            throw cipher_error("Invalid cipher text - contains non-Russian characters");
+        }
+        if (empty) {
+            throw cipher_error("Empty cipher text");
+        }
+    } else {
+        if (empty) {
+            throw cipher_error("Empty open text");
+        }
+        if (noLetters) {
+            throw cipher_error("Invalid open text - no Russian letters");
+        }
+    }
+}
+
+/**
+ * @brief Сброс состояния для обработки нового потока
+ */
+void modAlphaStream::reset()
+{
+    phase = 0;
+    letters = 0;
+    hasNonSpace = false;
+    codePoint = 0;
+    pending = 0;
+    sequenceLength = 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file modAlphaStream.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для потокового шифрования методом Гронсфельда
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "modAlphaCipher.h"
+
+/**
+ * @brief Класс для потокового шифрования методом Гронсфельда
+ * @details Принимает текст в кодировке UTF-8 произвольными порциями, в том числе
+ *          разрывающими многобайтовую последовательность, и сохраняет фазу ключа
+ *          между вызовами. Результат совпадает с однократным вызовом
+ *          modAlphaCipher::encrypt / decrypt для всего текста целиком.
+ *          Используемая память не зависит от длины потока.
+ * @warning Ошибки, относящиеся ко всему тексту (пустой текст, отсутствие русских
+ *          букв), обнаруживаются только в методе finish, когда часть результата
+ *          уже выдана.
+ */
+class modAlphaStream
+{
+public:
+    /**
+     * @brief Направление преобразования
+     */
+    enum class streamMode {
+        encrypt, ///< Зашифровывание
+        decrypt  ///< Расшифровывание
+    };
+
+private:
+    std::vector<int> key; ///< Ключ в числовом представлении
+    streamMode mode; ///< Направление преобразования
+    size_t phase = 0; ///< Текущая позиция в ключе
+    unsigned long long letters = 0; ///< Количество обработанных букв
+    bool hasNonSpace = false; ///< Встречен ли символ, отличный от пробела
+    char32_t codePoint = 0; ///< Накопленная часть кодовой точки
+    int pending = 0; ///< Количество недостающих байтов последовательности UTF-8
+    int sequenceLength = 0; ///< Длина текущей последовательности UTF-8 в байтах
+
+    /**
+     * @brief Обработка одного декодированного символа
+     * @param c Кодовая точка (U+FFFD для некорректной последовательности)
+     * @param out Строка, в конец которой дописывается результат
+     * @throw cipher_error При расшифровывании, если символ не является заглавной русской буквой
+     */
+    void put(char32_t c, std::string& out);
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    modAlphaStream() = delete;
+
+    /**
+     * @brief Конструктор с ключом шифратора
+     * @param cipher Шифратор, ключ которого используется
+     * @param m Направление преобразования
+     */
+    modAlphaStream(const modAlphaCipher& cipher, streamMode m);
+
+    /**
+     * @brief Обработка очередной порции текста
+     * @param data Указатель на байты UTF-8
+     * @param size Количество байтов
+     * @param out Строка, в конец которой дописывается результат в UTF-8
+     * @throw cipher_error При расшифровывании, если встречен недопустимый символ
+     */
+    void update(const char* data, size_t size, std::string& out);
+
+    /**
+     * @brief Обработка очередной порции текста
+     * @param chunk Порция текста в UTF-8
+     * @return Результат обработки порции в UTF-8
+     * @throw cipher_error При расшифровывании, если встречен недопустимый символ
+     */
+    std::string update(const std::string& chunk);
+
+    /**
+     * @brief Завершение потока
+     * @details Проверяет текст в целом и сбрасывает состояние для нового потока.
+     *          Весь результат к этому моменту уже выдан методом update.
+     * @throw cipher_error Если текст пустой, не содержит русских букв или
+     *        при расшифровывании обрывается посреди последовательности UTF-8
+     */
+    void finish();
+
+    /**
+     * @brief Сброс состояния для обработки нового потока
+     */
+    void reset();
+
+    /**
+     * @brief Количество обработанных букв
+     * @return Число букв, прошедших через шифр с начала потока
+     */
+    unsigned long long processed() const { return letters; }
+};
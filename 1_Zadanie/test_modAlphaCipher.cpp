@@ -1,7 +1,20 @@
 #include <UnitTest++/UnitTest++.h>
 #include "modAlphaCipher.h"
+#include "modAlphaStream.h"
+#include "gronsfeldKernel.h"
+#include "gronsfeldFixed.h"
+#include "gronsfeldAnalyzer.h"
+#include "gronsfeldPipeline.h"
+#include "../common/filePipeline.h"
+#include "../common/testAllocations.h"
 #include <iostream>
 #include <locale>
+#include <codecvt>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
 
 #define CHECK_EQUAL_WSTR(expected, actual) \
     do { \
@@ -132,6 +145,890 @@ SUITE(DecryptTest) {
     }
 }
 
+// Перевод строки в UTF-8 для сравнения с потоковым шифратором
+static std::string toUtf8(const std::wstring& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.to_bytes(s);
+}
+
+// Случайный текст из n символов алфавита alpha
+static std::wstring randomText(std::mt19937& rng, const std::wstring& alpha, size_t n) {
+    std::wstring text;
+    text.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        text += alpha[rng() % alpha.size()];
+    }
+    return text;
+}
+
+// Потоковая обработка текста порциями фиксированного размера
+static std::string streamChunks(modAlphaStream& stream, const std::string& text, size_t chunk) {
+    std::string result;
+    for (size_t pos = 0; pos < text.size(); pos += chunk) {
+        stream.update(text.data() + pos, std::min(chunk, text.size() - pos), result);
+    }
+    stream.finish();
+    return result;
+}
+
+SUITE(StreamTest) {
+    TEST(ChunkedEncryptMatchesWhole) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        std::wstring text = L"Съешь же ещё этих мягких французских булок, да выпей чаю! 2025";
+        std::string expected = toUtf8(cipher.encrypt(text));
+        std::string input = toUtf8(text);
+        for (size_t chunk = 1; chunk <= input.size(); chunk++) {
+            modAlphaStream stream(cipher, modAlphaStream::streamMode::encrypt);
+            CHECK_EQUAL(expected, streamChunks(stream, input, chunk));
+        }
+    }
+
+    TEST(ChunkedDecryptMatchesWhole) {
+        modAlphaCipher cipher(L"БСД");
+        std::wstring text = L"РЩДЧЫЁДДШЕЬСЗФЛЮВЙЗФУПЯМХТЖРЙЗФАТКНЙ";
+        std::string expected = toUtf8(cipher.decrypt(text));
+        std::string input = toUtf8(text);
+        for (size_t chunk = 1; chunk <= input.size(); chunk++) {
+            modAlphaStream stream(cipher, modAlphaStream::streamMode::decrypt);
+            CHECK_EQUAL(expected, streamChunks(stream, input, chunk));
+        }
+    }
+
+    TEST(KeyPhaseKeptAcrossCalls) {
+        modAlphaCipher cipher(L"БСД");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::encrypt);
+        std::string result = stream.update(toUtf8(L"АА"));
+        result += stream.update(toUtf8(L"ААА"));
+        CHECK_EQUAL(5u, stream.processed());
+        stream.finish();
+        CHECK_EQUAL(toUtf8(L"БСДБС"), result);
+    }
+
+    TEST(EmptyStream) {
+        modAlphaCipher cipher(L"Б");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::encrypt);
+        stream.update(toUtf8(L"   "));
+        CHECK_THROW(stream.finish(), cipher_error);
+    }
+
+    TEST(NoAlphaStream) {
+        modAlphaCipher cipher(L"Б");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::encrypt);
+        stream.update("1234+8765=9999");
+        CHECK_THROW(stream.finish(), cipher_error);
+    }
+
+    TEST(InvalidCipherStream) {
+        modAlphaCipher cipher(L"Б");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::decrypt);
+        CHECK_THROW(stream.update(toUtf8(L"УЁТ,УПГ")), cipher_error);
+    }
+
+    TEST(TruncatedCipherStream) {
+        modAlphaCipher cipher(L"Б");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::decrypt);
+        std::string input = toUtf8(L"УЁТ");
+        std::string result;
+        stream.update(input.data(), input.size() - 1, result);
+        CHECK_THROW(stream.finish(), cipher_error);
+    }
+
+    TEST(OverlongStream) {
+        // Буквы А и Б тремя байтами вместо двух, разрезанные между порциями
+        const std::string input = "\xE0\x90\x90\xE0\x90\x91";
+        modAlphaCipher cipher(L"Б");
+        modAlphaStream encryptor(cipher, modAlphaStream::streamMode::encrypt);
+        std::string result;
+        encryptor.update(input.data(), 4, result);
+        encryptor.update(input.data() + 4, input.size() - 4, result);
+        CHECK(result.empty());
+        CHECK_THROW(encryptor.finish(), cipher_error);
+        modAlphaStream decryptor(cipher, modAlphaStream::streamMode::decrypt);
+        decryptor.update(input.data(), 2, result);
+        CHECK_THROW(decryptor.update(input.data() + 2, input.size() - 2, result), cipher_error);
+    }
+}
+
+SUITE(KernelTest) {
+    TEST(AllIsaMatchScalar) {
+        std::mt19937 rng(2025);
+        const gronsfeldKernel::isa all[] = {gronsfeldKernel::isa::sse42, gronsfeldKernel::isa::avx2,
+                                            gronsfeldKernel::isa::avx512};
+        for (size_t keyLen = 1; keyLen <= 70; keyLen++) {
+            std::vector<int> shifts(keyLen);
+            for (int& k : shifts) {
+                k = rng() % gronsfeldKernel::alphaSize;
+            }
+            gronsfeldKernel kernel(shifts);
+            size_t n = rng() % 300;
+            std::vector<unsigned char> in(n), expected(n), actual(n);
+            for (unsigned char& c : in) {
+                c = rng() % gronsfeldKernel::alphaSize;
+            }
+            for (size_t phase = 0; phase < keyLen; phase++) {
+                kernel.apply(gronsfeldKernel::isa::scalar, in.data(), expected.data(), n, phase);
+                for (size_t i = 0; i < n; i++) {
+                    CHECK_EQUAL((in[i] + shifts[(i + phase) % keyLen]) % gronsfeldKernel::alphaSize, int(expected[i]));
+                }
+                for (gronsfeldKernel::isa isa : all) {
+                    if (!gronsfeldKernel::supported(isa)) {
+                        continue;
+                    }
+                    kernel.apply(isa, in.data(), actual.data(), n, phase);
+                    CHECK(expected == actual);
+                }
+            }
+        }
+    }
+
+    TEST(LongTextMatchesStream) {
+        std::mt19937 rng(33);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::wstring text = randomText(rng, alpha, 10000);
+        modAlphaCipher cipher(L"ШИФРГРОНСФЕЛЬДА");
+        modAlphaStream stream(cipher, modAlphaStream::streamMode::encrypt);
+        std::wstring encrypted = cipher.encrypt(text);
+        CHECK_EQUAL(stream.update(toUtf8(text)), toUtf8(encrypted));
+        CHECK(cipher.decrypt(encrypted) == text);
+    }
+}
+
+SUITE(ParallelTest) {
+    TEST(EncryptMatchesSerial) {
+        std::mt19937 rng(7);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя 0123,.!";
+        std::wstring text = randomText(rng, alpha, 300000);
+        modAlphaCipher cipher(L"ПАРАЛЛЕЛЬ");
+        std::wstring expected = cipher.encrypt(text);
+        for (unsigned threads = 0; threads <= 8; threads++) {
+            CHECK(cipher.encrypt(text, threads) == expected);
+        }
+    }
+
+    TEST(DecryptMatchesSerial) {
+        std::mt19937 rng(8);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::wstring text = randomText(rng, alpha, 300001);
+        modAlphaCipher cipher(L"ГРОНСФЕЛЬД");
+        std::wstring expected = cipher.decrypt(text);
+        for (unsigned threads = 0; threads <= 8; threads++) {
+            CHECK(cipher.decrypt(text, threads) == expected);
+        }
+        CHECK(cipher.encrypt(expected, 4) == text);
+    }
+
+    TEST(ErrorsMatchSerial) {
+        modAlphaCipher cipher(L"ПАРАЛЛЕЛЬ");
+        const std::wstring spaces(300000, L' ');
+        std::wstring digit = spaces;
+        digit[200000] = L'7';
+        std::wstring lower(300000, L'Ж');
+        lower[250000] = L'ж';
+        auto error = [](auto f) {
+            try {
+                f();
+            } catch (const cipher_error& e) {
+                return std::string(e.what());
+            }
+            return std::string();
+        };
+        for (unsigned threads : {1u, 4u}) {
+            CHECK_EQUAL("Empty open text", error([&] { cipher.encrypt(spaces, threads); }));
+            CHECK_EQUAL("Invalid open text - no Russian letters", error([&] { cipher.encrypt(digit, threads); }));
+            CHECK_EQUAL("Invalid cipher text - contains non-Russian characters",
+                        error([&] { cipher.decrypt(lower, threads); }));
+            CHECK_EQUAL("Invalid cipher text - contains non-Russian characters",
+                        error([&] { cipher.decrypt(spaces, threads); }));
+        }
+    }
+
+    TEST_FIXTURE(KeyB_fixture, ShortTextStaysSerial) {
+        CHECK_EQUAL_WSTR(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ",
+                   p->encrypt(L"Тестовое сообщение для проверки!!!", 8));
+        CHECK_THROW(p->encrypt(L"1234+8765=9999", 8), cipher_error);
+        CHECK_THROW(p->decrypt(L"УЁТ,УПГ", 8), cipher_error);
+    }
+}
+
+// Результат шифрования или текст исключения для сравнения двух интерфейсов
+template <typename F>
+static std::string outcome(F f) {
+    try {
+        return f();
+    } catch (const cipher_error& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+SUITE(Utf8Test) {
+    TEST_FIXTURE(KeyB_fixture, EncryptUtf8) {
+        CHECK_EQUAL(toUtf8(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ"),
+                    p->encrypt(std::string_view(toUtf8(L"Тестовое 123 сообщение для проверки!!!"))));
+    }
+
+    TEST_FIXTURE(KeyB_fixture, DecryptUtf8) {
+        CHECK_EQUAL(toUtf8(L"ТЕСТОВОЕСООБЩЕНИЕДЛЯПРОВЕРКИ"),
+                    p->decrypt(std::string_view(toUtf8(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ"))));
+    }
+
+    TEST_FIXTURE(KeyB_fixture, InvalidUtf8) {
+        CHECK_THROW(p->encrypt(std::string_view("")), cipher_error);
+        CHECK_THROW(p->encrypt(std::string_view("   ")), cipher_error);
+        CHECK_THROW(p->encrypt(std::string_view("1234+8765=9999")), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("")), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view(toUtf8(L"УЁТ,УПГ"))), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view(toUtf8(L"уёт"))), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("\xD0")), cipher_error);
+    }
+
+    TEST_FIXTURE(KeyB_fixture, OverlongUtf8) {
+        // Буквы А и Б тремя байтами вместо двух - не кириллица
+        CHECK_THROW(p->encrypt(std::string_view("\xE0\x90\x90\xE0\x90\x91")), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("\xE0\x90\x90\xE0\x90\x91")), cipher_error);
+    }
+
+    TEST(MatchesWideApi) {
+        std::mt19937 rng(5);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя   019,.!aZ€";
+        modAlphaCipher cipher(L"ЮНИКОД");
+        for (int n = 0; n < 2000; n++) {
+            size_t len = rng() % (n < 1000 ? 20 : 10000);
+            std::wstring text = randomText(rng, alpha, len);
+            std::string utf8 = toUtf8(text);
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                        outcome([&] { return cipher.encrypt(std::string_view(utf8)); }));
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.decrypt(text)); }),
+                        outcome([&] { return cipher.decrypt(std::string_view(utf8)); }));
+        }
+    }
+}
+
+SUITE(IntoTest) {
+    TEST_FIXTURE(KeyB_fixture, EncryptInto) {
+        wchar_t out[64];
+        size_t n = p->encryptInto(L"Тестовое сообщение для проверки!!!", out, 64);
+        CHECK_EQUAL_WSTR(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ", std::wstring(out, n));
+    }
+
+    TEST_FIXTURE(KeyB_fixture, DecryptInto) {
+        wchar_t out[64];
+        size_t n = p->decryptInto(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ", out, 64);
+        CHECK_EQUAL_WSTR(L"ТЕСТОВОЕСООБЩЕНИЕДЛЯПРОВЕРКИ", std::wstring(out, n));
+    }
+
+    TEST_FIXTURE(KeyB_fixture, ReportsNeededSize) {
+        wchar_t out[4] = {L'x', L'x', L'x', L'x'};
+        CHECK_EQUAL(28u, p->encryptInto(L"Тестовое сообщение для проверки!!!", out, 4));
+        CHECK_EQUAL(28u, p->decryptInto(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ", out, 4));
+        CHECK(out[0] == L'x');
+        char bytes[8];
+        CHECK_EQUAL(56u, p->encryptInto(std::string_view(toUtf8(L"Тестовое сообщение для проверки!!!")), bytes, 8));
+        CHECK_EQUAL(12u, p->encryptInto(std::string_view(toUtf8(L"при вет")), bytes, 8));
+    }
+
+    TEST_FIXTURE(KeyB_fixture, InvalidText) {
+        wchar_t out[64];
+        CHECK_THROW(p->encryptInto(L"", out, 64), cipher_error);
+        CHECK_THROW(p->encryptInto(L"1234+8765=9999", out, 2), cipher_error);
+        CHECK_THROW(p->decryptInto(L"УЁТ,УПГ", out, 64), cipher_error);
+        CHECK_THROW(p->decryptInto(L"УЁТ,УПГ", out, 2), cipher_error);
+    }
+
+    TEST(MatchesEncrypt) {
+        std::mt19937 rng(11);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя 019,.!";
+        modAlphaCipher cipher(L"БУФЕР");
+        std::vector<wchar_t> out(10000);
+        for (int n = 0; n < 200; n++) {
+            size_t len = 1 + rng() % 9000;
+            std::wstring text = randomText(rng, alpha, len);
+            std::wstring expected = cipher.encrypt(text);
+            size_t capacity = rng() % 2 ? out.size() : expected.size();
+            CHECK(std::wstring(out.data(), cipher.encryptInto(text, out.data(), capacity)) == expected);
+            CHECK(std::wstring(out.data(), cipher.decryptInto(expected, out.data(), capacity)) == cipher.decrypt(expected));
+        }
+    }
+
+    TEST(NoHeapAllocations) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        const std::wstring text = L"Съешь же ещё этих мягких французских булок, да выпей чаю";
+        const std::string utf8 = toUtf8(text);
+        wchar_t wide[128];
+        wchar_t wideBack[128];
+        char bytes[256];
+        char bytesBack[256];
+        const size_t before = allocationCount;
+        for (int i = 0; i < 1000; i++) {
+            size_t n = cipher.encryptInto(text, wide, 128);
+            cipher.decryptInto(std::wstring_view(wide, n), wideBack, 128);
+            n = cipher.encryptInto(std::string_view(utf8), bytes, sizeof bytes);
+            cipher.decryptInto(std::string_view(bytes, n), bytesBack, sizeof bytesBack);
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Сборка пакета сообщений: общий буфер и границы
+static void makeBatch(const std::vector<std::string>& messages, std::string& text, std::vector<size_t>& offsets) {
+    text.clear();
+    offsets.assign(1, 0);
+    for (const std::string& m : messages) {
+        text += m;
+        offsets.push_back(text.size());
+    }
+}
+
+SUITE(BatchTest) {
+    TEST(MatchesPerCall) {
+        modAlphaCipher cipher(L"ПАКЕТ");
+        std::vector<std::string> messages = {
+            toUtf8(L"Привет мир"), "", toUtf8(L"123 !"), "   ", toUtf8(L"ещё одно сообщение 42"), toUtf8(L"Я")
+        };
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<modAlphaCipher::textStatus> status;
+        CHECK_EQUAL(3u, cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status));
+        CHECK_EQUAL(messages.size() + 1, arenaOffsets.size());
+        for (size_t i = 0; i < messages.size(); i++) {
+            std::string expected = outcome([&] { return cipher.encrypt(std::string_view(messages[i])); });
+            if (status[i] == modAlphaCipher::textStatus::ok) {
+                CHECK_EQUAL(expected, arena.substr(arenaOffsets[i], arenaOffsets[i + 1] - arenaOffsets[i]));
+            } else {
+                CHECK_EQUAL(expected, std::string("error: ") + modAlphaCipher::statusMessage(status[i]));
+                CHECK_EQUAL(arenaOffsets[i], arenaOffsets[i + 1]);
+            }
+        }
+        CHECK(status[1] == modAlphaCipher::textStatus::emptyOpenText);
+        CHECK(status[2] == modAlphaCipher::textStatus::invalidOpenText);
+        CHECK(status[3] == modAlphaCipher::textStatus::emptyOpenText);
+    }
+
+    TEST(DecryptStatuses) {
+        modAlphaCipher cipher(L"ПАКЕТ");
+        std::vector<std::string> messages = {
+            cipher.encrypt(std::string_view(toUtf8(L"Привет мир"))), "", toUtf8(L"ПРИ ВЕТ"), toUtf8(L"привет")
+        };
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<modAlphaCipher::textStatus> status;
+        CHECK_EQUAL(1u, cipher.decryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status));
+        CHECK_EQUAL(toUtf8(L"ПРИВЕТМИР"), arena);
+        CHECK(status[1] == modAlphaCipher::textStatus::emptyCipherText);
+        CHECK(status[2] == modAlphaCipher::textStatus::invalidCipherText);
+        CHECK(status[3] == modAlphaCipher::textStatus::invalidCipherText);
+    }
+
+    TEST(EmptyBatch) {
+        modAlphaCipher cipher(L"ПАКЕТ");
+        size_t offsets[1] = {0};
+        std::string arena = "old";
+        std::vector<size_t> arenaOffsets;
+        std::vector<modAlphaCipher::textStatus> status;
+        CHECK_EQUAL(0u, cipher.encryptBatch("", offsets, 0, arena, arenaOffsets, status));
+        CHECK(arena.empty());
+        CHECK_EQUAL(1u, arenaOffsets.size());
+        CHECK(status.empty());
+    }
+
+    TEST(ReusedBuffersDoNotAllocate) {
+        modAlphaCipher cipher(L"ПАКЕТ");
+        std::vector<std::string> messages;
+        for (int i = 0; i < 1000; i++) {
+            messages.push_back(i % 10 == 0 ? "1" : toUtf8(L"Сообщение номер ") + std::to_string(i));
+        }
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<modAlphaCipher::textStatus> status;
+        cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+        const size_t before = allocationCount;
+        for (int i = 0; i < 10; i++) {
+            CHECK_EQUAL(900u, cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status));
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Тестовый сценарий для методов без исключений (TryTest)
+SUITE(TryTest) {
+    TEST_FIXTURE(KeyB_fixture, Statuses) {
+        wchar_t out[64];
+        modAlphaCipher::result r = p->tryEncryptInto(L"Тестовое сообщение для проверки!!!", out, 64);
+        CHECK(r);
+        CHECK_EQUAL_WSTR(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ", std::wstring(out, r.size));
+        r = p->tryEncryptInto(L"", out, 64);
+        CHECK(!r && r.status == modAlphaCipher::textStatus::emptyOpenText && r.size == 0);
+        CHECK(p->tryEncryptInto(L"1234+8765=9999", out, 2).status == modAlphaCipher::textStatus::invalidOpenText);
+        CHECK(p->tryDecryptInto(L"", out, 64).status == modAlphaCipher::textStatus::emptyCipherText);
+        CHECK(p->tryDecryptInto(L"УЁТ,УПГ", out, 64).status == modAlphaCipher::textStatus::invalidCipherText);
+        CHECK(p->tryDecryptInto(std::string_view(toUtf8(L"при вет")), nullptr, 0).status ==
+              modAlphaCipher::textStatus::invalidCipherText);
+    }
+
+    TEST_FIXTURE(KeyB_fixture, ReportsNeededSize) {
+        wchar_t out[4] = {L'x', L'x', L'x', L'x'};
+        modAlphaCipher::result r = p->tryEncryptInto(L"Тестовое сообщение для проверки!!!", out, 4);
+        CHECK(r);
+        CHECK_EQUAL(28u, r.size);
+        CHECK(out[0] == L'x');
+    }
+
+    TEST(MatchesThrowing) {
+        std::mt19937 rng(17);
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя   019,.!";
+        const std::wstring upper = alpha.substr(0, 33);
+        modAlphaCipher cipher(L"БЕЗИСКЛЮЧЕНИЙ");
+        std::string out;
+        std::wstring wide;
+        for (int n = 0; n < 300; n++) {
+            size_t len = rng() % 4 == 0 ? rng() % 4 : rng() % 3000;
+            std::wstring text = randomText(rng, n % 3 == 0 ? upper : alpha, len);
+            std::string utf8 = toUtf8(text);
+            for (bool decrypting : {false, true}) {
+                std::string_view m(utf8);
+                std::string expected = outcome([&] { return decrypting ? cipher.decrypt(m) : cipher.encrypt(m); });
+                modAlphaCipher::textStatus status = decrypting ? cipher.tryDecrypt(m, out) : cipher.tryEncrypt(m, out);
+                if (status == modAlphaCipher::textStatus::ok) {
+                    CHECK_EQUAL(expected, out);
+                } else {
+                    CHECK_EQUAL(expected, std::string("error: ") + modAlphaCipher::statusMessage(status));
+                    CHECK(out.empty());
+                }
+                status = decrypting ? cipher.tryDecrypt(text, wide) : cipher.tryEncrypt(text, wide);
+                CHECK_EQUAL(expected, status == modAlphaCipher::textStatus::ok
+                                          ? toUtf8(wide)
+                                          : std::string("error: ") + modAlphaCipher::statusMessage(status));
+            }
+        }
+    }
+
+    TEST(ErrorsDoNotAllocate) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        const std::string good = toUtf8(L"Съешь же ещё этих мягких французских булок, да выпей чаю");
+        const std::string bad[] = {"", "   ", "12345", toUtf8(L"ПРИ ВЕТ"), toUtf8(L"привет")};
+        std::string out;
+        cipher.tryEncrypt(std::string_view(good), out);
+        const size_t before = allocationCount;
+        for (int i = 0; i < 1000; i++) {
+            for (const std::string& m : bad) {
+                CHECK(cipher.tryDecrypt(std::string_view(m), out) != modAlphaCipher::textStatus::ok);
+                CHECK(out.empty());
+            }
+            CHECK(cipher.tryEncrypt(std::string_view(good), out) == modAlphaCipher::textStatus::ok);
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Ключи шифра с ключом на этапе компиляции
+constexpr wchar_t fixedKeyB[] = L"Б";
+constexpr wchar_t fixedKeyMixed[] = L"ёЖикВтумАне";
+constexpr wchar_t fixedKeyLong[] = L"ДЛИННЫЙКЛЮЧНЕКРАТНЫЙРАЗМЕРУБЛОКАЯЮЭЪЩЧ";
+
+static_assert(!gronsfeldFixedKey::letters(L"КЛЮЧ1"), "digit in key");
+static_assert(gronsfeldFixedKey::weak(L"ААБ") && !gronsfeldFixedKey::weak(L"АБ"), "weak key rule");
+static_assert(gronsfeldFixedKey::weak(L"ЁЁЁЖ"), "Ё is a zero shift");
+
+// Сравнение шифра с ключом на этапе компиляции с modAlphaCipher на случайных текстах
+template <const wchar_t* Key>
+static void checkFixedMatchesRuntime(unsigned seed) {
+    using fixed = gronsfeldFixed<Key>;
+    modAlphaCipher cipher(Key);
+    std::mt19937 rng(seed);
+    std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя   019,.!aZ€";
+    for (int n = 0; n < 300; n++) {
+        size_t len = rng() % (n < 200 ? 40 : 20000);
+        std::wstring text = randomText(rng, alpha, len);
+        std::string utf8 = toUtf8(text);
+        CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                    outcome([&] { return toUtf8(fixed::encrypt(text)); }));
+        CHECK_EQUAL(outcome([&] { return toUtf8(cipher.decrypt(text)); }),
+                    outcome([&] { return toUtf8(fixed::decrypt(text)); }));
+        CHECK_EQUAL(outcome([&] { return cipher.encrypt(std::string_view(utf8)); }),
+                    outcome([&] { return fixed::encrypt(std::string_view(utf8)); }));
+        CHECK_EQUAL(outcome([&] { return cipher.decrypt(std::string_view(utf8)); }),
+                    outcome([&] { return fixed::decrypt(std::string_view(utf8)); }));
+    }
+}
+
+SUITE(StatsTest) {
+    TEST_FIXTURE(KeyB_fixture, CountsCallsAndFailures) {
+        const std::wstring open = L"Тестовое сообщение для проверки!!!";
+        wchar_t out[64];
+        modAlphaCipher::resetStats();
+        p->encrypt(open);
+        p->tryDecryptInto(L"УЁТ,УПГ", out, 64);
+        CHECK_THROW(p->encrypt(L""), cipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("")), cipher_error);
+        cipherCounters c = modAlphaCipher::statsSnapshot();
+        using status = modAlphaCipher::textStatus;
+        if (cipherStats<modAlphaCipher>::enabled) {
+            CHECK_EQUAL(4ull, c.calls);
+            CHECK_EQUAL(open.size() + 7, c.chars);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::emptyOpenText)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::emptyCipherText)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::invalidCipherText)]);
+            CHECK_EQUAL(0ull, c.failures[static_cast<unsigned>(status::ok)]);
+            CHECK(c.allocatedBytes >= open.size() * sizeof(wchar_t));
+            CHECK(c.stageNs[static_cast<size_t>(cipherStage::transform)] > 0);
+        } else {
+            CHECK_EQUAL(0ull, c.calls);
+            CHECK_EQUAL(0ull, c.chars);
+            CHECK_EQUAL(0ull, c.allocatedBytes);
+        }
+        modAlphaCipher::resetStats();
+        CHECK_EQUAL(0ull, modAlphaCipher::statsSnapshot().calls);
+    }
+
+    TEST(SumsThreadsAndBatch) {
+        modAlphaCipher cipher(L"ПАКЕТ");
+        std::vector<std::string> messages = {toUtf8(L"Привет мир"), "", toUtf8(L"123 !"), toUtf8(L"Я")};
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+        modAlphaCipher::resetStats();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&] {
+                std::string arena;
+                std::vector<size_t> arenaOffsets;
+                std::vector<modAlphaCipher::textStatus> status;
+                for (int i = 0; i < 100; i++) {
+                    cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+                }
+            });
+        }
+        for (std::thread& w : workers) {
+            w.join();
+        }
+        cipherCounters c = modAlphaCipher::statsSnapshot();
+        if (cipherStats<modAlphaCipher>::enabled) {
+            CHECK_EQUAL(1600ull, c.calls);
+            CHECK_EQUAL(400ull * text.size(), c.chars);
+            CHECK_EQUAL(400ull, c.failures[static_cast<unsigned>(modAlphaCipher::textStatus::emptyOpenText)]);
+            CHECK_EQUAL(400ull, c.failures[static_cast<unsigned>(modAlphaCipher::textStatus::invalidOpenText)]);
+        } else {
+            CHECK_EQUAL(0ull, c.calls);
+        }
+    }
+
+    TEST(ReusesSlotsOfFinishedThreads) {
+        modAlphaCipher cipher(L"ПОТОК");
+        const std::string text = toUtf8(L"Привет мир");
+        modAlphaCipher::resetStats();
+        std::string out;
+        cipher.tryEncrypt(std::string_view(text), out);
+        const size_t before = cipherStats<modAlphaCipher>::slotCount();
+        for (int i = 0; i < 50; i++) {
+            std::thread([&] {
+                std::string result;
+                cipher.tryEncrypt(std::string_view(text), result);
+            }).join();
+        }
+        cipherCounters c = modAlphaCipher::statsSnapshot();
+        if (cipherStats<modAlphaCipher>::enabled) {
+            CHECK(cipherStats<modAlphaCipher>::slotCount() <= before + 1);
+            CHECK_EQUAL(51ull, c.calls);
+            CHECK_EQUAL(51ull * text.size(), c.chars);
+        } else {
+            CHECK_EQUAL(0u, cipherStats<modAlphaCipher>::slotCount());
+            CHECK_EQUAL(0ull, c.calls);
+        }
+    }
+}
+
+SUITE(FixedKeyTest) {
+    TEST(KnownAnswer) {
+        CHECK_EQUAL_WSTR(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ",
+                         gronsfeldFixed<fixedKeyB>::encrypt(L"Тестовое 123 сообщение для проверки!!!"));
+        CHECK_EQUAL_WSTR(L"ТЕСТОВОЕСООБЩЕНИЕДЛЯПРОВЕРКИ",
+                         gronsfeldFixed<fixedKeyB>::decrypt(L"УЁТУПГПЁТППВЪЁОЙЁЕМАРСПГЁСЛЙ"));
+    }
+
+    TEST(MatchesRuntimeCipher) {
+        checkFixedMatchesRuntime<fixedKeyB>(21);
+        checkFixedMatchesRuntime<fixedKeyMixed>(22);
+        checkFixedMatchesRuntime<fixedKeyLong>(23);
+    }
+
+    TEST(RoundTripAcrossBlocks) {
+        std::wstring text;
+        for (int i = 0; i < 10000; i++) {
+            text += russianText::alphabet()[(i * 7) % 33];
+        }
+        using fixed = gronsfeldFixed<fixedKeyLong>;
+        CHECK(fixed::encrypt(text) == modAlphaCipher(fixedKeyLong).encrypt(text));
+        CHECK(fixed::decrypt(fixed::encrypt(text)) == text);
+    }
+
+    TEST(ErrorMessagesMatch) {
+        using fixed = gronsfeldFixed<fixedKeyMixed>;
+        CHECK_EQUAL("error: Empty open text", outcome([] { return fixed::encrypt(std::string_view("   ")); }));
+        CHECK_EQUAL("error: Invalid open text - no Russian letters",
+                    outcome([] { return fixed::encrypt(std::string_view("1234+8765=9999")); }));
+        CHECK_EQUAL("error: Empty cipher text", outcome([] { return fixed::decrypt(std::string_view("")); }));
+        CHECK_EQUAL("error: Invalid cipher text - contains non-Russian characters",
+                    outcome([] { return fixed::decrypt(std::string_view(toUtf8(L"уёт"))); }));
+    }
+
+    TEST(IntoReportsSizeWithoutWriting) {
+        using fixed = gronsfeldFixed<fixedKeyMixed>;
+        char out[4] = {'x', 'x', 'x', 'x'};
+        const std::string text = toUtf8(L"Длинное сообщение");
+        CHECK_EQUAL(modAlphaCipher(fixedKeyMixed).encryptInto(std::string_view(text), out, 4),
+                    fixed::encryptInto(std::string_view(text), out, 4));
+        CHECK_EQUAL(std::string("xxxx"), std::string(out, 4));
+    }
+
+    TEST(IntoDoesNotAllocate) {
+        using fixed = gronsfeldFixed<fixedKeyLong>;
+        std::wstring text(5000, L'Ж');
+        std::wstring out(text.size(), L'\0');
+        const size_t before = allocationCount;
+        size_t n = fixed::encryptInto(text, &out[0], out.size());
+        n = fixed::decryptInto(std::wstring_view(out.data(), n), &out[0], out.size());
+        CHECK_EQUAL(before, allocationCount);
+        CHECK(out == text);
+    }
+}
+
+// Русский текст для проверки восстановления ключа по частотам букв
+static const std::wstring analyzerPlainText =
+    L"Осенью в нашем городе рано темнеет, и по вечерам на улицах почти никого не бывает. "
+    L"Только старый сторож медленно обходит площадь, проверяет замки на дверях лавок и "
+    L"иногда останавливается у фонаря, чтобы закурить. Дождь идёт уже третью неделю, "
+    L"реки вышли из берегов, и дорога к станции превратилась в широкое грязное болото. "
+    L"Поезда приходят редко, а почту привозят на телеге раз в несколько дней. Люди сидят "
+    L"по домам, топят печи, пьют горячий чай и рассказывают друг другу старые истории о "
+    L"том, как жили их деды и прадеды. В такие вечера время тянется медленно, и кажется, "
+    L"что весна никогда не наступит. Но однажды утром над крышами поднимется солнце, "
+    L"снег растает, ручьи побегут вдоль заборов, и дети выйдут на улицу пускать кораблики. "
+    L"Учитель нашей школы говорил, что каждый человек должен хотя бы раз в жизни увидеть "
+    L"море. Он родился на севере, долго служил на флоте и знал о кораблях всё, что только "
+    L"можно знать. По субботам он собирал учеников в большом зале, раскладывал на столе "
+    L"старые карты и объяснял, как моряки находили дорогу по звёздам, как измеряли глубину "
+    L"и скорость течения, как пережидали шторм в открытом океане. Мы слушали его с "
+    L"открытыми ртами и мечтали о дальних странах, о тёплых островах и высоких горах. "
+    L"Потом мы выросли, разъехались по разным городам, и многие из нас действительно "
+    L"увидели море. Но никто не забыл тех субботних вечеров, запаха старой бумаги и "
+    L"спокойного голоса учителя, который рассказывал о ветре, волнах и парусах. Когда я "
+    L"приезжаю домой, я всегда прохожу мимо школы и смотрю на окна большого зала. "
+    L"Весной в деревне начинается работа. Мужики чинят плуги, женщины сажают огород, "
+    L"старики сидят на лавочке у ворот и обсуждают погоду. Если лето выдастся тёплым, "
+    L"урожай будет хорошим, и осенью на ярмарке можно будет продать зерно и купить новую "
+    L"лошадь. Если же пойдут дожди, придётся снова ждать следующего года. Так живут здесь "
+    L"уже много веков, и никто не жалуется, потому что земля кормит тех, кто о ней "
+    L"заботится. Вечером вся семья собирается за столом, отец читает газету, мать "
+    L"разливает суп, а младшие дети спорят о том, кто первым пойдёт утром за водой.";
+
+// Тестовый сценарий для восстановления ключа (AnalyzerTest)
+SUITE(AnalyzerTest) {
+    TEST(RecoversKnownKeys) {
+        for (const wchar_t* key : {L"ЯКОРЬ", L"МОРЕ", L"ПАРОХОД", L"ГРОНСФЕЛЬД"}) {
+            gronsfeldAnalyzer analyzer(modAlphaCipher(key).encrypt(analyzerPlainText));
+            std::vector<gronsfeldAnalyzer::candidate> candidates = analyzer.recover(20, 3);
+            CHECK(!candidates.empty());
+            CHECK(candidates.size() <= 3);
+            CHECK_EQUAL_WSTR(key, candidates[0].key);
+            for (size_t i = 1; i < candidates.size(); i++) {
+                CHECK(candidates[i - 1].score >= candidates[i].score);
+            }
+        }
+    }
+
+    TEST(PeriodScoresPeakAtKeyLength) {
+        gronsfeldAnalyzer analyzer(modAlphaCipher(L"ПАРОХОД").encrypt(analyzerPlainText));
+        std::vector<double> scores = analyzer.periodScores(12);
+        CHECK_EQUAL(13u, scores.size());
+        CHECK(scores[7] > 0.045);
+        for (size_t p : {1, 2, 3, 5, 6, 8, 11}) {
+            CHECK(scores[p] < 0.04);
+        }
+    }
+
+    TEST(ThreadCountDoesNotChangeResult) {
+        gronsfeldAnalyzer analyzer(toUtf8(modAlphaCipher(L"ГРОНСФЕЛЬД").encrypt(analyzerPlainText)));
+        std::vector<gronsfeldAnalyzer::candidate> serial = analyzer.recover(24, 5, 1);
+        for (unsigned threads : {0u, 2u, 3u, 8u}) {
+            std::vector<gronsfeldAnalyzer::candidate> parallel = analyzer.recover(24, 5, threads);
+            CHECK_EQUAL(serial.size(), parallel.size());
+            for (size_t i = 0; i < serial.size() && i < parallel.size(); i++) {
+                CHECK_EQUAL_WSTR(serial[i].key, parallel[i].key);
+                CHECK_EQUAL(serial[i].score, parallel[i].score);
+            }
+        }
+    }
+
+    TEST(RepeatedKeyIsReduced) {
+        gronsfeldAnalyzer analyzer(modAlphaCipher(L"МОРЕМОРЕ").encrypt(analyzerPlainText));
+        CHECK_EQUAL_WSTR(L"МОРЕ", analyzer.recover(16, 1)[0].key);
+    }
+
+    TEST(LongTextRefinedByAllLetters) {
+        std::wstring plain;
+        while (plain.size() < 2 * gronsfeldAnalyzer::sampleLetters) {
+            plain += analyzerPlainText;
+        }
+        gronsfeldAnalyzer analyzer(modAlphaCipher(L"ЯКОРЬ").encrypt(plain));
+        CHECK(analyzer.length() > gronsfeldAnalyzer::sampleLetters);
+        CHECK_EQUAL_WSTR(L"ЯКОРЬ", analyzer.recover(8, 2, 2)[0].key);
+    }
+
+    TEST(FrequenciesSumToOne) {
+        double total = 0;
+        for (int i = 0; i < 33; i++) {
+            total += gronsfeldAnalyzer::frequencies()[i];
+        }
+        CHECK_CLOSE(1.0, total, 1e-9);
+    }
+
+    TEST(InvalidCipherText) {
+        CHECK_THROW(gronsfeldAnalyzer(std::wstring()), cipher_error);
+        CHECK_THROW(gronsfeldAnalyzer(std::wstring(L"ПРИВЕТ МИР")), cipher_error);
+        CHECK_THROW(gronsfeldAnalyzer(std::string_view(toUtf8(L"привет"))), cipher_error);
+        CHECK_THROW(gronsfeldAnalyzer(std::wstring(L"ПРИВЕТ")).recover(0, 1), cipher_error);
+    }
+}
+
+// Прогон конвейера шифра Гронсфельда над текстом через временные файлы;
+// status, если задан, получает результат проверки всего текста
+static std::string pipelineRun(const modAlphaCipher& cipher, const std::string& text, bool decrypting,
+                               size_t blockSize, unsigned workers,
+                               modAlphaCipher::textStatus* status = nullptr) {
+    std::FILE* in = std::tmpfile();
+    std::FILE* out = std::tmpfile();
+    std::fwrite(text.data(), 1, text.size(), in);
+    std::fflush(in);
+    std::rewind(in);
+    filePipeline::options settings;
+    settings.blockSize = blockSize;
+    settings.workers = workers;
+    const gronsfeldPipeline pipeline(cipher, decrypting, settings);
+    std::string result;
+    try {
+        const filePipeline::report report = pipeline.run(fileno(in), fileno(out));
+        if (status != nullptr) {
+            *status = pipeline.status(report);
+        }
+        result.resize(static_cast<size_t>(lseek(fileno(out), 0, SEEK_END)));
+        CHECK_EQUAL(static_cast<ssize_t>(result.size()), pread(fileno(out), &result[0], result.size(), 0));
+    } catch (...) {
+        std::fclose(in);
+        std::fclose(out);
+        throw;
+    }
+    std::fclose(in);
+    std::fclose(out);
+    return result;
+}
+
+// Тестовый сценарий для фрагментов и конвейерной обработки файлов (PipelineTest)
+SUITE(PipelineTest) {
+    TEST(FragmentsMatchWholeText) {
+        std::mt19937 rng(23);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя  019,.!\n";
+        modAlphaCipher cipher(L"ФРАГМЕНТ");
+        for (int n = 0; n < 100; n++) {
+            size_t len = 1 + rng() % 2000;
+            std::wstring text = randomText(rng, alpha, len);
+            text += L'Я';
+            std::string utf8 = toUtf8(text);
+            std::string whole = cipher.encrypt(std::string_view(utf8));
+            std::string joined;
+            std::string piece(utf8.size(), '\0');
+            unsigned long long phase = 0;
+            for (size_t from = 0; from < utf8.size();) {
+                size_t to = std::min(utf8.size(), from + 1 + rng() % 64);
+                while (to < utf8.size() && (static_cast<unsigned char>(utf8[to]) & 0xC0) == 0x80) {
+                    to++;
+                }
+                std::string_view fragment(utf8.data() + from, to - from);
+                modAlphaCipher::result r = cipher.tryEncryptInto(fragment, &piece[0], piece.size(), phase);
+                joined.append(piece, 0, r ? r.size : 0);
+                phase += modAlphaCipher::letterCount(fragment);
+                from = to;
+            }
+            CHECK(joined == whole);
+            CHECK_EQUAL(cipher.decrypt(std::string_view(whole)).size() / 2, phase);
+        }
+    }
+
+    TEST(DecryptFragmentPhase) {
+        modAlphaCipher cipher(L"ФАЗА");
+        std::string whole = cipher.encrypt(std::string_view("ПРИВЕТМИР"));
+        std::string out(whole.size(), '\0');
+        // Вторая часть шифртекста начинается после пяти букв
+        modAlphaCipher::result r = cipher.tryDecryptInto(std::string_view(whole).substr(10), &out[0], out.size(), 5);
+        CHECK(r);
+        CHECK(out.substr(0, r.size) == toUtf8(L"ТМИР"));
+    }
+
+    TEST(MatchesWholeText) {
+        std::mt19937 rng(29);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя  019,.!\n";
+        modAlphaCipher cipher(L"КОНВЕЙЕР");
+        for (int n = 0; n < 40; n++) {
+            size_t len = rng() % 5000;
+            std::wstring text = L"Я" + randomText(rng, alpha, len);
+            std::string utf8 = toUtf8(text);
+            std::string cipherText = cipher.encrypt(std::string_view(utf8));
+            std::string suffix = n % 3 == 0 ? "\r\n" : n % 3 == 1 ? "\n" : "";
+            size_t blockSize = 16 + rng() % 200;
+            unsigned workers = 1 + n % 4;
+            CHECK(pipelineRun(cipher, utf8 + suffix, false, blockSize, workers) == cipherText);
+            CHECK(pipelineRun(cipher, cipherText + suffix, true, blockSize, workers) ==
+                  cipher.decrypt(std::string_view(cipherText)));
+        }
+    }
+
+    TEST(EmptyInput) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        CHECK(pipelineRun(cipher, "", false, 16, 2).empty());
+        CHECK(pipelineRun(cipher, "\n", false, 16, 2).empty());
+    }
+
+    TEST(WholeTextStatus) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        modAlphaCipher::textStatus status = modAlphaCipher::textStatus::ok;
+        pipelineRun(cipher, "", false, 16, 2, &status);
+        CHECK(status == modAlphaCipher::textStatus::emptyOpenText);
+        pipelineRun(cipher, "", true, 16, 2, &status);
+        CHECK(status == modAlphaCipher::textStatus::emptyCipherText);
+        pipelineRun(cipher, std::string(100, ' '), false, 16, 2, &status);
+        CHECK(status == modAlphaCipher::textStatus::emptyOpenText);
+        pipelineRun(cipher, std::string(50, ' ') + "hello 123" + std::string(50, ' '), false, 16, 2, &status);
+        CHECK(status == modAlphaCipher::textStatus::invalidOpenText);
+        CHECK(pipelineRun(cipher, std::string(50, ' ') + toUtf8(L"Я"), false, 16, 2, &status) ==
+              cipher.encrypt(std::string_view(toUtf8(L"Я"))));
+        CHECK(status == modAlphaCipher::textStatus::ok);
+    }
+
+    TEST(ErrorStopsPipeline) {
+        modAlphaCipher cipher(L"КЛЮЧ");
+        std::string text(100000, 'A');
+        text += toUtf8(L"ПРИВЕТ");
+        CHECK_THROW(pipelineRun(cipher, toUtf8(L"ПРИВЕТ") + text, true, 64, 3), cipher_error);
+    }
+
+    TEST(BlockSizeTooSmall) {
+        filePipeline::options settings;
+        settings.blockSize = 8;
+        CHECK_THROW(filePipeline(settings, nullptr, [](std::string_view, unsigned long long, std::string&) {}),
+                    filePipeline_error);
+    }
+}
+
 int main(int argc, char** argv) {
     return UnitTest::RunAllTests();
 }
@@ -0,0 +1,460 @@
+/**
+ * @file bench_tableCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Замер производительности табличной перестановки
+ * @details Без аргументов режима перебирает длины текста от 8 символов до
+ *          1 ГБ в UTF-8, количества столбцов (включая худший случай - ключ на
+ *          единицу меньше числа букв) и варианты интерфейса и печатает
+ *          наносекунды на символ, МБ/с, выделения памяти на вызов и
+ *          выделенные байты на символ в CSV (--json - в JSON). Прежняя реализация через таблицу строк
+ *          замеряется для сравнения как api table_reference. Режим batch
+ *          сравнивает пакетную обработку с вызовом encrypt на каждое сообщение,
+ *          режим fixed - tableCipherDispatch со специализациями для ключей
+ *          3..16 с обычным tableCipher для каждого из этих ключей, режим
+ *          search замеряет поиск количества столбцов tableAnalyzer, режим
+ *          errors - обработку потока с долей ошибочных сообщений через
+ *          encryptInto с перехватом исключений и через tryEncryptInto,
+ *          режим pipeline - обработку файла размером --max-mb целиком и
+ *          блоками через конвейер filePipeline.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "tableCipher.h"
+#include "tableCipherFixed.h"
+#include "tableAnalyzer.h"
+#include "tableBlockPipeline.h"
+#include "tablePlanCache.h"
+#include "../common/benchSuite.h"
+
+/**
+ * @brief Зашифровывание так, как его выполнял модуль до перехода на прямую перестановку
+ * @details Таблица - вектор строк, считывание идёт по столбцам, поэтому
+ *          соседние обращения попадают в разные строки таблицы.
+ * @param text Буквы открытого текста
+ * @param key Количество столбцов
+ * @return Шифртекст
+ */
+std::wstring tableEncrypt(const std::wstring& text, int key)
+{
+    int text_len = text.length();
+    int rows = (text_len + key - 1) / key;
+    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
+    int index = 0;
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < key && index < text_len; j++) {
+            table[i][j] = text[index++];
+        }
+    }
+    std::wstring result;
+    for (int j = key - 1; j >= 0; j--) {
+        for (int i = 0; i < rows; i++) {
+            if (table[i][j] != L' ')
+                result += table[i][j];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Сравнение пакетной обработки с вызовом encrypt на каждое сообщение
+ * @details Печатает наносекунды на сообщение для сообщений из 16, 256 и 4096 символов
+ */
+void runBatch()
+{
+    const std::wstring sample = L"Съешь же ещё этих мягких французских булок да выпей чаю ";
+    tableCipher cipher(7);
+
+    std::printf("chars,messages,wide_per_call_ns,utf8_per_call_ns,batch_ns,speedup\n");
+    for (size_t chars : {16, 256, 4096}) {
+        const size_t count = chars == 4096 ? 1000 : 100000 / (chars / 16);
+        std::vector<std::wstring> wide(count);
+        std::vector<std::string> utf8(count);
+        std::string text;
+        std::vector<size_t> offsets(1, 0);
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < chars; j++) {
+                wide[i] += sample[(i + j) % sample.size()];
+            }
+            utf8[i] = benchUtf8(wide[i]);
+            text += utf8[i];
+            offsets.push_back(text.size());
+        }
+
+        const int rounds = 20;
+        double wideNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::wstring& m : wide) {
+                n += cipher.encrypt(m).size();
+            }
+            return n;
+        }, count, rounds);
+        double utf8Ns = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : utf8) {
+                n += cipher.encrypt(std::string_view(m)).size();
+            }
+            return n;
+        }, count, rounds);
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<tableCipher::textStatus> status;
+        double batchNs = benchNsPerMessage([&] {
+            cipher.encryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, status);
+            return arena.size();
+        }, count, rounds);
+        std::printf("%zu,%zu,%.1f,%.1f,%.1f,%.1f\n", chars, count, wideNs, utf8Ns, batchNs, utf8Ns / batchNs);
+    }
+}
+
+/**
+ * @brief Сравнение обработки ошибочных сообщений исключениями и кодами ошибок
+ * @details Сообщения из 64 символов составляют 0, 5, 10 или 50 процентов
+ *          потока; половина ошибочных содержит цифру в конце, половина короче
+ *          ключа (сообщение этой ошибки форматируется с длиной текста).
+ *          Печатает наносекунды на сообщение для encryptInto с перехватом
+ *          tableCipher_error и для tryEncryptInto с тем же буфером.
+ */
+void runErrors()
+{
+    const std::wstring sample = L"Съешь же ещё этих мягких французских булок да выпей чаю ";
+    const size_t chars = 64;
+    tableCipher cipher(7);
+    const size_t count = 100000;
+    const int rounds = 20;
+    std::vector<char> out(2 * chars);
+
+    std::printf("malformed_percent,messages,throw_ns,try_ns,speedup\n");
+    for (size_t percent : {0, 5, 10, 50}) {
+        std::vector<std::string> messages(count);
+        size_t malformed = 0;
+        // Ошибочные сообщения распределены по потоку равномерно
+        for (size_t i = 0; i < count; i++) {
+            const bool bad = i * percent % 100 + percent >= 100;
+            const size_t length = bad && malformed++ % 2 ? 5 : chars;
+            std::wstring m;
+            for (size_t j = 0; j < length; j++) {
+                m += sample[(i + j) % sample.size()];
+            }
+            if (bad && length == chars) {
+                m.back() = L'1';
+            }
+            messages[i] = benchUtf8(m);
+        }
+
+        double throwNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                try {
+                    n += cipher.encryptInto(std::string_view(m), out.data(), out.size());
+                } catch (const tableCipher_error&) {
+                    n++;
+                }
+            }
+            return n;
+        }, count, rounds);
+        double tryNs = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                tableCipher::result r = cipher.tryEncryptInto(std::string_view(m), out.data(), out.size());
+                n += r ? r.size : 1;
+            }
+            return n;
+        }, count, rounds);
+        std::printf("%zu,%zu,%.1f,%.1f,%.2f\n", percent, count, throwNs, tryNs, throwNs / tryNs);
+    }
+}
+
+/**
+ * @brief Перебор длин текста, количеств столбцов и вариантов интерфейса
+ * @param options Параметры запуска
+ */
+void runSuite(const benchOptions& options)
+{
+    // Широкие строки занимают вдвое больше UTF-8, а таблица строк - в несколько
+    // раз больше текста, для них длина текста ограничена
+    const size_t maxWideChars = size_t(1) << 26;
+    const size_t maxTableChars = size_t(1) << 24;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    tablePlanCache cache(size_t(64) << 20);
+
+    benchReport report(options.json);
+    for (size_t chars = options.minChars; 2 * chars <= options.maxBytes; chars *= 4) {
+        size_t letters = 0;
+        const std::string text = benchText(chars, true, letters);
+        std::string cipherText(text.size(), '\0');
+        std::string out(text.size(), '\0');
+        std::wstring wide;
+        std::wstring wideLetters;
+        std::wstring wideCipher;
+        std::wstring wideOut;
+        if (chars <= maxWideChars) {
+            wide = benchWide(text);
+            wideOut.resize(wide.size());
+            wideLetters = wide;
+            wideLetters.erase(std::remove(wideLetters.begin(), wideLetters.end(), L' '), wideLetters.end());
+        }
+
+        // Худшие случаи - ключ около половины и на единицу меньше числа букв:
+        // таблица из двух-трёх строк, каждая буква попадает в свой столбец
+        std::vector<size_t> keys;
+        for (size_t key : {size_t(3), size_t(16), size_t(64), size_t(256), size_t(1024), size_t(4096),
+                           letters / 2, letters - 1}) {
+            if (key >= 3 && key < letters && std::find(keys.begin(), keys.end(), key) == keys.end()) {
+                keys.push_back(key);
+            }
+        }
+
+        for (size_t key : keys) {
+            tableCipher cipher(static_cast<int>(key));
+            tableCipher cached(static_cast<int>(key), cache);
+            cipherText.resize(cipher.encryptInto(std::string_view(text), &cipherText[0], cipherText.size()));
+
+            auto add = [&](const char* operation, const char* api, size_t n, size_t bytes, unsigned threads, auto f) {
+                report.add("table", operation, api, n, bytes, key, threads, benchMeasure(f, n, bytes));
+            };
+            add("encrypt", "utf8", chars, text.size(), 1, [&] {
+                return cipher.encrypt(std::string_view(text)).size();
+            });
+            add("encrypt", "utf8_into", chars, text.size(), 1, [&] {
+                return cipher.encryptInto(std::string_view(text), &out[0], out.size());
+            });
+            add("encrypt", "utf8_into_cached", chars, text.size(), 1, [&] {
+                return cached.encryptInto(std::string_view(text), &out[0], out.size());
+            });
+            add("decrypt", "utf8", letters, cipherText.size(), 1, [&] {
+                return cipher.decrypt(std::string_view(cipherText)).size();
+            });
+            add("decrypt", "utf8_into", letters, cipherText.size(), 1, [&] {
+                return cipher.decryptInto(std::string_view(cipherText), &out[0], out.size());
+            });
+            add("decrypt", "utf8_into_cached", letters, cipherText.size(), 1, [&] {
+                return cached.decryptInto(std::string_view(cipherText), &out[0], out.size());
+            });
+            // Многопоточный режим замеряется, только когда текста хватает на все ядра
+            if (cores > 1 && chars >= (size_t(cores) << 16)) {
+                add("encrypt", "utf8_threads", chars, text.size(), cores, [&] {
+                    return cipher.encrypt(std::string_view(text), cores).size();
+                });
+                add("decrypt", "utf8_threads", letters, cipherText.size(), cores, [&] {
+                    return cipher.decrypt(std::string_view(cipherText), cores).size();
+                });
+            }
+            if (chars > maxWideChars) {
+                continue;
+            }
+            wideCipher = cipher.encrypt(wide);
+            const size_t wideBytes = wide.size() * sizeof(wchar_t);
+            if (chars <= maxTableChars) {
+                add("encrypt", "table_reference", letters, wideLetters.size() * sizeof(wchar_t), 1, [&] {
+                    return tableEncrypt(wideLetters, static_cast<int>(key)).size();
+                });
+            }
+            add("encrypt", "wide", chars, wideBytes, 1, [&] { return cipher.encrypt(wide).size(); });
+            add("encrypt", "wide_into", chars, wideBytes, 1, [&] {
+                return cipher.encryptInto(std::wstring_view(wide), &wideOut[0], wideOut.size());
+            });
+            const size_t cipherBytes = wideCipher.size() * sizeof(wchar_t);
+            add("decrypt", "wide", letters, cipherBytes, 1, [&] { return cipher.decrypt(wideCipher).size(); });
+            add("decrypt", "wide_into", letters, cipherBytes, 1, [&] {
+                return cipher.decryptInto(std::wstring_view(wideCipher), &wideOut[0], wideOut.size());
+            });
+        }
+    }
+}
+
+/**
+ * @brief Сравнение специализаций для ключей 3..16 с обычной перестановкой
+ * @details Для каждого ключа печатает строки api utf8_into и wide_into
+ *          обычного tableCipher и строки с суффиксом _fixed для
+ *          tableCipherDispatch на текстах от 1 тысячи до 4 миллионов символов.
+ * @param options Параметры запуска
+ */
+void runFixed(const benchOptions& options)
+{
+    benchReport report(options.json);
+    for (size_t chars : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 22}) {
+        if (chars < options.minChars || 2 * chars > options.maxBytes) {
+            continue;
+        }
+        size_t letters = 0;
+        const std::string text = benchText(chars, true, letters);
+        const std::wstring wide = benchWide(text);
+        std::string cipherText(text.size(), '\0');
+        std::string out(text.size(), '\0');
+        std::wstring wideOut(wide.size(), L'\0');
+        const size_t wideBytes = wide.size() * sizeof(wchar_t);
+
+        for (int key = tableCipherDispatch::minKey; key <= tableCipherDispatch::maxKey; key++) {
+            tableCipher cipher(key);
+            tableCipherDispatch fixed(key);
+            cipherText.resize(cipher.encryptInto(std::string_view(text), &cipherText[0], cipherText.size()));
+            const std::wstring wideCipher = cipher.encrypt(wide);
+            const size_t cipherBytes = wideCipher.size() * sizeof(wchar_t);
+
+            auto add = [&](const char* operation, const char* api, size_t n, size_t bytes, auto f) {
+                report.add("table", operation, api, n, bytes, key, 1, benchMeasure(f, n, bytes));
+            };
+            add("encrypt", "utf8_into", chars, text.size(), [&] {
+                return cipher.encryptInto(std::string_view(text), &out[0], out.size());
+            });
+            add("encrypt", "utf8_into_fixed", chars, text.size(), [&] {
+                return fixed.encryptInto(std::string_view(text), &out[0], out.size());
+            });
+            add("decrypt", "utf8_into", letters, cipherText.size(), [&] {
+                return cipher.decryptInto(std::string_view(cipherText), &out[0], out.size());
+            });
+            add("decrypt", "utf8_into_fixed", letters, cipherText.size(), [&] {
+                return fixed.decryptInto(std::string_view(cipherText), &out[0], out.size());
+            });
+            add("encrypt", "wide_into", chars, wideBytes, [&] {
+                return cipher.encryptInto(std::wstring_view(wide), &wideOut[0], wideOut.size());
+            });
+            add("encrypt", "wide_into_fixed", chars, wideBytes, [&] {
+                return fixed.encryptInto(std::wstring_view(wide), &wideOut[0], wideOut.size());
+            });
+            add("decrypt", "wide_into", letters, cipherBytes, [&] {
+                return cipher.decryptInto(std::wstring_view(wideCipher), &wideOut[0], wideOut.size());
+            });
+            add("decrypt", "wide_into_fixed", letters, cipherBytes, [&] {
+                return fixed.decryptInto(std::wstring_view(wideCipher), &wideOut[0], wideOut.size());
+            });
+        }
+    }
+}
+
+/**
+ * @brief Замер поиска количества столбцов
+ * @details Для текстов от 64 тысяч до 16 миллионов букв печатает время
+ *          разбора шифртекста (api parse) и поиска пяти лучших ключей из
+ *          всех 3..n-1 (api search) на всех ядрах.
+ * @param options Параметры запуска
+ */
+void runSearch(const benchOptions& options)
+{
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    benchReport report(options.json);
+    for (size_t chars : {size_t(1) << 16, size_t(1) << 20, size_t(1) << 24}) {
+        if (chars < options.minChars || 2 * chars > options.maxBytes) {
+            continue;
+        }
+        size_t letters = 0;
+        const std::string text = benchText(chars, false, letters);
+        const int key = static_cast<int>(letters / 7);
+        const std::string cipherText = tableCipher(key).encrypt(std::string_view(text));
+        tableAnalyzer analyzer{std::string_view(cipherText)};
+
+        report.add("table", "search", "parse", letters, cipherText.size(), key, 1, benchMeasure([&] {
+            return tableAnalyzer(std::string_view(cipherText)).length();
+        }, letters, cipherText.size()));
+        report.add("table", "search", "search", letters, cipherText.size(), key, cores, benchMeasure([&] {
+            return analyzer.search(5, cores).size();
+        }, letters, cipherText.size()));
+    }
+}
+
+/**
+ * @brief Сравнение обработки файла целиком с конвейером
+ * @details Создаёт во временном каталоге (TMPDIR или /tmp) файл размером
+ *          --max-mb, зашифровывает его одной таблицей через отображение в
+ *          память, как файловый режим программы, и блоками через конвейер с
+ *          1, 2, 4 рабочими потоками и по числу ядер, затем расшифровывает
+ *          каждый шифртекст своим способом. Расшифрованные тексты обоих
+ *          способов должны иметь одинаковый размер. Для замера на нескольких
+ *          гигабайтах задаётся, например, --max-mb 4096.
+ * @param options Параметры запуска
+ * @return 0 при успешном выполнении, 1 при ошибке файлов или расхождении размеров результата
+ */
+int runPipeline(const benchOptions& options)
+{
+    const char* dir = std::getenv("TMPDIR") != nullptr ? std::getenv("TMPDIR") : "/tmp";
+    const std::string input = std::string(dir) + "/bench_table_in.txt";
+    const std::string whole = std::string(dir) + "/bench_table_whole.txt";
+    const std::string blocks = std::string(dir) + "/bench_table_blocks.txt";
+    const std::string output = std::string(dir) + "/bench_table_out.txt";
+    if (!benchWriteFile(input.c_str(), options.maxBytes)) {
+        std::fprintf(stderr, "Не удалось создать %s\n", input.c_str());
+        return 1;
+    }
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> workers = {1, 2, 4, cores};
+    std::sort(workers.begin(), workers.end());
+    workers.erase(std::unique(workers.begin(), workers.end()), workers.end());
+
+    const tableCipher cipher(7);
+    int code = 0;
+    std::printf("module,operation,api,workers,bytes,seconds,mb_per_s,read_s,transform_s,write_s\n");
+    try {
+        for (bool decrypting : {false, true}) {
+            const char* operation = decrypting ? "decrypt" : "encrypt";
+            const filePipeline::report mapped = benchMapped((decrypting ? whole : input).c_str(),
+                                                            (decrypting ? output : whole).c_str(),
+                [&](std::string_view text, char* out, size_t capacity) {
+                    return decrypting ? cipher.decryptInto(text, out, capacity)
+                                      : cipher.encryptInto(text, out, capacity);
+                });
+            benchFileRow("table", operation, "mapped", 1, mapped);
+            for (unsigned n : workers) {
+                filePipeline::options settings;
+                settings.workers = n;
+                const filePipeline::report r = benchPipeline(tableBlockPipeline(cipher, decrypting, settings),
+                                                             (decrypting ? blocks : input).c_str(),
+                                                             (decrypting ? output : blocks).c_str());
+                benchFileRow("table", operation, "pipeline", n, r);
+                if (decrypting && r.bytesOut != mapped.bytesOut) {
+                    std::fprintf(stderr, "Размер результата конвейера %llu, ожидался %llu\n", r.bytesOut,
+                                 mapped.bytesOut);
+                    code = 1;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Ошибка: %s\n", e.what());
+        code = 1;
+    }
+    for (const std::string* path : {&input, &whole, &blocks, &output}) {
+        unlink(path->c_str());
+    }
+    return code;
+}
+
+/**
+ * @brief Главная функция программы
+ * @param argc Количество аргументов
+ * @param argv Аргументы: [batch|fixed|search|errors|pipeline] [--json|--csv] [--max-mb N] [--min-chars N]
+ * @return 0 при успешном выполнении, 1 при неверных аргументах или ошибке файлов
+ */
+int main(int argc, char** argv)
+{
+    benchOptions options;
+    const bool parsed = options.parse(argc, argv);
+    const std::string mode = options.mode != nullptr ? options.mode : "";
+    if (!parsed || (!mode.empty() && mode != "batch" && mode != "fixed" && mode != "search" && mode != "errors"
+                    && mode != "pipeline")) {
+        std::fprintf(stderr, "Использование: %s [batch|fixed|search|errors|pipeline] [--json|--csv] [--max-mb N] [--min-chars N]\n", argv[0]);
+        return 1;
+    }
+    if (mode == "batch") {
+        runBatch();
+    } else if (mode == "fixed") {
+        runFixed(options);
+    } else if (mode == "search") {
+        runSearch(options);
+    } else if (mode == "errors") {
+        runErrors();
+    } else if (mode == "pipeline") {
+        return runPipeline(options);
+    } else {
+        runSuite(options);
+    }
+    return 0;
+}
@@ -12,7 +12,20 @@
 #include <limits>
 #include <locale>
 #include <codecvt>
+#include <charconv>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "tableCipher.h"
+#include "tableAnalyzer.h"
+#include "tableBlockPipeline.h"
+#include "../common/filePipeline.h"
 
 using namespace std;
 
@@ -60,11 +73,285 @@ wstring getText(const wstring& prompt) {
     return text;
 }
 
+/**
+ * @brief Отображение файла в память
+ */
+struct mappedFile {
+    int fd = -1; ///< Дескриптор файла
+    char* data = nullptr; ///< Начало отображения
+    size_t size = 0; ///< Размер отображения в байтах
+
+    /**
+     * @brief Снятие отображения и закрытие файла
+     */
+    ~mappedFile() {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+/**
+ * @brief Сообщение о системной ошибке
+ * @param what Описание действия
+ * @param path Имя файла
+ * @return 1 - код завершения программы
+ */
+int systemError(const char* what, const char* path) {
+    std::fprintf(stderr, "Ошибка: %s %s: %s\n", what, path, std::strerror(errno));
+    return 1;
+}
+
+/**
+ * @brief Шифрование файла без диалога
+ * @details Входной файл отображается в память только для чтения, выходной
+ *          создаётся размером со входной, отображается в память и после
+ *          записи усекается до размера результата. Текст остаётся в UTF-8 и
+ *          не копируется, кроме буфера полосы таблицы, поэтому память
+ *          программы не зависит от размера файла. Завершающий перевод
+ *          строки входного файла не считается частью сообщения.
+ * @param key Ключ (количество столбцов)
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @param inputPath Имя входного файла
+ * @param outputPath Имя выходного файла
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runFileMode(int key, bool decrypting, const char* inputPath, const char* outputPath) {
+    const auto start = std::chrono::steady_clock::now();
+
+    mappedFile in;
+    in.fd = open(inputPath, O_RDONLY);
+    if (in.fd < 0) {
+        return systemError("не удалось открыть", inputPath);
+    }
+    struct stat st;
+    if (fstat(in.fd, &st) != 0) {
+        return systemError("не удалось получить размер", inputPath);
+    }
+    in.size = static_cast<size_t>(st.st_size);
+    if (in.size > 0) {
+        void* p = mmap(nullptr, in.size, PROT_READ, MAP_PRIVATE, in.fd, 0);
+        if (p == MAP_FAILED) {
+            in.size = 0;
+            return systemError("не удалось отобразить в память", inputPath);
+        }
+        in.data = static_cast<char*>(p);
+        // При зашифровывании текст читается подряд, при расшифровывании -
+        // отрезками из всех столбцов сразу
+        madvise(in.data, in.size, decrypting ? MADV_NORMAL : MADV_SEQUENTIAL);
+    }
+
+    std::string_view text(in.data, in.size);
+    if (!text.empty() && text.back() == '\n') {
+        text.remove_suffix(1);
+        if (!text.empty() && text.back() == '\r') {
+            text.remove_suffix(1);
+        }
+    }
+
+    mappedFile out;
+    out.fd = open(outputPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out.fd < 0) {
+        return systemError("не удалось создать", outputPath);
+    }
+    // Каждая буква занимает во входном тексте не меньше двух байтов,
+    // а в результате ровно два, поэтому результат не длиннее входа
+    out.size = text.size();
+    if (out.size > 0) {
+        if (ftruncate(out.fd, static_cast<off_t>(out.size)) != 0) {
+            out.size = 0;
+            return systemError("не удалось выделить место для", outputPath);
+        }
+        void* p = mmap(nullptr, out.size, PROT_READ | PROT_WRITE, MAP_SHARED, out.fd, 0);
+        if (p == MAP_FAILED) {
+            out.size = 0;
+            return systemError("не удалось отобразить в память", outputPath);
+        }
+        out.data = static_cast<char*>(p);
+    }
+
+    size_t written = 0;
+    try {
+        tableCipher cipher(key);
+        written = decrypting ? cipher.decryptInto(text, out.data, out.size)
+                             : cipher.encryptInto(text, out.data, out.size);
+    } catch (const tableCipher_error& e) {
+        std::fprintf(stderr, "Ошибка %s: %s\n", decrypting ? "расшифрования" : "шифрования", e.what());
+        unlink(outputPath);
+        return 1;
+    }
+
+    munmap(out.data, out.size);
+    out.data = nullptr;
+    if (ftruncate(out.fd, static_cast<off_t>(written)) != 0) {
+        return systemError("не удалось усечь", outputPath);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "Обработано %zu байт за %.3f с: %.1f МБ/с\n",
+                 in.size, seconds, seconds > 0 ? in.size / seconds / (1 << 20) : 0.0);
+    return 0;
+}
+
+/**
+ * @brief Поблочное шифрование файла конвейером
+ * @details Каждый блок filePipeline шифруется как отдельное сообщение и
+ *          записывается отдельной строкой, поэтому таблица не охватывает весь
+ *          файл и блоки переставляются параллельно. При расшифровывании файл
+ *          делится на блоки по строкам и строки расшифровываются по одной;
+ *          результат - открытые тексты блоков подряд, без переводов строк.
+ *          В каждом блоке должно быть больше букв, чем столбцов; остаток
+ *          файла короче половины блока присоединяется к последнему блоку.
+ * @param key Количество столбцов
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @param inputPath Имя входного файла
+ * @param outputPath Имя выходного файла; при ошибке удаляется
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runBlockMode(int key, bool decrypting, const char* inputPath, const char* outputPath) {
+    const int in = open(inputPath, O_RDONLY);
+    if (in < 0) {
+        return systemError("не удалось открыть", inputPath);
+    }
+    const int out = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        close(in);
+        return systemError("не удалось создать", outputPath);
+    }
+
+    const tableCipher cipher(key);
+    const tableBlockPipeline pipeline(cipher, decrypting);
+
+    int code = 0;
+    try {
+        const filePipeline::report report = pipeline.run(in, out);
+        std::fprintf(stderr, "Обработано %llu байт за %.3f с: %.1f МБ/с (чтение %.3f с, шифрование %.3f с, "
+                             "запись %.3f с)\n", report.bytesIn, report.seconds,
+                     report.seconds > 0 ? report.bytesIn / report.seconds / (1 << 20) : 0.0,
+                     report.readSeconds, report.transformSeconds, report.writeSeconds);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Ошибка %s: %s\n", decrypting ? "расшифрования" : "шифрования", e.what());
+        code = 1;
+    }
+    close(in);
+    if (close(out) != 0 && code == 0) {
+        code = systemError("не удалось записать", outputPath);
+    }
+    if (code != 0) {
+        unlink(outputPath);
+    }
+    return code;
+}
+
+/**
+ * @brief Поиск количества столбцов по шифртексту из файла
+ * @details Файл отображается в память, как в runFileMode; завершающий
+ *          перевод строки пропускается. Выводится по строке на ключ: ключ и
+ *          оценка через табуляцию.
+ * @param inputPath Имя файла с шифртекстом в UTF-8
+ * @param count Количество ключей в ответе
+ * @return 0 при успешном выполнении, 1 при ошибке
+ */
+int runSearchMode(const char* inputPath, size_t count) {
+    mappedFile in;
+    in.fd = open(inputPath, O_RDONLY);
+    if (in.fd < 0) {
+        return systemError("не удалось открыть", inputPath);
+    }
+    struct stat st;
+    if (fstat(in.fd, &st) != 0) {
+        return systemError("не удалось получить размер", inputPath);
+    }
+    in.size = static_cast<size_t>(st.st_size);
+    if (in.size > 0) {
+        void* p = mmap(nullptr, in.size, PROT_READ, MAP_PRIVATE, in.fd, 0);
+        if (p == MAP_FAILED) {
+            in.size = 0;
+            return systemError("не удалось отобразить в память", inputPath);
+        }
+        in.data = static_cast<char*>(p);
+    }
+
+    std::string_view text(in.data, in.size);
+    if (!text.empty() && text.back() == '\n') {
+        text.remove_suffix(1);
+        if (!text.empty() && text.back() == '\r') {
+            text.remove_suffix(1);
+        }
+    }
+    try {
+        tableAnalyzer analyzer(text);
+        for (const tableAnalyzer::candidate& c : analyzer.search(count)) {
+            std::printf("%d\t%.4f\n", c.key, c.score);
+        }
+    } catch (const tableCipher_error& e) {
+        std::fprintf(stderr, "Ошибка поиска: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief Главная функция программы
+ * @details Без аргументов работает в диалоговом режиме. С аргументами
+ *          <ключ> <encrypt|decrypt> <входной файл> <выходной файл> [--stats]
+ *          шифрует файл без диалога (с --stats выводит в stderr счётчики
+ *          шифра в JSON, ненулевые при сборке с -DCIPHER_STATS), режимы
+ *          encrypt-blocks и decrypt-blocks шифруют файл поблочно конвейером,
+ *          с аргументами search <файл> [N] ищет N (по умолчанию 5) вероятных
+ *          ключей шифртекста из файла.
+ * @param argc Количество аргументов
+ * @param argv Аргументы командной строки
  * @return 0 при успешном выполнении, 1 при ошибке
  */
-int main() {
+int main(int argc, char** argv) {
+    if ((argc == 3 || argc == 4) && std::strcmp(argv[1], "search") == 0) {
+        const long count = argc == 4 ? std::strtol(argv[3], nullptr, 10) : 5;
+        if (count <= 0) {
+            std::fprintf(stderr, "Использование: %s search <файл шифртекста> [количество ключей]\n", argv[0]);
+            return 1;
+        }
+        return runSearchMode(argv[2], static_cast<size_t>(count));
+    }
+    if (argc > 1) {
+        const bool stats = argc == 6 && std::strcmp(argv[5], "--stats") == 0;
+        const bool fileMode = argc == 5 || stats;
+        const std::string mode = fileMode ? argv[2] : "";
+        if (!fileMode
+                || (mode != "encrypt" && mode != "decrypt" && mode != "encrypt-blocks" && mode != "decrypt-blocks")) {
+            std::fprintf(stderr, "Использование: %s <ключ> <encrypt|decrypt> <входной файл> <выходной файл> [--stats]\n"
+                                 "       %s <ключ> <encrypt-blocks|decrypt-blocks> <входной файл> <выходной файл> [--stats]\n"
+                                 "       %s search <файл шифртекста> [количество ключей]\n", argv[0], argv[0], argv[0]);
+            return 1;
+        }
+        // Ключ разбирается прямо в int: значение вне диапазона int - ошибка, а не усечение
+        int key = 0;
+        const char* keyEnd = argv[1] + std::strlen(argv[1]);
+        const std::from_chars_result parsed = std::from_chars(argv[1], keyEnd, key);
+        if (parsed.ec != std::errc() || parsed.ptr != keyEnd || parsed.ptr == argv[1]) {
+            std::fprintf(stderr, "Ошибка: ключ должен быть целым числом от %d до %d: %s\n",
+                         std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), argv[1]);
+            return 1;
+        }
+        try {
+            tableCipher probe(key);
+        } catch (const tableCipher_error& e) {
+            std::fprintf(stderr, "Ошибка создания шифратора: %s\n", e.what());
+            return 1;
+        }
+        const bool blocks = mode == "encrypt-blocks" || mode == "decrypt-blocks";
+        const bool decrypting = mode == "decrypt" || mode == "decrypt-blocks";
+        const int status = blocks ? runBlockMode(key, decrypting, argv[3], argv[4])
+                                  : runFileMode(key, decrypting, argv[3], argv[4]);
+        if (stats) {
+            std::fprintf(stderr, "%s\n", tableCipher::statsSnapshot().toJson("table").c_str());
+        }
+        return status;
+    }
+
     // Устанавливаем локаль для корректного отображения русских символов
     setlocale(LC_ALL, "ru_RU.UTF-8");
     locale loc("ru_RU.UTF-8");
@@ -0,0 +1,323 @@
+/**
+ * @file tableAnalyzer.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация модуля поиска ключа табличной перестановки
+ */
+
+#include "tableAnalyzer.h"
+#include "tableCipher.h"
+#include "../common/russianText.h"
+#include "../common/parallelTasks.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Текст для обучения модели биграмм по умолчанию
+ * @details Обычная русская проза; знаки препинания и пробелы при обучении
+ *          пропускаются, как их пропускает шифр.
+ */
+const wchar_t defaultCorpus[] =
+    L"Когда поезд остановился на маленькой станции, уже совсем стемнело. Мы вышли "
+    L"на платформу, и холодный ветер сразу забрался под пальто. Вокзал был закрыт, "
+    L"только в окне дежурного горела лампа, а за окном сидел пожилой человек в "
+    L"фуражке и пил чай из стакана в подстаканнике. Он долго не мог понять, что нам "
+    L"нужно, потом надел очки, посмотрел расписание и сказал, что автобус в село "
+    L"пойдёт только утром. Переночевать можно было у его сестры, которая жила в "
+    L"соседнем доме и сдавала комнату приезжим. Мы поблагодарили его и пошли по "
+    L"тёмной улице, стараясь не наступать в лужи. Дом оказался большим, деревянным, "
+    L"с резными наличниками и высоким крыльцом. Хозяйка встретила нас приветливо, "
+    L"накормила горячей картошкой с грибами и постелила на широкой лавке у печки. "
+    L"Утром нас разбудил петух, а за окном уже светило солнце и блестел иней на траве. "
+    L"Город, в котором я вырос, стоит на берегу большой реки. Летом по ней ходят "
+    L"пароходы и баржи, а зимой река замерзает, и рыбаки целыми днями сидят у лунок. "
+    L"В центре города есть старая крепость с толстыми стенами и башнями, откуда "
+    L"видно всю округу. Когда-то здесь проходила граница государства, и крепость "
+    L"защищала жителей от набегов. Теперь в ней находится музей, и школьников "
+    L"приводят сюда на экскурсии. Экскурсовод рассказывает о том, как строили стены, "
+    L"сколько лет длилась осада и кто из героев прославился в сражениях. Дети "
+    L"слушают внимательно, потом поднимаются на башню и долго смотрят на реку, на "
+    L"крыши домов и на дальний лес, который тянется до самого горизонта. "
+    L"Наука о числах возникла очень давно. Ещё древние купцы должны были считать "
+    L"товары и деньги, а строители измерять землю и рассчитывать размеры зданий. "
+    L"Постепенно из этих простых задач выросла математика, которая сегодня помогает "
+    L"решать самые сложные вопросы. Без неё невозможно представить ни физику, ни "
+    L"химию, ни современную технику. Каждый компьютер выполняет миллионы действий в "
+    L"секунду, и все они основаны на правилах, открытых учёными много веков назад. "
+    L"Чтобы научиться хорошо решать задачи, нужно много заниматься, не бояться "
+    L"ошибок и всегда проверять свои рассуждения. Учитель говорил нам, что главное "
+    L"в математике не память, а умение думать и находить связь между разными "
+    L"явлениями. Тот, кто привык рассуждать последовательно, справится с любой "
+    L"работой, будь то инженерное дело, медицина или управление предприятием. "
+    L"В субботу вся семья собралась на даче. Отец с утра чинил забор, мать "
+    L"пропалывала грядки, а бабушка варила варенье из крыжовника. Младший брат "
+    L"бегал по саду с собакой и мешал всем работать, поэтому его отправили за водой "
+    L"к колодцу. К обеду пришли соседи, принесли свежий хлеб и рыбу, которую они "
+    L"поймали на озере. Стол поставили прямо под яблоней, и обед затянулся до вечера. "
+    L"Говорили о погоде, о ценах на рынке, о новой дороге, которую обещали "
+    L"построить к осени. Когда стемнело, зажгли фонарь, и дед начал рассказывать, "
+    L"как в молодости служил на границе и однажды заблудился в тайге. Все слушали "
+    L"его, затаив дыхание, хотя эту историю знали почти наизусть. Поздно ночью "
+    L"гости разошлись, а мы ещё долго сидели на крыльце и смотрели на звёзды.";
+
+/**
+ * @brief Выбрасывание исключения для результата проверки текста
+ * @param status Результат проверки, не ok
+ * @throw tableCipher_error Всегда
+ */
+[[noreturn]] void throwText(tableCipher::textStatus status)
+{
+    throw tableCipher_error(tableCipher::statusMessage(status));
+}
+
+/**
+ * @brief Сравнение кандидатов: лучший - с большей оценкой, при равенстве - с меньшим ключом
+ */
+bool better(const tableAnalyzer::candidate& a, const tableAnalyzer::candidate& b)
+{
+    return a.score != b.score ? a.score > b.score : a.key < b.key;
+}
+
+}
+
+/**
+ * @brief Конструктор с разбором шифртекста
+ * @details Модель биграмм обучается на встроенном тексте.
+ * @param cipher_text Шифртекст
+ * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+ */
+tableAnalyzer::tableAnalyzer(const std::wstring& cipher_text)
+{
+    if (cipher_text.empty()) {
+        throwText(tableCipher::textStatus::emptyText);
+    }
+    letters.reserve(cipher_text.size());
+    for (wchar_t c : cipher_text) {
+        if (c == L' ') {
+            continue;
+        }
+        int index = russianText::letterIndex(static_cast<char32_t>(c));
+        if (index < 0) {
+            throwText(tableCipher::textStatus::invalidText);
+        }
+        letters.push_back(static_cast<unsigned char>(index));
+    }
+    if (letters.empty()) {
+        throwText(tableCipher::textStatus::onlySpaces);
+    }
+    train(defaultCorpus);
+}
+
+/**
+ * @brief Конструктор с разбором шифртекста в кодировке UTF-8
+ * @details Модель биграмм обучается на встроенном тексте.
+ * @param cipher_text Шифртекст в UTF-8
+ * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+ */
+tableAnalyzer::tableAnalyzer(std::string_view cipher_text)
+{
+    if (cipher_text.empty()) {
+        throwText(tableCipher::textStatus::emptyText);
+    }
+    letters.reserve(cipher_text.size() / 2);
+    const char* end = cipher_text.data() + cipher_text.size();
+    for (const char* p = cipher_text.data(); p != end;) {
+        char32_t c = russianText::decodeUtf8(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        int index = russianText::letterIndex(c);
+        if (index < 0) {
+            throwText(tableCipher::textStatus::invalidText);
+        }
+        letters.push_back(static_cast<unsigned char>(index));
+    }
+    if (letters.empty()) {
+        throwText(tableCipher::textStatus::onlySpaces);
+    }
+    train(defaultCorpus);
+}
+
+/**
+ * @brief Обучение модели биграмм на своём тексте
+ * @details Вероятность биграммы - частота пары, делённая на сумму частот
+ *          пар с той же первой буквой; все частоты начинаются с единицы.
+ * @param corpus Русский текст
+ */
+void tableAnalyzer::train(std::wstring_view corpus)
+{
+    std::vector<double> counts(alphaSize * alphaSize, 1.0);
+    int previous = -1;
+    for (wchar_t c : corpus) {
+        int index = russianText::letterIndex(static_cast<char32_t>(c));
+        if (index < 0) {
+            continue;
+        }
+        if (previous >= 0) {
+            counts[previous * alphaSize + index] += 1;
+        }
+        previous = index;
+    }
+    logProb.assign(alphaSize * alphaSize, 0);
+    for (int a = 0; a < alphaSize; a++) {
+        double total = 0;
+        for (int b = 0; b < alphaSize; b++) {
+            total += counts[a * alphaSize + b];
+        }
+        for (int b = 0; b < alphaSize; b++) {
+            logProb[a * alphaSize + b] = static_cast<float>(std::log(counts[a * alphaSize + b] / total));
+        }
+    }
+}
+
+/**
+ * @brief Средняя оценка выборки пар с заданным шагом
+ * @details Берётся не больше sampleCount пар, равномерно по всему тексту
+ * @param lag Расстояние в шифртексте от второй буквы биграммы до первой
+ * @return Средний логарифм вероятности или очень малое число при lag = 0
+ */
+double tableAnalyzer::lagEstimate(size_t lag) const
+{
+    const size_t n = letters.size();
+    if (lag == 0 || lag >= n) {
+        return -HUGE_VAL;
+    }
+    const size_t pairs = n - lag;
+    const size_t samples = std::min(pairs, sampleCount);
+    double sum = 0;
+    for (size_t i = 0; i < samples; i++) {
+        const size_t y = i * pairs / samples;
+        sum += logProb[letters[y + lag] * alphaSize + letters[y]];
+    }
+    return sum / samples;
+}
+
+/**
+ * @brief Точная оценка всех ключей группы
+ * @details Один проход по шифртексту накапливает сумму с шагом rows и
+ *          разность сумм с шагами rows - 1 и rows; граница B(k) растёт с
+ *          ключом, поэтому оценки ключей снимаются по ходу прохода.
+ * @param g Группа
+ * @param count Количество лучших ключей группы в ответе
+ * @return Не более count лучших ключей группы
+ */
+std::vector<tableAnalyzer::candidate> tableAnalyzer::exactScores(const group& g, size_t count) const
+{
+    const size_t n = letters.size();
+    const size_t rows = g.rows;
+    const size_t pairs = n - rows;
+    const unsigned char* c = letters.data();
+    const float* lp = logProb.data();
+
+    // Слагаемое с шагом rows по всему тексту у ключей группы общее, поэтому
+    // ключи отбираются по разности до границы, а оно прибавляется в конце
+    std::vector<candidate> best;
+    auto keep = [&](size_t key, double sum) {
+        candidate next{static_cast<int>(key), sum};
+        if (best.size() < count) {
+            best.push_back(next);
+            std::push_heap(best.begin(), best.end(), better);
+        } else if (better(next, best.front())) {
+            std::pop_heap(best.begin(), best.end(), better);
+            best.back() = next;
+            std::push_heap(best.begin(), best.end(), better);
+        }
+    };
+
+    double shortMinusFull = 0;
+    double full = 0;
+    size_t key = g.first;
+    for (size_t y = 0; y < pairs; y++) {
+        while (key <= g.last && (rows * key - n) * (rows - 1) == y) {
+            keep(key++, shortMinusFull);
+        }
+        const float a = lp[c[y + rows - 1] * alphaSize + c[y]];
+        const float b = lp[c[y + rows] * alphaSize + c[y]];
+        shortMinusFull += a - b;
+        full += b;
+    }
+    for (; key <= g.last; key++) {
+        keep(key, shortMinusFull);
+    }
+    for (candidate& k : best) {
+        k.score = pairs != 0 ? (k.score + full) / pairs : 0;
+    }
+    std::sort(best.begin(), best.end(), better);
+    return best;
+}
+
+/**
+ * @brief Оценка одного ключа
+ * @details Ключ оценивается как единственный ключ своей группы.
+ * @param key Количество столбцов, от 3 до длины текста минус 1
+ * @return Средний логарифм вероятности биграмм строк расшифрованного текста
+ * @throw tableCipher_error Если ключ невалиден или не меньше длины текста
+ */
+double tableAnalyzer::score(int key) const
+{
+    tableCipher::validateKey(key);
+    if (letters.size() <= static_cast<size_t>(key)) {
+        throw tableCipher_error(tableCipher::lengthMessage(letters.size(), key, "decryption"));
+    }
+    const size_t k = static_cast<size_t>(key);
+    const group g{(letters.size() + k - 1) / k, k, k, 0};
+    return exactScores(g, 1).front().score;
+}
+
+/**
+ * @brief Поиск лучших ключей
+ * @details Ключи делятся на группы с одинаковым количеством строк, группы
+ *          грубо оцениваются по выборке, затем лучшие группы оцениваются
+ *          точно. Группы распределяются между потоками по одной.
+ * @param count Количество ключей в ответе
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Ключи по убыванию оценки, не более count; пустой, если текст короче 4 букв
+ */
+std::vector<tableAnalyzer::candidate> tableAnalyzer::search(size_t count, unsigned threads) const
+{
+    const size_t n = letters.size();
+    if (n < 4 || count == 0) {
+        return {};
+    }
+
+    // Ключи с одинаковым количеством строк: ceil(n / k) = rows при k <= (n - 1) / (rows - 1)
+    std::vector<group> groups;
+    for (size_t k = 3; k <= n - 1;) {
+        const size_t rows = (n + k - 1) / k;
+        const size_t last = std::min(n - 1, (n - 1) / (rows - 1));
+        groups.push_back({rows, k, last, 0});
+        k = last + 1;
+    }
+
+    std::atomic<size_t> next{0};
+    parallelTasks::run(parallelTasks::threadCount(threads, groups.size()), [&](unsigned) {
+        for (size_t i = next++; i < groups.size(); i = next++) {
+            groups[i].estimate = std::max(lagEstimate(groups[i].rows - 1), lagEstimate(groups[i].rows));
+        }
+    });
+    const size_t chosen = std::min(groups.size(), std::max(count, minGroups));
+    std::partial_sort(groups.begin(), groups.begin() + chosen, groups.end(),
+                      [](const group& a, const group& b) { return a.estimate > b.estimate; });
+
+    std::vector<std::vector<candidate>> scored(chosen);
+    next = 0;
+    parallelTasks::run(parallelTasks::threadCount(threads, chosen), [&](unsigned) {
+        for (size_t i = next++; i < chosen; i = next++) {
+            scored[i] = exactScores(groups[i], count);
+        }
+    });
+    std::vector<candidate> result;
+    for (const std::vector<candidate>& s : scored) {
+        result.insert(result.end(), s.begin(), s.end());
+    }
+    std::sort(result.begin(), result.end(), better);
+    if (result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file tableAnalyzer.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для модуля поиска ключа табличной перестановки
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Поиск количества столбцов по шифртексту табличной перестановки
+ * @details Кандидат оценивается средним логарифмом вероятности биграмм
+ *          открытого текста, который получился бы при расшифровывании с этим
+ *          ключом. Открытый текст не строится: при ключе k соседние буквы
+ *          строки таблицы стоят в шифртексте на расстоянии высоты столбца,
+ *          то есть rows или rows - 1, где rows = ceil(n / k). Первые
+ *          B = (k - full) * (rows - 1) позиций шифртекста принадлежат коротким
+ *          столбцам, остальные - полным, поэтому сумма по всем биграммам равна
+ *          сумме с шагом rows - 1 до B и с шагом rows после B.
+ *
+ *          Поиск идёт в два этапа. Ключи 3..n-1 разбиваются на группы с
+ *          одинаковым rows (их около 2 * sqrt(n)), и каждая группа грубо
+ *          оценивается по выборке пар с шагами rows - 1 и rows. Для лучших
+ *          групп один проход по шифртексту даёт точную оценку сразу всех ключей
+ *          группы. Группы обрабатываются параллельно.
+ *
+ *          Модель биграмм обучается на встроенном русском тексте или на
+ *          тексте, переданном в train.
+ */
+class tableAnalyzer
+{
+public:
+    /**
+     * @brief Кандидат ключа
+     */
+    struct candidate {
+        int key; ///< Количество столбцов
+        double score; ///< Средний натуральный логарифм вероятности биграммы, чем больше, тем вероятнее
+    };
+
+    static constexpr size_t sampleCount = 4096; ///< Количество пар в выборке грубой оценки группы
+    static constexpr size_t minGroups = 8; ///< Наименьшее количество групп для точной оценки
+
+private:
+    static constexpr int alphaSize = 33; ///< Количество букв алфавита
+
+    /**
+     * @brief Ключи с одинаковым количеством строк таблицы
+     */
+    struct group {
+        size_t rows; ///< Количество строк таблицы
+        size_t first; ///< Наименьший ключ группы
+        size_t last; ///< Наибольший ключ группы
+        double estimate; ///< Грубая оценка по выборке
+    };
+
+    std::vector<unsigned char> letters; ///< Номера букв шифртекста
+    std::vector<float> logProb; ///< Логарифм P(вторая | первая) по [первая * 33 + вторая]
+
+    /**
+     * @brief Средняя оценка выборки пар с заданным шагом
+     * @param lag Расстояние в шифртексте от второй буквы биграммы до первой
+     * @return Средний логарифм вероятности или очень малое число при lag = 0
+     */
+    double lagEstimate(size_t lag) const;
+
+    /**
+     * @brief Точная оценка всех ключей группы
+     * @param g Группа
+     * @param count Количество лучших ключей группы в ответе
+     * @return Не более count лучших ключей группы
+     */
+    std::vector<candidate> exactScores(const group& g, size_t count) const;
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    tableAnalyzer() = delete;
+
+    /**
+     * @brief Конструктор с разбором шифртекста
+     * @details Текст проверяется так же, как в tableCipher: допускаются русские
+     *          буквы любого регистра и пробелы, пробелы пропускаются.
+     * @param cipher_text Шифртекст
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+     */
+    explicit tableAnalyzer(const std::wstring& cipher_text);
+
+    /**
+     * @brief Конструктор с разбором шифртекста в кодировке UTF-8
+     * @param cipher_text Шифртекст в UTF-8
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+     */
+    explicit tableAnalyzer(std::string_view cipher_text);
+
+    /**
+     * @brief Обучение модели биграмм на своём тексте
+     * @details Символы, кроме русских букв, пропускаются; к счётчикам
+     *          прибавляется единица, чтобы у невстреченных биграмм была
+     *          ненулевая вероятность.
+     * @param corpus Русский текст
+     */
+    void train(std::wstring_view corpus);
+
+    /**
+     * @brief Количество букв шифртекста
+     * @return Длина шифртекста в буквах
+     */
+    size_t length() const { return letters.size(); }
+
+    /**
+     * @brief Оценка одного ключа
+     * @param key Количество столбцов, от 3 до длины текста минус 1
+     * @return Средний логарифм вероятности биграмм строк расшифрованного текста
+     * @throw tableCipher_error Если ключ невалиден или не меньше длины текста
+     */
+    double score(int key) const;
+
+    /**
+     * @brief Поиск лучших ключей
+     * @details Точно оцениваются ключи из count (но не меньше minGroups)
+     *          групп с лучшей грубой оценкой; ключи остальных групп в ответ
+     *          не попадают.
+     * @param count Количество ключей в ответе
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Ключи по убыванию оценки, не более count; пустой, если текст короче 4 букв
+     */
+    std::vector<candidate> search(size_t count, unsigned threads = 0) const;
+};
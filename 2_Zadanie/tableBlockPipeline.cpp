@@ -0,0 +1,70 @@
+/**
+ * @file tableBlockPipeline.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация блочной обработки файлов табличной перестановкой
+ */
+
+#include "tableBlockPipeline.h"
+
+namespace {
+
+/**
+ * @brief Способ деления входа на блоки для направления
+ * @param settings Параметры конвейера
+ * @param decrypting true - расшифровывание, false - зашифровывание
+ * @return Параметры с делением по строкам при расшифровывании
+ */
+filePipeline::options framedFor(filePipeline::options settings, bool decrypting)
+{
+    settings.cut = decrypting ? filePipeline::framing::lines : filePipeline::framing::utf8;
+    return settings;
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор конвейера шифра
+ * @param cipher Шифр
+ * @param decrypting true - расшифровывание, false - зашифровывание
+ * @param settings Параметры конвейера; способ деления на блоки задаётся
+ *        направлением
+ * @throw filePipeline_error Если размер блока меньше 16 байтов
+ */
+tableBlockPipeline::tableBlockPipeline(const tableCipher& cipher, bool decrypting, filePipeline::options settings)
+    : filePipeline(framedFor(settings, decrypting), nullptr,
+                   [&cipher, decrypting](std::string_view block, unsigned long long, std::string& result) {
+          // Буква результата занимает ровно два байта, во входе - не меньше двух
+          result.resize(block.size() + 1);
+          if (!decrypting) {
+              tableCipher::result r = cipher.tryEncryptInto(block, &result[0], block.size());
+              if (!r) {
+                  throw tableCipher_error(tableCipher::statusMessage(r.status));
+              }
+              result[r.size] = '\n';
+              result.resize(r.size + 1);
+              return;
+          }
+          size_t size = 0;
+          while (!block.empty()) {
+              const size_t eol = block.find('\n');
+              std::string_view line = block.substr(0, eol);
+              block.remove_prefix(eol == std::string_view::npos ? block.size() : eol + 1);
+              if (!line.empty() && line.back() == '\r') {
+                  line.remove_suffix(1);
+              }
+              if (line.empty()) {
+                  continue;
+              }
+              tableCipher::result r = cipher.tryDecryptInto(line, &result[size], result.size() - size);
+              if (!r) {
+                  throw tableCipher_error(tableCipher::statusMessage(r.status));
+              }
+              size += r.size;
+          }
+          result.resize(size);
+      })
+{
+}
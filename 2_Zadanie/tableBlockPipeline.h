@@ -0,0 +1,37 @@
+/**
+ * @file tableBlockPipeline.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для блочной обработки файлов табличной перестановкой
+ */
+
+#pragma once
+#include "tableCipher.h"
+#include "../common/filePipeline.h"
+
+/**
+ * @brief Конвейер filePipeline для блочного режима табличной перестановки
+ * @details При зашифровывании каждый блок - отдельная таблица, результат
+ *          блока - строка шифртекста с переводом строки. При расшифровывании
+ *          вход делится по строкам, каждая непустая строка (без завершающего
+ *          \\r) расшифровывается отдельно, результаты идут подряд без
+ *          разделителей. Любая ошибка проверки блока или строки прерывает
+ *          конвейер исключением tableCipher_error. Шифр не копируется и
+ *          должен существовать, пока существует конвейер.
+ */
+class tableBlockPipeline : public filePipeline
+{
+public:
+    /**
+     * @brief Конструктор конвейера шифра
+     * @param cipher Шифр
+     * @param decrypting true - расшифровывание, false - зашифровывание
+     * @param settings Параметры конвейера; способ деления на блоки задаётся
+     *        направлением
+     * @throw filePipeline_error Если размер блока меньше 16 байтов
+     */
+    tableBlockPipeline(const tableCipher& cipher, bool decrypting,
+                       filePipeline::options settings = filePipeline::options());
+};
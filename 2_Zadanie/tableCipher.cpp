@@ -8,10 +8,104 @@
  */
 
 #include "tableCipher.h"
+#include "tablePlanCache.h"
+#include "../common/russianText.h"
+#include "../common/cipherStats.h"
+#include "../common/parallelTasks.h"
 #include <algorithm>
 #include <sstream>
 #include <string>
 
+namespace {
+
+using stats = cipherStats<tableCipher>; ///< Счётчики модуля
+
+/**
+ * @brief Учёт вызова и его результата в счётчиках модуля
+ * @param status Результат проверки текста
+ * @param chars Количество единиц входного текста
+ * @return status
+ */
+inline tableCipher::textStatus counted(tableCipher::textStatus status, size_t chars)
+{
+    stats::call(chars);
+    if (status != tableCipher::textStatus::ok) {
+        stats::failure(static_cast<unsigned>(status));
+    }
+    return status;
+}
+
+/**
+ * @brief Количество единиц строки на одну букву
+ * @details Буква занимает один wchar_t или два байта UTF-8
+ */
+template <typename Char>
+constexpr size_t unitsPerLetter = sizeof(Char) == 1 ? 2 : 1;
+
+/**
+ * @brief Очередной символ широкой строки
+ * @param p Текущая позиция, сдвигается на символ
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const wchar_t*& p, const wchar_t*)
+{
+    return static_cast<char32_t>(*p++);
+}
+
+/**
+ * @brief Очередной символ строки UTF-8
+ * @param p Текущая позиция, сдвигается за символ
+ * @param end Конец текста
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const char*& p, const char* end)
+{
+    return russianText::decodeUtf8(p, end);
+}
+
+/**
+ * @brief Запись буквы в широкую строку
+ * @param c Заглавная буква
+ * @param out Начало буфера
+ * @param pos Номер буквы в результате
+ */
+inline void putLetter(char32_t c, wchar_t* out, size_t pos)
+{
+    out[pos] = static_cast<wchar_t>(c);
+}
+
+/**
+ * @brief Запись буквы в строку UTF-8
+ * @param c Заглавная буква
+ * @param out Начало буфера
+ * @param pos Номер буквы в результате
+ */
+inline void putLetter(char32_t c, char* out, size_t pos)
+{
+    russianText::encodeLetter(c, out + 2 * pos);
+}
+
+/**
+ * @brief Проверка, что единица широкой строки продолжает символ
+ * @return Всегда false: символ занимает один wchar_t
+ */
+inline bool isContinuation(wchar_t)
+{
+    return false;
+}
+
+/**
+ * @brief Проверка, что байт продолжает последовательность UTF-8
+ * @param c Байт
+ * @return true для байтов вида 10xxxxxx
+ */
+inline bool isContinuation(char c)
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+}
+
 /**
  * @brief Валидация ключа
  * @param k Проверяемый ключ
@@ -28,20 +122,30 @@ void tableCipher::validateKey(int k) {
 
 /**
  * @brief Валидация длины текста относительно ключа
- * @param text Проверяемый текст
+ * @param length Длина проверяемого текста
  * @param operation Название операции (для сообщения об ошибке)
  * @throw tableCipher_error Если длина текста недостаточна для операции
  */
-void tableCipher::validateTextLength(const std::wstring& text, const std::string& operation) {
-    if (text.length() <= key) {
-        throw tableCipher_error(
-            "Длина текста должна быть больше ключа для" + operation +
-            ". Длина текста: " + std::to_string(text.length()) +
-            ", ключ: " + std::to_string(key)
-        );
+void tableCipher::validateTextLength(size_t length, const std::string& operation) const {
+    if (length <= static_cast<size_t>(key)) {
+        throw tableCipher_error(lengthMessage(length, key, operation));
     }
 }
 
+/**
+ * @brief Текст ошибки недостаточной длины текста
+ * @param length Длина текста
+ * @param k Ключ
+ * @param operation Название операции
+ * @return Сообщение, с которым выбрасывается tableCipher_error
+ */
+std::string tableCipher::lengthMessage(size_t length, int k, const std::string& operation)
+{
+    return "Длина текста должна быть больше ключа для" + operation +
+           ". Длина текста: " + std::to_string(length) +
+           ", ключ: " + std::to_string(k);
+}
+
 /**
  * @brief Конструктор класса tableCipher
  * @param k Ключ шифрования (количество столбцов)
@@ -53,6 +157,34 @@ tableCipher::tableCipher(int k)
     key = k;
 }
 
+/**
+ * @brief Конструктор с установкой ключа и кэша планов
+ * @param k Ключ шифрования (количество столбцов)
+ * @param cache Кэш планов перестановки
+ * @throw tableCipher_error Если ключ невалиден
+ */
+tableCipher::tableCipher(int k, tablePlanCache& cache) : tableCipher(k)
+{
+    planCache = &cache;
+}
+
+/**
+ * @brief Построение маршрута перестановки
+ * @param k Количество столбцов
+ * @param length Длина текста
+ * @param route Массив маршрута, заполняется length индексами
+ */
+void tableCipher::buildRoute(int k, size_t length, std::vector<uint32_t>& route)
+{
+    route.resize(length);
+    size_t q = 0;
+    for (int j = k - 1; j >= 0; j--) {
+        for (size_t index = j; index < length; index += k) {
+            route[q++] = static_cast<uint32_t>(index);
+        }
+    }
+}
+
 /**
  * @brief Метод зашифровывания
  * @param open_text Открытый текст для шифрования
@@ -61,164 +193,963 @@ tableCipher::tableCipher(int k)
  */
 std::wstring tableCipher::encrypt(const std::wstring& open_text)
 {
-    std::wstring text = prepareText(open_text);
+    // Буквы переставляются сразу в результат, без таблицы строк
+    std::wstring result(open_text.size(), L'\0');
+    stats::allocated(result.size() * sizeof(wchar_t));
+    result.resize(encryptTo(std::wstring_view(open_text), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Метод расшифровывания
+ * @param cipher_text Зашифрованный текст для расшифрования
+ * @return Расшифрованная строка
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::wstring tableCipher::decrypt(const std::wstring& cipher_text)
+{
+    // Каждая буква шифртекста за один проход записывается на своё место
+    // в открытом тексте, без дополнения пробелами и без таблицы
+    std::wstring result(cipher_text.size(), L'\0');
+    stats::allocated(result.size() * sizeof(wchar_t));
+    result.resize(decryptTo(std::wstring_view(cipher_text), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Многопоточный метод зашифровывания
+ * @param open_text Открытый текст для шифрования
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Зашифрованная строка
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::wstring tableCipher::encrypt(const std::wstring& open_text, unsigned threads)
+{
+    std::wstring result(open_text.size(), L'\0');
+    stats::allocated(result.size() * sizeof(wchar_t));
+    result.resize(encryptTo(std::wstring_view(open_text), &result[0], result.size(), threads));
+    return result;
+}
+
+/**
+ * @brief Многопоточный метод расшифровывания
+ * @param cipher_text Зашифрованный текст для расшифрования
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Расшифрованная строка
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::wstring tableCipher::decrypt(const std::wstring& cipher_text, unsigned threads)
+{
+    std::wstring result(cipher_text.size(), L'\0');
+    stats::allocated(result.size() * sizeof(wchar_t));
+    result.resize(decryptTo(std::wstring_view(cipher_text), &result[0], result.size(), threads));
+    return result;
+}
+
+/**
+ * @brief Проверка текста и подсчёт его букв без копирования
+ * @param s Исходный текст
+ * @param letters Количество букв
+ * @return Результат проверки
+ */
+template <typename Char>
+tableCipher::textStatus tableCipher::textLetters(std::basic_string_view<Char> s, size_t& letters)
+{
+    letters = 0;
+    if (s.empty()) {
+        return textStatus::emptyText;
+    }
 
-    if (text.empty()) {
-        throw tableCipher_error("Пустой текст для шифрования");
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        if (!russianText::isLetter(c)) {
+            return textStatus::invalidText;
+        }
+        letters++;
     }
 
-    // Проверяем длину текста для шифрования
-    validateTextLength(text, "encryption");
+    if (letters == 0) {
+        return textStatus::onlySpaces;
+    }
+    return textStatus::ok;
+}
+
+/**
+ * @brief Полная проверка текста без исключений
+ * @param s Исходный текст
+ * @param letters Количество букв
+ * @return Результат проверки
+ */
+template <typename Char>
+tableCipher::textStatus tableCipher::checkText(std::basic_string_view<Char> s, size_t& letters) const
+{
+    textStatus status = textLetters(s, letters);
+    if (status == textStatus::ok && letters <= static_cast<size_t>(key)) {
+        return textStatus::tooShort;
+    }
+    return status;
+}
+
+/**
+ * @brief Исключение по результату проверки
+ * @param status Результат проверки, не ok
+ * @param length Количество букв текста
+ * @param operation Название операции (для сообщения об ошибке)
+ * @throw tableCipher_error Всегда
+ */
+void tableCipher::throwStatus(textStatus status, size_t length, const std::string& operation) const
+{
+    if (status == textStatus::tooShort) {
+        validateTextLength(length, operation);
+    }
+    throw tableCipher_error(statusMessage(status));
+}
+
+/**
+ * @brief Текст ошибки по результату проверки
+ * @param status Результат проверки
+ * @return Сообщение об ошибке; для ok - пустая строка
+ */
+const char* tableCipher::statusMessage(textStatus status)
+{
+    switch (status) {
+        case textStatus::emptyText:
+            return "Пустой вводимый текст";
+        case textStatus::invalidText:
+            return "Текст содержит недопустимые символы. Допускаются только русские буквы и пробелы.";
+        case textStatus::onlySpaces:
+            return "Текст содержит только пробелы";
+        case textStatus::tooShort:
+            return "Длина текста должна быть больше ключа";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief Начало столбца в шифртексте
+ * @param j Номер столбца
+ * @param rows Количество строк таблицы
+ * @param full Количество полных столбцов
+ * @return Позиция первой буквы столбца в шифртексте
+ */
+size_t tableCipher::columnStart(size_t j, size_t rows, size_t full) const
+{
+    const size_t k = key;
+    if (j >= full) {
+        return (k - 1 - j) * (rows - 1);
+    }
+    return (k - full) * (rows - 1) + (full - 1 - j) * rows;
+}
 
-    int text_len = text.length();
-    int rows = (text_len + key - 1) / key;
+/**
+ * @brief Выписывание букв текста подряд
+ * @param s Проверенный текст
+ * @param letters Буфер для букв текста
+ */
+template <typename Char>
+void tableCipher::gatherLetters(std::basic_string_view<Char> s, char16_t* letters)
+{
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c != U' ') {
+            *letters++ = static_cast<char16_t>(russianText::toUpper(c));
+        }
+    }
+}
 
-    // Создаем таблицу
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
+/**
+ * @brief Блочная перестановка открытого текста в шифртекст
+ * @param letters Буквы открытого текста подряд, начиная со строки rowFirst
+ * @param text_len Количество букв
+ * @param out Буфер результата
+ * @param rowFirst Первая обрабатываемая строка таблицы
+ * @param rowLast Строка таблицы за последней обрабатываемой
+ */
+template <typename Char>
+void tableCipher::encryptBlocked(const char16_t* letters, size_t text_len, Char* out, size_t rowFirst, size_t rowLast) const
+{
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
 
-    // Заполняем таблицу (слева направо, сверху вниз)
-    int index = 0;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            if (index < text_len) {
-                table[i][j] = text[index++];
+    for (size_t i0 = rowFirst; i0 < rowLast; i0 += tileSize) {
+        const size_t i1 = std::min(i0 + tileSize, rowLast);
+        for (size_t j0 = 0; j0 < k; j0 += tileSize) {
+            const size_t j1 = std::min(j0 + tileSize, k);
+            // В пределах блока столбец записывается подряд, а читаемые
+            // строки блока уже загружены в кэш предыдущими столбцами
+            for (size_t j = j0; j < j1; j++) {
+                const size_t height = std::min(i1, j < full ? rows : rows - 1);
+                const size_t start = columnStart(j, rows, full);
+                for (size_t i = i0; i < height; i++) {
+                    putLetter(letters[(i - rowFirst) * k + j], out, start + i);
+                }
             }
         }
     }
+}
 
-    // Считываем таблицу (сверху вниз, справа налево)
-    std::wstring result;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            if (table[i][j] != L' ')
-                result += table[i][j];
+/**
+ * @brief Блочная перестановка шифртекста в открытый текст
+ * @param letters Буквы шифртекста подряд
+ * @param text_len Количество букв
+ * @param out Буфер результата
+ * @param rowFirst Первая обрабатываемая строка таблицы
+ * @param rowLast Строка таблицы за последней обрабатываемой
+ */
+template <typename Char>
+void tableCipher::decryptBlocked(const char16_t* letters, size_t text_len, Char* out, size_t rowFirst, size_t rowLast) const
+{
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
+
+    size_t start[tileSize];
+    for (size_t j0 = 0; j0 < k; j0 += tileSize) {
+        const size_t j1 = std::min(j0 + tileSize, k);
+        for (size_t j = j0; j < j1; j++) {
+            start[j - j0] = columnStart(j, rows, full);
+        }
+        for (size_t i0 = rowFirst; i0 < rowLast; i0 += tileSize) {
+            const size_t i1 = std::min(i0 + tileSize, rowLast);
+            for (size_t i = i0; i < i1; i++) {
+                // Последняя строка таблицы заполнена только до столбца full
+                const size_t width = i == rows - 1 ? std::min(j1, full) : j1;
+                for (size_t j = j0; j < width; j++) {
+                    putLetter(letters[start[j - j0] + i], out, i * k + j);
+                }
+            }
         }
     }
+}
 
-    return result;
+/**
+ * @brief Блочное зашифровывание длинного текста с ограниченной памятью
+ * @param s Проверенный открытый текст
+ * @param text_len Количество букв
+ * @param out Буфер результата
+ */
+template <typename Char>
+void tableCipher::encryptStriped(std::basic_string_view<Char> s, size_t text_len, Char* out) const
+{
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+
+    std::u16string stripe(tileSize * k, u'\0');
+    stats::allocated(stripe.size() * sizeof(char16_t));
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    for (size_t i0 = 0; i0 < rows; i0 += tileSize) {
+        const size_t i1 = std::min(i0 + tileSize, rows);
+        const size_t count = std::min((i1 - i0) * k, text_len - i0 * k);
+        for (size_t q = 0; q < count;) {
+            char32_t c = nextChar(p, end);
+            if (c != U' ') {
+                stripe[q++] = static_cast<char16_t>(russianText::toUpper(c));
+            }
+        }
+        encryptBlocked(stripe.data(), text_len, out, i0, i1);
+    }
 }
 
 /**
- * @brief Метод расшифровывания
- * @param cipher_text Зашифрованный текст для расшифрования
- * @return Расшифрованная строка
- * @throw tableCipher_error Если текст пустой или недостаточной длины
+ * @brief Блочное расшифровывание длинного текста с ограниченной памятью
+ * @param s Проверенный шифртекст
+ * @param text_len Количество букв
+ * @param out Буфер результата
  */
-std::wstring tableCipher::decrypt(const std::wstring& cipher_text)
+template <typename Char>
+void tableCipher::decryptStriped(std::basic_string_view<Char> s, size_t text_len, Char* out) const
 {
-    std::wstring text = prepareText(cipher_text);
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
 
-    if (text.empty()) {
-        throw tableCipher_error("Пустой текст для расшифровки");
+    // Столбцы идут в шифртексте справа налево; позиция столбца запоминается
+    // перед его первой буквой
+    std::vector<const Char*> cursor(k);
+    stats::allocated(k * sizeof(const Char*));
+    const Char* p = s.data();
+    const Char* end = p + s.size();
+    for (size_t j = k; j-- > 0;) {
+        const size_t height = j < full ? rows : rows - 1;
+        while (*p == Char(' ')) {
+            p++;
+        }
+        cursor[j] = p;
+        for (size_t i = 0; i < height;) {
+            i += nextChar(p, end) != U' ';
+        }
     }
 
-    // Проверяем длину текста для расшифрования
-    validateTextLength(text, "decryption");
+    std::u16string stripe(tileSize * k, u'\0');
+    stats::allocated(stripe.size() * sizeof(char16_t));
+    for (size_t i0 = 0; i0 < rows; i0 += tileSize) {
+        const size_t i1 = std::min(i0 + tileSize, rows);
+        for (size_t j = 0; j < k; j++) {
+            const size_t height = std::min(i1, j < full ? rows : rows - 1);
+            char16_t* column = &stripe[j * tileSize];
+            for (size_t i = i0; i < height;) {
+                char32_t c = nextChar(cursor[j], end);
+                if (c != U' ') {
+                    column[i++ - i0] = static_cast<char16_t>(russianText::toUpper(c));
+                }
+            }
+        }
+        for (size_t j0 = 0; j0 < k; j0 += tileSize) {
+            const size_t j1 = std::min(j0 + tileSize, k);
+            for (size_t i = i0; i < i1; i++) {
+                // Последняя строка таблицы заполнена только до столбца full
+                const size_t width = i == rows - 1 ? std::min(j1, full) : j1;
+                for (size_t j = j0; j < width; j++) {
+                    putLetter(stripe[j * tileSize + i - i0], out, i * k + j);
+                }
+            }
+        }
+    }
+}
 
-    int text_len = text.length();
-    int rows = (text_len + key - 1) / key;
+/**
+ * @brief Многопоточная перестановка
+ * @param s Исходный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @param threads Количество потоков, не меньше двух
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+template <typename Char>
+size_t tableCipher::permuteParallel(std::basic_string_view<Char> s, Char* out, size_t capacity, bool decrypting, unsigned threads) const
+{
+    const char* operation = decrypting ? "decryption" : "encryption";
+    if (s.empty()) {
+        throwStatus(counted(textStatus::emptyText, 0), 0, operation);
+    }
 
-    int total_cells = rows * key;
-    int empty_cells = total_cells - text_len;
+    // Границы участков сдвигаются к началу символа, чтобы ни одна
+    // последовательность UTF-8 не оказалась разрезанной
+    std::vector<size_t> bounds(threads + 1, s.size());
+    bounds[0] = 0;
+    for (unsigned t = 1; t < threads; t++) {
+        size_t b = std::max(bounds[t - 1], s.size() / threads * t);
+        while (b < s.size() && isContinuation(s[b])) {
+            b++;
+        }
+        bounds[t] = b;
+    }
 
-    // Добавляем пробелы в конец текста, чтобы заполнить пустые ячейки
-    if (empty_cells > 0) {
-        for(int i = 1; i <= empty_cells; i++) {
-            text.insert((i*(rows - 1)+(i-1)), L" ");
+    // Проверка и подсчёт букв по участкам; исключения из потоков не
+    // выбрасываются, ошибки собираются и сообщаются так же, как в textLetters
+    std::vector<size_t> offsets(threads + 1, 0);
+    std::vector<char> invalid(threads, 0);
+    stats::stopwatch watch;
+    parallelTasks::run(threads, [&](unsigned t) {
+        const Char* p = s.data() + bounds[t];
+        const Char* end = s.data() + bounds[t + 1];
+        size_t count = 0;
+        while (p != end) {
+            char32_t c = nextChar(p, end);
+            if (c == U' ') {
+                continue;
+            }
+            if (!russianText::isLetter(c)) {
+                invalid[t] = 1;
+                return;
+            }
+            count++;
         }
+        offsets[t + 1] = count;
+    });
+    watch.lap(cipherStage::validate);
+    for (unsigned t = 0; t < threads; t++) {
+        offsets[t + 1] += offsets[t];
+    }
+    const size_t text_len = offsets[threads];
+    textStatus status = textStatus::ok;
+    if (std::find(invalid.begin(), invalid.end(), 1) != invalid.end()) {
+        status = textStatus::invalidText;
+    } else if (text_len == 0) {
+        status = textStatus::onlySpaces;
+    } else if (text_len <= static_cast<size_t>(key)) {
+        status = textStatus::tooShort;
+    }
+    if (counted(status, s.size()) != textStatus::ok) {
+        throwStatus(status, text_len, operation);
+    }
+    if (capacity < unitsPerLetter<Char> * text_len) {
+        return unitsPerLetter<Char> * text_len;
     }
 
-    // Создаем таблицу для заполнения при чтении
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
+    std::u16string letters(text_len, u'\0');
+    stats::allocated(text_len * sizeof(char16_t));
+    parallelTasks::run(threads, [&](unsigned t) {
+        gatherLetters(s.substr(bounds[t], bounds[t + 1] - bounds[t]), &letters[offsets[t]]);
+    });
+    watch.lap(cipherStage::normalize);
 
-    // Заполняем таблицу при чтении (сверху вниз, справа налево)
-    int index = 0;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            if (index < text.length()) {
-                table[i][j] = text[index++];
-            }
+    // Полосы строк выровнены по блокам, чтобы блоки не делились между потоками
+    const size_t rows = (text_len + key - 1) / key;
+    const size_t stripe = ((rows + threads - 1) / threads + tileSize - 1) / tileSize * tileSize;
+    parallelTasks::run(threads, [&](unsigned t) {
+        const size_t first = std::min(rows, t * stripe);
+        const size_t last = std::min(rows, first + stripe);
+        if (decrypting) {
+            decryptBlocked(letters.data(), text_len, out, first, last);
+        } else {
+            encryptBlocked(letters.data() + std::min(text_len, first * key), text_len, out, first, last);
         }
+    });
+    watch.lap(cipherStage::transform);
+    return unitsPerLetter<Char> * text_len;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param size Размер результата; если он больше capacity, буфер не заполняется
+ * @return Результат проверки текста
+ */
+template <typename Char>
+tableCipher::textStatus tableCipher::encryptStatus(std::basic_string_view<Char> open_text, Char* out,
+                                                   size_t capacity, size_t& size) const
+{
+    stats::stopwatch watch;
+    size_t text_len = 0;
+    textStatus status = checkText(open_text, text_len);
+    watch.lap(cipherStage::validate);
+    size = status == textStatus::ok || status == textStatus::tooShort ? unitsPerLetter<Char> * text_len : 0;
+    if (status == textStatus::ok && capacity >= size) {
+        encryptLetters(open_text, text_len, out);
+        watch.lap(cipherStage::transform);
     }
+    return status;
+}
 
-    // Читаем таблицу (слева направо, сверху вниз)
-    std::wstring result;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            result += table[i][j];
+/**
+ * @brief Зашифровывание в буфер вызывающего
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+template <typename Char>
+size_t tableCipher::encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity, unsigned threads) const
+{
+    threads = parallelTasks::threadCount(threads, open_text.size() / (unitsPerLetter<Char> * parallelThreshold));
+    if (threads > 1) {
+        return permuteParallel(open_text, out, capacity, false, threads);
+    }
+
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    if (status != textStatus::ok) {
+        throwStatus(status, size / unitsPerLetter<Char>, "encryption");
+    }
+    return size;
+}
+
+/**
+ * @brief Перестановка проверенного открытого текста
+ * @param open_text Проверенный открытый текст
+ * @param text_len Количество букв
+ * @param out Буфер результата на text_len букв
+ */
+template <typename Char>
+void tableCipher::encryptLetters(std::basic_string_view<Char> open_text, size_t text_len, Char* out) const
+{
+    if (planCache != nullptr) {
+        if (std::shared_ptr<const tablePlanCache::plan> plan = planCache->get(key, text_len)) {
+            // Выборка по плану требует произвольного доступа к буквам текста,
+            // буфер потока переиспользуется между вызовами
+            thread_local std::u16string letters;
+            if (text_len > letters.capacity()) {
+                stats::allocated(text_len * sizeof(char16_t));
+            }
+            letters.resize(text_len);
+            gatherLetters(open_text, &letters[0]);
+            const uint32_t* route = plan->route.data();
+            for (size_t q = 0; q < text_len; q++) {
+                putLetter(letters[route[q]], out, q);
+            }
+            return;
         }
     }
 
-    // Удаляем добавленные пробелы из результата
-    size_t pos = result.find_last_not_of(L' ');
-    if (pos != std::wstring::npos) {
-        result.erase(pos + 1);
-    } else {
-        result.clear();
+    // При ключе, близком к длине текста, строк меньше tileSize и буфер полосы
+    // оказался бы больше самого текста, поэтому такие тексты переставляются напрямую
+    if (text_len >= blockedThreshold && text_len / key >= tileSize) {
+        encryptStriped(open_text, text_len, out);
+        return;
     }
 
-    return result;
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
+
+    // Номер буквы i * key + j: строка i, столбец j
+    size_t i = 0;
+    size_t j = 0;
+    const Char* p = open_text.data();
+    const Char* end = p + open_text.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        putLetter(russianText::toUpper(c), out, columnStart(j, rows, full) + i);
+        if (++j == k) {
+            j = 0;
+            i++;
+        }
+    }
 }
 
 /**
- * @brief Приведение строки к верхнему регистру
- * @param s Входная строка
- * @return Строка в верхнем регистре
+ * @brief Расшифровывание в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param size Размер результата; если он больше capacity, буфер не заполняется
+ * @return Результат проверки текста
  */
-std::wstring tableCipher::toUpper(const std::wstring& s)
+template <typename Char>
+tableCipher::textStatus tableCipher::decryptStatus(std::basic_string_view<Char> cipher_text, Char* out,
+                                                   size_t capacity, size_t& size) const
 {
-    std::wstring result = s;
-    std::locale loc("ru_RU.UTF-8");
-    for (wchar_t& c : result) {
-        c = std::toupper(c, loc);
+    stats::stopwatch watch;
+    size_t text_len = 0;
+    textStatus status = checkText(cipher_text, text_len);
+    watch.lap(cipherStage::validate);
+    size = status == textStatus::ok || status == textStatus::tooShort ? unitsPerLetter<Char> * text_len : 0;
+    if (status == textStatus::ok && capacity >= size) {
+        decryptLetters(cipher_text, text_len, out);
+        watch.lap(cipherStage::transform);
     }
-    return result;
+    return status;
 }
 
 /**
- * @brief Проверка текста на соответствие русскому алфавиту
- * @param text Проверяемый текст
- * @return true если текст содержит только русские буквы и пробелы, иначе false
+ * @brief Расшифровывание в буфер вызывающего
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах Char
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
  */
-bool tableCipher::isValidRussianText(const std::wstring& text)
+template <typename Char>
+size_t tableCipher::decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity, unsigned threads) const
 {
-    for (wchar_t c : text) {
-        if (c != L' ' && !(c >= L'А' && c <= L'Я') && !(c >= L'а' && c <= L'я') && c != L'Ё' && c != L'ё') {
-            return false;
-        }
+    threads = parallelTasks::threadCount(threads, cipher_text.size() / (unitsPerLetter<Char> * parallelThreshold));
+    if (threads > 1) {
+        return permuteParallel(cipher_text, out, capacity, true, threads);
+    }
+
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    if (status != textStatus::ok) {
+        throwStatus(status, size / unitsPerLetter<Char>, "decryption");
     }
-    return true;
+    return size;
 }
 
 /**
- * @brief Подготовка текста к шифрованию
- * @param s Исходный текст
- * @return Текст в верхнем регистре без пробелов
- * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+ * @brief Перестановка проверенного шифртекста
+ * @param cipher_text Проверенный шифртекст
+ * @param text_len Количество букв
+ * @param out Буфер результата на text_len букв
  */
-std::wstring tableCipher::prepareText(const std::wstring& s)
+template <typename Char>
+void tableCipher::decryptLetters(std::basic_string_view<Char> cipher_text, size_t text_len, Char* out) const
 {
-    if (s.empty()) {
-        throw tableCipher_error("Пустой вводимый текст");
+    if (planCache != nullptr) {
+        if (std::shared_ptr<const tablePlanCache::plan> plan = planCache->get(key, text_len)) {
+            const uint32_t* route = plan->route.data();
+            const Char* p = cipher_text.data();
+            const Char* end = p + cipher_text.size();
+            while (p != end) {
+                char32_t c = nextChar(p, end);
+                if (c != U' ') {
+                    putLetter(russianText::toUpper(c), out, *route++);
+                }
+            }
+            return;
+        }
     }
 
-    if (!isValidRussianText(s)) {
-        throw tableCipher_error("Текст содержит недопустимые символы. Допускаются только русские буквы и пробелы.");
+    // Полосы не используются при числе строк меньше tileSize, как и в encryptLetters
+    if (text_len >= blockedThreshold && text_len / key >= tileSize) {
+        decryptStriped(cipher_text, text_len, out);
+        return;
     }
 
-    // Удаляем пробелы и приводим к верхнему регистру
-    std::wstring result;
-    std::locale loc("ru_RU.UTF-8");
+    const size_t k = key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
 
-    for (wchar_t c : s) {
-        if (c != L' ') {
-            result += std::toupper(c, loc);
+    // Обратная перестановка: шифртекст состоит из столбцов j = key-1..0,
+    // столбец j содержит rows букв при j < full и rows - 1 иначе, а его буква
+    // в строке i занимает в открытом тексте позицию i * key + j
+    size_t i = 0;
+    size_t j = k - 1;
+    size_t height = j < full ? rows : rows - 1;
+    const Char* p = cipher_text.data();
+    const Char* end = p + cipher_text.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        putLetter(russianText::toUpper(c), out, i * k + j);
+        if (++i == height && j > 0) {
+            i = 0;
+            j--;
+            height = j < full ? rows : rows - 1;
         }
     }
+}
 
-    if (result.empty()) {
-        throw tableCipher_error("Текст содержит только пробелы");
+/**
+ * @brief Пакетная обработка сообщений
+ * @param text Буфер всех сообщений в UTF-8
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов в arena, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @return Количество успешно обработанных сообщений
+ */
+size_t tableCipher::transformBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                   std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status,
+                                   bool decrypting) const
+{
+    // Каждая буква занимает в сообщении не меньше двух байтов, а в результате
+    // ровно два, поэтому буфер размером со все сообщения выделяется один раз
+    const size_t total = count > 0 ? offsets[count] - offsets[0] : 0;
+    if (total > arena.capacity()) {
+        stats::allocated(total);
     }
+    arena.resize(total);
+    arenaOffsets.resize(count + 1);
+    status.resize(count);
+
+    size_t pos = 0;
+    size_t done = 0;
+    arenaOffsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        std::string_view message(text + offsets[i], offsets[i + 1] - offsets[i]);
+        size_t size = 0;
+        status[i] = counted(decrypting ? decryptStatus(message, &arena[pos], arena.size() - pos, size)
+                                       : encryptStatus(message, &arena[pos], arena.size() - pos, size),
+                            message.size());
+        if (status[i] == textStatus::ok) {
+            pos += size;
+            done++;
+        }
+        arenaOffsets[i + 1] = pos;
+    }
+    arena.resize(pos);
+    return done;
+}
 
+/**
+ * @brief Пакетное зашифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно зашифрованных сообщений
+ */
+size_t tableCipher::encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                 std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const
+{
+    return transformBatch(text, offsets, count, arena, arenaOffsets, status, false);
+}
+
+/**
+ * @brief Пакетное расшифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно расшифрованных сообщений
+ */
+size_t tableCipher::decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                                 std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const
+{
+    return transformBatch(text, offsets, count, arena, arenaOffsets, status, true);
+}
+
+/**
+ * @brief Метод зашифровывания текста в кодировке UTF-8
+ * @param open_text Открытый текст в UTF-8
+ * @return Зашифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipher::encrypt(std::string_view open_text) const
+{
+    // Каждая буква занимает в UTF-8 не меньше двух байтов, в результате - ровно два
+    std::string result(open_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(encryptTo(open_text, &result[0], result.size()));
     return result;
 }
+
+/**
+ * @brief Метод расшифровывания текста в кодировке UTF-8
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @return Расшифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipher::decrypt(std::string_view cipher_text) const
+{
+    std::string result(cipher_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(decryptTo(cipher_text, &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Многопоточный метод зашифровывания текста в кодировке UTF-8
+ * @param open_text Открытый текст в UTF-8
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Зашифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipher::encrypt(std::string_view open_text, unsigned threads)
+{
+    std::string result(open_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(encryptTo(open_text, &result[0], result.size(), threads));
+    return result;
+}
+
+/**
+ * @brief Многопоточный метод расшифровывания текста в кодировке UTF-8
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param threads Количество потоков, 0 - по числу ядер процессора
+ * @return Расшифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipher::decrypt(std::string_view cipher_text, unsigned threads)
+{
+    std::string result(cipher_text.size(), '\0');
+    stats::allocated(result.size());
+    result.resize(decryptTo(cipher_text, &result[0], result.size(), threads));
+    return result;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата в символах
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipher::encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const
+{
+    return encryptTo(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата в символах
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipher::decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const
+{
+    return decryptTo(cipher_text, out, capacity);
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+ * @param open_text Открытый текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата в байтах
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipher::encryptInto(std::string_view open_text, char* out, size_t capacity) const
+{
+    return encryptTo(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата в байтах
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipher::decryptInto(std::string_view cipher_text, char* out, size_t capacity) const
+{
+    return decryptTo(cipher_text, out, capacity);
+}
+
+/**
+ * @brief Преобразование в строку вызывающего без исключений
+ * @param s Исходный текст
+ * @param out Строка результата
+ * @param decrypting true для расшифровывания, false для зашифровывания
+ * @return Результат проверки текста
+ */
+template <typename Char>
+tableCipher::textStatus tableCipher::tryTransform(std::basic_string_view<Char> s, std::basic_string<Char>& out,
+                                                  bool decrypting) const
+{
+    // Первый вызов с имеющимся буфером: при ошибке или нехватке места он
+    // только проверяет текст и считает размер результата
+    size_t size = 0;
+    textStatus status = decrypting ? decryptStatus(s, &out[0], out.size(), size)
+                                   : encryptStatus(s, &out[0], out.size(), size);
+    if (status == textStatus::ok && size > out.size()) {
+        if (size > out.capacity()) {
+            stats::allocated(size * sizeof(Char));
+        }
+        out.resize(size);
+        status = decrypting ? decryptStatus(s, &out[0], out.size(), size)
+                            : encryptStatus(s, &out[0], out.size(), size);
+    }
+    out.resize(status == textStatus::ok ? size : 0);
+    return counted(status, s.size());
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Результат проверки и размер результата в символах
+ */
+tableCipher::result tableCipher::tryEncryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Результат проверки и размер результата в символах
+ */
+tableCipher::result tableCipher::tryDecryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в буфер вызывающего без исключений
+ * @param open_text Открытый текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Результат проверки и размер результата в байтах
+ */
+tableCipher::result tableCipher::tryEncryptInto(std::string_view open_text, char* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(encryptStatus(open_text, out, capacity, size), open_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в буфер вызывающего без исключений
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Результат проверки и размер результата в байтах
+ */
+tableCipher::result tableCipher::tryDecryptInto(std::string_view cipher_text, char* out, size_t capacity) const
+{
+    size_t size = 0;
+    textStatus status = counted(decryptStatus(cipher_text, out, capacity, size), cipher_text.size());
+    return {status, size};
+}
+
+/**
+ * @brief Зашифровывание в строку вызывающего без исключений
+ * @param open_text Открытый текст
+ * @param out Зашифрованный текст, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+tableCipher::textStatus tableCipher::tryEncrypt(std::wstring_view open_text, std::wstring& out) const
+{
+    return tryTransform(open_text, out, false);
+}
+
+/**
+ * @brief Расшифровывание в строку вызывающего без исключений
+ * @param cipher_text Зашифрованный текст
+ * @param out Расшифрованный текст, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+tableCipher::textStatus tableCipher::tryDecrypt(std::wstring_view cipher_text, std::wstring& out) const
+{
+    return tryTransform(cipher_text, out, true);
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в строку вызывающего без исключений
+ * @param open_text Открытый текст в UTF-8
+ * @param out Зашифрованный текст в UTF-8, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+tableCipher::textStatus tableCipher::tryEncrypt(std::string_view open_text, std::string& out) const
+{
+    return tryTransform(open_text, out, false);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в строку вызывающего без исключений
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Расшифрованный текст в UTF-8, при ошибке - пустая строка
+ * @return Результат проверки текста
+ */
+tableCipher::textStatus tableCipher::tryDecrypt(std::string_view cipher_text, std::string& out) const
+{
+    return tryTransform(cipher_text, out, true);
+}
+
+/**
+ * @brief Снимок счётчиков модуля
+ * @return Сумма счётчиков всех потоков
+ */
+cipherCounters tableCipher::statsSnapshot()
+{
+    return stats::snapshot();
+}
+
+/**
+ * @brief Обнуление счётчиков модуля
+ */
+void tableCipher::resetStats()
+{
+    stats::reset();
+}
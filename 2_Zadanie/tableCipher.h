@@ -10,9 +10,12 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
-#include <locale>
-#include <codecvt>
+#include <cstdint>
+#include "../common/cipherStats.h"
+
+class tablePlanCache;
 
 /**
  * @brief Класс-исключение для ошибок шифра табличной перестановки
@@ -49,45 +52,286 @@ public:
  */
 class tableCipher
 {
+    friend class productCipher;
+
+public:
+    /**
+     * @brief Результат проверки текста без исключений
+     */
+    enum class textStatus : unsigned char {
+        ok, ///< Текст обработан
+        emptyText, ///< Текст пустой
+        invalidText, ///< В тексте есть символы, кроме русских букв и пробелов
+        onlySpaces, ///< Текст состоит только из пробелов
+        tooShort ///< Букв в тексте не больше, чем столбцов в таблице
+    };
+
+    /**
+     * @brief Результат операции без исключений
+     */
+    struct result {
+        textStatus status; ///< Результат проверки текста
+        size_t size; ///< Размер результата; для tooShort - размер, который имел бы результат, для других ошибок - 0
+
+        /**
+         * @brief Признак успешной операции
+         * @return true, если status равен ok
+         */
+        explicit operator bool() const { return status == textStatus::ok; }
+    };
+
 private:
+    static constexpr size_t tileSize = 64; ///< Сторона блока таблицы при блочной перестановке
+    static constexpr size_t blockedThreshold = 1 << 16; ///< Длина текста, начиная с которой перестановка блочная
+    static constexpr size_t parallelThreshold = 1 << 16; ///< Наименьшая длина текста на поток для параллельного режима
+
     int key; ///< Ключ шифрования (количество столбцов)
+    tablePlanCache* planCache = nullptr; ///< Кэш планов перестановки (необязательный)
 
     /**
-     * @brief Приведение строки к верхнему регистру
-     * @param s Входная строка
-     * @return Строка в верхнем регистре
+     * @brief Проверка текста и подсчёт его букв без копирования
+     * @details Проверки по порядку: пустой текст, недопустимые символы
+     *          (допускаются только русские буквы и пробелы), текст из одних
+     *          пробелов.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Исходный текст
+     * @param letters Количество букв
+     * @return Результат проверки
+     */
+    template <typename Char>
+    static textStatus textLetters(std::basic_string_view<Char> s, size_t& letters);
+
+    /**
+     * @brief Полная проверка текста без исключений
+     * @details textLetters и проверка длины текста относительно ключа
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Исходный текст
+     * @param letters Количество букв
+     * @return Результат проверки
      */
-    std::wstring toUpper(const std::wstring& s);
+    template <typename Char>
+    textStatus checkText(std::basic_string_view<Char> s, size_t& letters) const;
 
     /**
-     * @brief Проверка текста на соответствие русскому алфавиту
-     * @param text Проверяемый текст
-     * @return true если текст содержит только русские буквы и пробелы, иначе false
+     * @brief Исключение по результату проверки
+     * @param status Результат проверки, не ok
+     * @param length Количество букв текста
+     * @param operation Название операции (для сообщения об ошибке)
+     * @throw tableCipher_error Всегда
      */
-    bool isValidRussianText(const std::wstring& text);
+    [[noreturn]] void throwStatus(textStatus status, size_t length, const std::string& operation) const;
 
     /**
-     * @brief Подготовка текста к шифрованию
+     * @brief Начало столбца в шифртексте
+     * @details Столбцы считываются справа налево; первые full столбцов
+     *          содержат rows букв, остальные - rows - 1.
+     * @param j Номер столбца
+     * @param rows Количество строк таблицы
+     * @param full Количество полных столбцов
+     * @return Позиция первой буквы столбца в шифртексте
+     */
+    size_t columnStart(size_t j, size_t rows, size_t full) const;
+
+    /**
+     * @brief Выписывание букв текста подряд
+     * @details Пробелы пропускаются, буквы приводятся к верхнему регистру
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Проверенный текст
+     * @param letters Буфер для букв текста
+     */
+    template <typename Char>
+    static void gatherLetters(std::basic_string_view<Char> s, char16_t* letters);
+
+    /**
+     * @brief Блочная перестановка открытого текста в шифртекст
+     * @details Таблица обходится блоками tileSize x tileSize, так что строки
+     *          блока при чтении и отрезки столбцов при записи остаются в кэше,
+     *          какой бы большой ни была таблица.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param letters Буквы открытого текста подряд, начиная со строки rowFirst
+     * @param text_len Количество букв
+     * @param out Буфер результата
+     * @param rowFirst Первая обрабатываемая строка таблицы
+     * @param rowLast Строка таблицы за последней обрабатываемой
+     */
+    template <typename Char>
+    void encryptBlocked(const char16_t* letters, size_t text_len, Char* out, size_t rowFirst, size_t rowLast) const;
+
+    /**
+     * @brief Блочная перестановка шифртекста в открытый текст
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param letters Буквы шифртекста подряд
+     * @param text_len Количество букв
+     * @param out Буфер результата
+     * @param rowFirst Первая обрабатываемая строка таблицы
+     * @param rowLast Строка таблицы за последней обрабатываемой
+     */
+    template <typename Char>
+    void decryptBlocked(const char16_t* letters, size_t text_len, Char* out, size_t rowFirst, size_t rowLast) const;
+
+    /**
+     * @brief Блочное зашифровывание длинного текста с ограниченной памятью
+     * @details Открытый текст читается подряд полосами по tileSize строк
+     *          таблицы; каждая полоса выписывается в буфер и переставляется
+     *          через encryptBlocked. Буфер занимает tileSize * key букв
+     *          независимо от длины текста.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Проверенный открытый текст
+     * @param text_len Количество букв
+     * @param out Буфер результата
+     */
+    template <typename Char>
+    void encryptStriped(std::basic_string_view<Char> s, size_t text_len, Char* out) const;
+
+    /**
+     * @brief Блочное расшифровывание длинного текста с ограниченной памятью
+     * @details Сначала запоминаются позиции начала столбцов в шифртексте, затем
+     *          из каждого столбца читается очередной отрезок по tileSize букв,
+     *          и полоса строк записывается в результат. Память - key позиций и
+     *          буфер tileSize * key букв независимо от длины текста.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Проверенный шифртекст
+     * @param text_len Количество букв
+     * @param out Буфер результата
+     */
+    template <typename Char>
+    void decryptStriped(std::basic_string_view<Char> s, size_t text_len, Char* out) const;
+
+    /**
+     * @brief Многопоточная перестановка
+     * @details Текст делится на участки по границам символов: потоки проверяют
+     *          и считают буквы своих участков, затем выписывают их подряд в
+     *          общий буфер. Перестановка делится на полосы строк таблицы,
+     *          каждый поток пишет только в позиции букв своих строк, поэтому
+     *          области записи потоков не пересекаются.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
      * @param s Исходный текст
-     * @return Текст в верхнем регистре без пробелов
-     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или только пробелы
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @param threads Количество потоков, не меньше двух
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
      */
-    std::wstring prepareText(const std::wstring& s);
+    template <typename Char>
+    size_t permuteParallel(std::basic_string_view<Char> s, Char* out, size_t capacity, bool decrypting, unsigned threads) const;
 
     /**
-     * @brief Валидация ключа
-     * @param k Проверяемый ключ
-     * @throw tableCipher_error Если ключ невалиден
+     * @brief Перестановка проверенного открытого текста
+     * @details Буква с номером i * key + j открытого текста сразу записывается
+     *          на позицию columnStart(j) + i, без таблицы и копии текста.
+     *          Длинные тексты переставляются блочно через encryptStriped.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param open_text Проверенный открытый текст
+     * @param text_len Количество букв
+     * @param out Буфер результата на text_len букв
+     */
+    template <typename Char>
+    void encryptLetters(std::basic_string_view<Char> open_text, size_t text_len, Char* out) const;
+
+    /**
+     * @brief Перестановка проверенного шифртекста
+     * @details Буквы шифртекста обходятся по столбцам справа налево и сразу
+     *          записываются на позицию i * key + j. Длинные тексты
+     *          переставляются блочно через decryptStriped.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param cipher_text Проверенный шифртекст
+     * @param text_len Количество букв
+     * @param out Буфер результата на text_len букв
+     */
+    template <typename Char>
+    void decryptLetters(std::basic_string_view<Char> cipher_text, size_t text_len, Char* out) const;
+
+    /**
+     * @brief Пакетная обработка сообщений
+     * @param text Буфер всех сообщений в UTF-8
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов в arena, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @return Количество успешно обработанных сообщений
      */
-    void validateKey(int k);
+    size_t transformBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                          std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status, bool decrypting) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего без исключений
+     * @details checkText и encryptLetters, если буфера достаточно.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param size Размер результата; если он больше capacity, буфер не заполняется
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus encryptStatus(std::basic_string_view<Char> open_text, Char* out, size_t capacity, size_t& size) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего без исключений
+     * @details Аналогично encryptStatus.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param size Размер результата; если он больше capacity, буфер не заполняется
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus decryptStatus(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity, size_t& size) const;
+
+    /**
+     * @brief Преобразование в строку вызывающего без исключений
+     * @details Строка увеличивается только после успешной проверки текста,
+     *          при ошибке очищается без освобождения памяти.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param s Исходный текст
+     * @param out Строка результата
+     * @param decrypting true для расшифровывания, false для зашифровывания
+     * @return Результат проверки текста
+     */
+    template <typename Char>
+    textStatus tryTransform(std::basic_string_view<Char> s, std::basic_string<Char>& out, bool decrypting) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @details Обёртка над encryptStatus, сообщающая об ошибке исключением,
+     *          либо permuteParallel для нескольких потоков.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    template <typename Char>
+    size_t encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity, unsigned threads = 1) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @details Обёртка над decryptStatus, сообщающая об ошибке исключением,
+     *          либо permuteParallel для нескольких потоков.
+     * @tparam Char wchar_t для широких строк или char для UTF-8
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    template <typename Char>
+    size_t decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity, unsigned threads = 1) const;
 
     /**
      * @brief Валидация длины текста относительно ключа
-     * @param text Проверяемый текст
+     * @param length Длина проверяемого текста
      * @param operation Название операции (для сообщения об ошибке)
      * @throw tableCipher_error Если длина текста недостаточна для операции
      */
-    void validateTextLength(const std::wstring& text, const std::string& operation);
+    void validateTextLength(size_t length, const std::string& operation) const;
 
 public:
     /**
@@ -102,6 +346,25 @@ public:
      */
     tableCipher(int k);
 
+    /**
+     * @brief Конструктор с установкой ключа и кэша планов
+     * @details Зашифровывание и расшифровывание выполняются по планам из кэша.
+     *          Кэш должен существовать, пока существует шифратор.
+     * @param k Ключ шифрования (количество столбцов)
+     * @param cache Кэш планов перестановки
+     * @throw tableCipher_error Если ключ невалиден
+     */
+    tableCipher(int k, tablePlanCache& cache);
+
+    /**
+     * @brief Построение маршрута перестановки
+     * @details route[q] - позиция в открытом тексте буквы шифртекста с номером q
+     * @param k Количество столбцов
+     * @param length Длина текста
+     * @param route Массив маршрута, заполняется length индексами
+     */
+    static void buildRoute(int k, size_t length, std::vector<uint32_t>& route);
+
     /**
      * @brief Метод зашифровывания
      * @param open_text Открытый текст для шифрования
@@ -117,4 +380,280 @@ public:
      * @throw tableCipher_error Если текст пустой или недостаточной длины
      */
     std::wstring decrypt(const std::wstring& cipher_text);
+
+    /**
+     * @brief Многопоточный метод зашифровывания
+     * @details Результат совпадает с однопоточным encrypt при любом числе потоков.
+     *          Тексты короче parallelThreshold обрабатываются в одном потоке.
+     * @param open_text Открытый текст для шифрования
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Зашифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::wstring encrypt(const std::wstring& open_text, unsigned threads);
+
+    /**
+     * @brief Многопоточный метод расшифровывания
+     * @details Результат совпадает с однопоточным decrypt при любом числе потоков.
+     *          Тексты короче parallelThreshold обрабатываются в одном потоке.
+     * @param cipher_text Зашифрованный текст для расшифрования
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Расшифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::wstring decrypt(const std::wstring& cipher_text, unsigned threads);
+
+    /**
+     * @brief Метод зашифровывания текста в кодировке UTF-8
+     * @details Результат записывается в одну заранее выделенную строку и
+     *          совпадает с encrypt для того же текста в wstring.
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Метод расшифровывания текста в кодировке UTF-8
+     * @details Результат записывается в одну заранее выделенную строку и
+     *          совпадает с decrypt для того же текста в wstring.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Многопоточный метод зашифровывания текста в кодировке UTF-8
+     * @details Результат совпадает с однопоточным encrypt при любом числе потоков
+     * @param open_text Открытый текст в UTF-8
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Зашифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string encrypt(std::string_view open_text, unsigned threads);
+
+    /**
+     * @brief Многопоточный метод расшифровывания текста в кодировке UTF-8
+     * @details Результат совпадает с однопоточным decrypt при любом числе потоков
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param threads Количество потоков, 0 - по числу ядер процессора
+     * @return Расшифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string decrypt(std::string_view cipher_text, unsigned threads);
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @details Не выделяет память в куче. Результат совпадает с encrypt.
+     *          Если размер результата больше capacity, буфер не заполняется,
+     *          и вызов можно повторить с буфером нужного размера. Буфера
+     *          размером с открытый текст всегда достаточно.
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата в символах
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @details Не выделяет память в куче. Результат совпадает с decrypt.
+     *          Буфера размером с зашифрованный текст всегда достаточно.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата в символах
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+     * @details Не выделяет память в куче. Буфера размером с открытый текст
+     *          всегда достаточно.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата в байтах
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t encryptInto(std::string_view open_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+     * @details Не выделяет память в куче. Буфера размером с зашифрованный
+     *          текст всегда достаточно.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата в байтах
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t decryptInto(std::string_view cipher_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего без исключений
+     * @details Ошибки текста возвращаются в result.status, на этом пути память
+     *          в куче не выделяется и строки сообщений не формируются.
+     *          Исключение возможно только при нехватке памяти для перестановки
+     *          длинного текста. Если result.size больше capacity, буфер не
+     *          заполняется.
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Результат проверки и размер результата в символах
+     */
+    result tryEncryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Результат проверки и размер результата в символах
+     */
+    result tryDecryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryEncryptInto(std::string_view open_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего без исключений
+     * @details Аналогично tryEncryptInto.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Результат проверки и размер результата в байтах
+     */
+    result tryDecryptInto(std::string_view cipher_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание в строку вызывающего без исключений
+     * @details Результат совпадает с encrypt. Строка увеличивается только
+     *          после успешной проверки текста; при ошибке она очищается без
+     *          освобождения памяти, поэтому повторно используемая строка
+     *          не выделяет память ни при ошибках, ни при тексте не длиннее
+     *          прежнего.
+     * @param open_text Открытый текст
+     * @param out Зашифрованный текст, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryEncrypt(std::wstring_view open_text, std::wstring& out) const;
+
+    /**
+     * @brief Расшифровывание в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param cipher_text Зашифрованный текст
+     * @param out Расшифрованный текст, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryDecrypt(std::wstring_view cipher_text, std::wstring& out) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param open_text Открытый текст в UTF-8
+     * @param out Зашифрованный текст в UTF-8, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryEncrypt(std::string_view open_text, std::string& out) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в строку вызывающего без исключений
+     * @details Аналогично tryEncrypt.
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Расшифрованный текст в UTF-8, при ошибке - пустая строка
+     * @return Результат проверки текста
+     */
+    textStatus tryDecrypt(std::string_view cipher_text, std::string& out) const;
+
+    /**
+     * @brief Пакетное зашифровывание сообщений в UTF-8
+     * @details Сообщение i занимает в text байты [offsets[i], offsets[i + 1]).
+     *          Все результаты записываются подряд в arena, результат i занимает
+     *          байты [arenaOffsets[i], arenaOffsets[i + 1]). Ошибка в сообщении
+     *          не прерывает пакет: её код записывается в status[i], а результат
+     *          сообщения остаётся пустым. Буферы arena, arenaOffsets и status
+     *          изменяются в размере и при повторном использовании не
+     *          выделяют память заново.
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно зашифрованных сообщений
+     */
+    size_t encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const;
+
+    /**
+     * @brief Пакетное расшифровывание сообщений в UTF-8
+     * @details Аналогично encryptBatch.
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно расшифрованных сообщений
+     */
+    size_t decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<textStatus>& status) const;
+
+    /**
+     * @brief Текст ошибки по результату проверки
+     * @details Для tooShort выбрасываемое сообщение дополняется длиной текста и ключом
+     * @param status Результат проверки
+     * @return Сообщение об ошибке; для ok - пустая строка
+     */
+    static const char* statusMessage(textStatus status);
+
+    /**
+     * @brief Текст ошибки недостаточной длины текста
+     * @param length Количество букв текста
+     * @param k Ключ (количество столбцов)
+     * @param operation Название операции: encryption или decryption
+     * @return Сообщение, с которым выбрасывается tableCipher_error
+     */
+    static std::string lengthMessage(size_t length, int k, const std::string& operation);
+
+    /**
+     * @brief Валидация ключа
+     * @details Проверка конструктора, доступная без создания шифра:
+     *          допустимы ключи от 3.
+     * @param k Проверяемый ключ
+     * @throw tableCipher_error Если ключ невалиден
+     */
+    static void validateKey(int k);
+
+    /**
+     * @brief Снимок счётчиков модуля
+     * @details Счётчики ведутся только при сборке с -DCIPHER_STATS, иначе
+     *          снимок нулевой. Вызовы и отказы по причинам (индекс -
+     *          значение textStatus) считаются во всех интерфейсах, сообщения
+     *          пакета - по одному. Проверка текста - отдельный проход и
+     *          учитывается как validate; перестановка разбирает текст,
+     *          приводит регистр и пишет результат в том же проходе, поэтому
+     *          всё это время учитывается как transform. Только многопоточный
+     *          режим собирает буквы в верхнем регистре без пробелов отдельным
+     *          проходом и учитывает его как normalize.
+     * @return Сумма счётчиков всех потоков
+     */
+    static cipherCounters statsSnapshot();
+
+    /**
+     * @brief Обнуление счётчиков модуля
+     */
+    static void resetStats();
 };
@@ -0,0 +1,161 @@
+/**
+ * @file tableCipherFixed.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация выбора специализации табличной перестановки по ключу
+ */
+
+#include "tableCipherFixed.h"
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Функции специализации для ключа K
+ */
+template <int K>
+constexpr tableCipherDispatch::routes routesFor = {
+    &tableCipherFixed<K>::encryptInto,
+    &tableCipherFixed<K>::decryptInto,
+    &tableCipherFixed<K>::encryptInto,
+    &tableCipherFixed<K>::decryptInto,
+};
+
+/**
+ * @brief Таблица специализаций для ключей minKey..maxKey
+ */
+template <int... I>
+constexpr const tableCipherDispatch::routes* routeTable[] = {
+    &routesFor<tableCipherDispatch::minKey + I>...,
+};
+
+/**
+ * @brief Выбор таблицы специализаций по последовательности индексов
+ */
+template <int... I>
+constexpr const tableCipherDispatch::routes* const* makeRouteTable(std::integer_sequence<int, I...>)
+{
+    return routeTable<I...>;
+}
+
+/// Специализации, индекс - ключ минус minKey
+constexpr const tableCipherDispatch::routes* const* fixedRoutes =
+    makeRouteTable(std::make_integer_sequence<int, tableCipherDispatch::maxKey - tableCipherDispatch::minKey + 1>());
+
+} // namespace
+
+/**
+ * @brief Конструктор с выбором специализации
+ * @param k Ключ шифрования (количество столбцов)
+ * @throw tableCipher_error Если ключ невалиден
+ */
+tableCipherDispatch::tableCipherDispatch(int k)
+    : generic(k), fixed(k >= minKey && k <= maxKey ? fixedRoutes[k - minKey] : nullptr)
+{
+}
+
+/**
+ * @brief Зашифровывание
+ * @param open_text Открытый текст
+ * @return Зашифрованная строка
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::wstring tableCipherDispatch::encrypt(const std::wstring& open_text) const
+{
+    std::wstring result(open_text.size(), L'\0');
+    result.resize(encryptInto(std::wstring_view(open_text), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Расшифровывание
+ * @param cipher_text Зашифрованный текст
+ * @return Расшифрованная строка
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::wstring tableCipherDispatch::decrypt(const std::wstring& cipher_text) const
+{
+    std::wstring result(cipher_text.size(), L'\0');
+    result.resize(decryptInto(std::wstring_view(cipher_text), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Зашифровывание текста в кодировке UTF-8
+ * @param open_text Открытый текст в UTF-8
+ * @return Зашифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipherDispatch::encrypt(std::string_view open_text) const
+{
+    std::string result(open_text.size(), '\0');
+    result.resize(encryptInto(open_text, &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Расшифровывание текста в кодировке UTF-8
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @return Расшифрованная строка в UTF-8
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+std::string tableCipherDispatch::decrypt(std::string_view cipher_text) const
+{
+    std::string result(cipher_text.size(), '\0');
+    result.resize(decryptInto(cipher_text, &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Зашифровывание в буфер вызывающего
+ * @param open_text Открытый текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipherDispatch::encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const
+{
+    return fixed ? fixed->encryptWide(open_text, out, capacity) : generic.encryptInto(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание в буфер вызывающего
+ * @param cipher_text Зашифрованный текст
+ * @param out Буфер результата
+ * @param capacity Размер буфера в символах
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipherDispatch::decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const
+{
+    return fixed ? fixed->decryptWide(cipher_text, out, capacity) : generic.decryptInto(cipher_text, out, capacity);
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+ * @param open_text Открытый текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipherDispatch::encryptInto(std::string_view open_text, char* out, size_t capacity) const
+{
+    return fixed ? fixed->encryptUtf8(open_text, out, capacity) : generic.encryptInto(open_text, out, capacity);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+ * @param cipher_text Зашифрованный текст в UTF-8
+ * @param out Буфер результата
+ * @param capacity Размер буфера в байтах
+ * @return Размер результата; если он больше capacity, буфер не заполняется
+ * @throw tableCipher_error Если текст пустой или недостаточной длины
+ */
+size_t tableCipherDispatch::decryptInto(std::string_view cipher_text, char* out, size_t capacity) const
+{
+    return fixed ? fixed->decryptUtf8(cipher_text, out, capacity) : generic.decryptInto(cipher_text, out, capacity);
+}
@@ -0,0 +1,484 @@
+/**
+ * @file tableCipherFixed.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Табличная перестановка с количеством столбцов, заданным на этапе компиляции
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include "tableCipher.h"
+#include "../common/russianText.h"
+
+/**
+ * @brief Табличная маршрутная перестановка с ключом K на этапе компиляции
+ * @details Маршрут и результат те же, что у tableCipher(K), ошибки в тексте
+ *          сообщаются тем же tableCipher_error с тем же сообщением, а неверный
+ *          ключ не компилируется с сообщением validateKey. Объект не хранит
+ *          состояния, все методы статические.
+ *
+ *          Таблица обходится по строкам: буквы строки записываются в K
+ *          столбцов шифртекста через K указателей, каждый из которых
+ *          продвигается на одну букву за строку, поэтому вместо вычисления
+ *          позиции i * key + j на каждую букву остаются K последовательных
+ *          потоков записи (при расшифровывании - чтения). При K до 16 все
+ *          потоки одновременно помещаются в кэш, и перестановка идёт за
+ *          один проход без промежуточного буфера при любой длине текста.
+ * @tparam K Количество столбцов
+ */
+template <int K>
+class tableCipherFixed
+{
+public:
+    static_assert(K > 0, "Неверный ключ: Ключ должен быть положительным числом.");
+    static_assert(K != 1 && K != 2, "Неверный ключ: ключ не может быть 1 или 2 (слишком слабый для шифрования)");
+
+    static constexpr size_t key = K; ///< Количество столбцов
+
+private:
+    /**
+     * @brief Количество единиц строки на одну букву
+     */
+    template <typename Char>
+    static constexpr size_t units = sizeof(Char) == 1 ? 2 : 1;
+
+    /**
+     * @brief Очередной символ текста
+     * @param p Текущая позиция, сдвигается за символ
+     * @param end Конец текста
+     * @return Кодовая точка
+     */
+    template <typename Char>
+    static char32_t nextChar(const Char*& p, const Char* end)
+    {
+        if constexpr (sizeof(Char) == 1) {
+            return russianText::decodeUtf8(p, end);
+        } else {
+            return static_cast<char32_t>(*p++);
+        }
+    }
+
+    /**
+     * @brief Очередная буква проверенного текста в верхнем регистре
+     * @param p Текущая позиция, сдвигается за букву и пробелы перед ней
+     * @param end Конец текста
+     * @return Заглавная буква
+     */
+    template <typename Char>
+    static char32_t nextLetter(const Char*& p, const Char* end)
+    {
+        char32_t c;
+        do {
+            c = nextChar(p, end);
+        } while (c == U' ');
+        return russianText::toUpper(c);
+    }
+
+    /**
+     * @brief Запись буквы
+     * @param c Заглавная буква
+     * @param out Позиция записи
+     */
+    static void putLetter(char32_t c, wchar_t* out)
+    {
+        *out = static_cast<wchar_t>(c);
+    }
+
+    /**
+     * @brief Запись буквы в UTF-8
+     * @param c Заглавная буква
+     * @param out Позиция записи двух байтов
+     */
+    static void putLetter(char32_t c, char* out)
+    {
+        russianText::encodeLetter(c, out);
+    }
+
+    /**
+     * @brief Проверка текста и подсчёт его букв
+     * @details Проверки и их порядок те же, что у tableCipher
+     * @param s Исходный текст
+     * @param operation Название операции (для сообщения об ошибке)
+     * @return Количество букв
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы,
+     *        только пробелы или букв не больше, чем столбцов
+     */
+    template <typename Char>
+    static size_t checkText(std::basic_string_view<Char> s, const char* operation)
+    {
+        if (s.empty()) {
+            throw tableCipher_error(tableCipher::statusMessage(tableCipher::textStatus::emptyText));
+        }
+        size_t letters = 0;
+        const Char* end = s.data() + s.size();
+        for (const Char* p = s.data(); p != end;) {
+            char32_t c = nextChar(p, end);
+            if (c == U' ') {
+                continue;
+            }
+            if (!russianText::isLetter(c)) {
+                throw tableCipher_error(tableCipher::statusMessage(tableCipher::textStatus::invalidText));
+            }
+            letters++;
+        }
+        if (letters == 0) {
+            throw tableCipher_error(tableCipher::statusMessage(tableCipher::textStatus::onlySpaces));
+        }
+        if (letters <= key) {
+            throw tableCipher_error(tableCipher::lengthMessage(letters, K, operation));
+        }
+        return letters;
+    }
+
+    /**
+     * @brief Начала столбцов в шифртексте
+     * @details Столбцы считываются справа налево; первые full столбцов
+     *          содержат rows букв, остальные - rows - 1.
+     * @param rows Количество строк таблицы
+     * @param full Количество полных столбцов
+     * @param start Позиция первой буквы каждого столбца
+     */
+    static void columnStarts(size_t rows, size_t full, size_t (&start)[K])
+    {
+        for (size_t j = 0; j < key; j++) {
+            start[j] = j >= full ? (key - 1 - j) * (rows - 1) : (key - full) * (rows - 1) + (full - 1 - j) * rows;
+        }
+    }
+
+    /**
+     * @brief Перестановка проверенного открытого текста
+     * @param s Открытый текст
+     * @param text_len Количество букв
+     * @param out Буфер результата на text_len букв
+     */
+    template <typename Char>
+    static void encryptLetters(std::basic_string_view<Char> s, size_t text_len, Char* out)
+    {
+        const size_t rows = (text_len + key - 1) / key;
+        const size_t full = text_len - (rows - 1) * key;
+        size_t start[K];
+        columnStarts(rows, full, start);
+        Char* column[K];
+        for (size_t j = 0; j < key; j++) {
+            column[j] = out + units<Char> * start[j];
+        }
+
+        const Char* p = s.data();
+        const Char* end = p + s.size();
+        for (size_t i = 0; i + 1 < rows; i++) {
+            for (size_t j = 0; j < key; j++) {
+                putLetter(nextLetter(p, end), column[j]);
+                column[j] += units<Char>;
+            }
+        }
+        for (size_t j = 0; j < full; j++) {
+            putLetter(nextLetter(p, end), column[j]);
+        }
+    }
+
+    /**
+     * @brief Обратная перестановка проверенного шифртекста
+     * @param s Шифртекст
+     * @param text_len Количество букв
+     * @param out Буфер результата на text_len букв
+     */
+    template <typename Char>
+    static void decryptLetters(std::basic_string_view<Char> s, size_t text_len, Char* out)
+    {
+        const size_t rows = (text_len + key - 1) / key;
+        const size_t full = text_len - (rows - 1) * key;
+        size_t start[K];
+        columnStarts(rows, full, start);
+
+        // Без пробелов начало столбца вычисляется, иначе находится одним проходом
+        const Char* cursor[K];
+        const Char* p = s.data();
+        const Char* end = p + s.size();
+        if (s.size() == units<Char> * text_len) {
+            for (size_t j = 0; j < key; j++) {
+                cursor[j] = p + units<Char> * start[j];
+            }
+        } else {
+            for (size_t j = key; j-- > 0;) {
+                cursor[j] = p;
+                const size_t height = j < full ? rows : rows - 1;
+                for (size_t i = 0; i < height;) {
+                    i += nextChar(p, end) != U' ';
+                }
+            }
+        }
+
+        for (size_t i = 0; i + 1 < rows; i++) {
+            for (size_t j = 0; j < key; j++) {
+                putLetter(nextLetter(cursor[j], end), out);
+                out += units<Char>;
+            }
+        }
+        for (size_t j = 0; j < full; j++) {
+            putLetter(nextLetter(cursor[j], end), out);
+            out += units<Char>;
+        }
+    }
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    template <typename Char>
+    static size_t encryptTo(std::basic_string_view<Char> open_text, Char* out, size_t capacity)
+    {
+        const size_t text_len = checkText(open_text, "encryption");
+        if (capacity >= units<Char> * text_len) {
+            encryptLetters(open_text, text_len, out);
+        }
+        return units<Char> * text_len;
+    }
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах Char
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    template <typename Char>
+    static size_t decryptTo(std::basic_string_view<Char> cipher_text, Char* out, size_t capacity)
+    {
+        const size_t text_len = checkText(cipher_text, "decryption");
+        if (capacity >= units<Char> * text_len) {
+            decryptLetters(cipher_text, text_len, out);
+        }
+        return units<Char> * text_len;
+    }
+
+public:
+    /**
+     * @brief Зашифровывание
+     * @param open_text Открытый текст
+     * @return Зашифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static std::wstring encrypt(const std::wstring& open_text)
+    {
+        std::wstring result(open_text.size(), L'\0');
+        result.resize(encryptTo(std::wstring_view(open_text), &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывание
+     * @param cipher_text Зашифрованный текст
+     * @return Расшифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static std::wstring decrypt(const std::wstring& cipher_text)
+    {
+        std::wstring result(cipher_text.size(), L'\0');
+        result.resize(decryptTo(std::wstring_view(cipher_text), &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Зашифровывание текста в кодировке UTF-8
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static std::string encrypt(std::string_view open_text)
+    {
+        std::string result(open_text.size(), '\0');
+        result.resize(encryptTo(open_text, &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывание текста в кодировке UTF-8
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static std::string decrypt(std::string_view cipher_text)
+    {
+        std::string result(cipher_text.size(), '\0');
+        result.resize(decryptTo(cipher_text, &result[0], result.size()));
+        return result;
+    }
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static size_t encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity)
+    {
+        return encryptTo(open_text, out, capacity);
+    }
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static size_t decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity)
+    {
+        return decryptTo(cipher_text, out, capacity);
+    }
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static size_t encryptInto(std::string_view open_text, char* out, size_t capacity)
+    {
+        return encryptTo(open_text, out, capacity);
+    }
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    static size_t decryptInto(std::string_view cipher_text, char* out, size_t capacity)
+    {
+        return decryptTo(cipher_text, out, capacity);
+    }
+};
+
+/**
+ * @brief Выбор специализации tableCipherFixed по ключу во время выполнения
+ * @details Для ключей minKey..maxKey вызовы направляются в tableCipherFixed<K>,
+ *          для остальных - в обычный tableCipher. Ключ проверяется так же,
+ *          как в конструкторе tableCipher, результат и ошибки совпадают.
+ */
+class tableCipherDispatch
+{
+public:
+    static constexpr int minKey = 3; ///< Наименьший ключ со специализацией
+    static constexpr int maxKey = 16; ///< Наибольший ключ со специализацией
+
+    /**
+     * @brief Функции одной специализации
+     */
+    struct routes {
+        size_t (*encryptWide)(std::wstring_view, wchar_t*, size_t); ///< encryptInto для wchar_t
+        size_t (*decryptWide)(std::wstring_view, wchar_t*, size_t); ///< decryptInto для wchar_t
+        size_t (*encryptUtf8)(std::string_view, char*, size_t); ///< encryptInto для UTF-8
+        size_t (*decryptUtf8)(std::string_view, char*, size_t); ///< decryptInto для UTF-8
+    };
+
+private:
+    tableCipher generic; ///< Шифратор для ключей без специализации
+    const routes* fixed; ///< Функции специализации или nullptr
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    tableCipherDispatch() = delete;
+
+    /**
+     * @brief Конструктор с выбором специализации
+     * @param k Ключ шифрования (количество столбцов)
+     * @throw tableCipher_error Если ключ невалиден
+     */
+    explicit tableCipherDispatch(int k);
+
+    /**
+     * @brief Проверка, что для ключа есть специализация
+     * @return true, если вызовы идут в tableCipherFixed
+     */
+    bool specialized() const { return fixed != nullptr; }
+
+    /**
+     * @brief Зашифровывание
+     * @param open_text Открытый текст
+     * @return Зашифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::wstring encrypt(const std::wstring& open_text) const;
+
+    /**
+     * @brief Расшифровывание
+     * @param cipher_text Зашифрованный текст
+     * @return Расшифрованная строка
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::wstring decrypt(const std::wstring& cipher_text) const;
+
+    /**
+     * @brief Зашифровывание текста в кодировке UTF-8
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Расшифровывание текста в кодировке UTF-8
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Зашифровывание в буфер вызывающего
+     * @param open_text Открытый текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t encryptInto(std::wstring_view open_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание в буфер вызывающего
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param capacity Размер буфера в символах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t decryptInto(std::wstring_view cipher_text, wchar_t* out, size_t capacity) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8 в буфер вызывающего
+     * @param open_text Открытый текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t encryptInto(std::string_view open_text, char* out, size_t capacity) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8 в буфер вызывающего
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @param out Буфер результата
+     * @param capacity Размер буфера в байтах
+     * @return Размер результата; если он больше capacity, буфер не заполняется
+     * @throw tableCipher_error Если текст пустой или недостаточной длины
+     */
+    size_t decryptInto(std::string_view cipher_text, char* out, size_t capacity) const;
+};
@@ -0,0 +1,96 @@
+/**
+ * @file tablePlanCache.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация кэша планов перестановки
+ */
+
+#include "tablePlanCache.h"
+#include "tableCipher.h"
+#include <limits>
+
+/**
+ * @brief Конструктор с ограничением объёма
+ * @param bytes Наибольший объём планов в байтах
+ */
+tablePlanCache::tablePlanCache(size_t bytes) : maxBytes(bytes)
+{
+}
+
+/**
+ * @brief Получение плана
+ * @param key Количество столбцов
+ * @param length Длина текста
+ * @return План или nullptr, если план больше объёма кэша
+ */
+std::shared_ptr<const tablePlanCache::plan> tablePlanCache::get(int key, size_t length)
+{
+    const planKey k(key, length);
+    const size_t bytes = length * sizeof(uint32_t);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = index.find(k);
+        if (found != index.end()) {
+            counters.hits++;
+            lru.splice(lru.begin(), lru, found->second);
+            return found->second->second;
+        }
+        if (bytes > maxBytes || length > std::numeric_limits<uint32_t>::max()) {
+            counters.bypasses++;
+            return nullptr;
+        }
+    }
+
+    // План строится без блокировки, чтобы не задерживать другие потоки
+    auto built = std::make_shared<plan>();
+    built->key = key;
+    built->length = length;
+    tableCipher::buildRoute(key, length, built->route);
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = index.find(k);
+    if (found != index.end()) {
+        // План уже построен другим потоком
+        counters.hits++;
+        lru.splice(lru.begin(), lru, found->second);
+        return found->second->second;
+    }
+    counters.misses++;
+    while (counters.bytes + bytes > maxBytes && !lru.empty()) {
+        counters.bytes -= lru.back().second->length * sizeof(uint32_t);
+        index.erase(lru.back().first);
+        lru.pop_back();
+        counters.evictions++;
+    }
+    lru.emplace_front(k, built);
+    index[k] = lru.begin();
+    counters.bytes += bytes;
+    counters.entries = lru.size();
+    return built;
+}
+
+/**
+ * @brief Снимок счётчиков
+ * @return Счётчики кэша
+ */
+tablePlanCache::stats tablePlanCache::snapshot() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    stats result = counters;
+    result.entries = lru.size();
+    return result;
+}
+
+/**
+ * @brief Очистка кэша
+ */
+void tablePlanCache::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    lru.clear();
+    index.clear();
+    counters.bytes = 0;
+    counters.entries = 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file tablePlanCache.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для кэша планов перестановки
+ */
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Кэш планов табличной маршрутной перестановки
+ * @details План для пары (ключ, длина текста) - массив индексов маршрута:
+ *          буква шифртекста с номером q берётся из позиции route[q] открытого
+ *          текста. С планом зашифровывание становится одной выборкой по
+ *          индексам, а расшифровывание - одной записью по индексам.
+ *          Объём кэша ограничен в байтах, при переполнении вытесняются давно
+ *          не использованные планы. Кэш можно разделять между потоками.
+ */
+class tablePlanCache
+{
+public:
+    /**
+     * @brief Скомпилированный план перестановки
+     */
+    struct plan {
+        int key; ///< Количество столбцов
+        size_t length; ///< Длина текста
+        std::vector<uint32_t> route; ///< Позиция в открытом тексте по номеру буквы шифртекста
+    };
+
+    /**
+     * @brief Счётчики кэша
+     */
+    struct stats {
+        unsigned long long hits = 0; ///< Найденные в кэше планы
+        unsigned long long misses = 0; ///< Построенные и помещённые в кэш планы
+        unsigned long long evictions = 0; ///< Вытесненные планы
+        unsigned long long bypasses = 0; ///< Запросы планов, не помещающихся в кэш
+        size_t entries = 0; ///< Количество планов в кэше
+        size_t bytes = 0; ///< Объём планов в кэше в байтах
+    };
+
+private:
+    using planKey = std::pair<int, size_t>; ///< Ключ плана: (ключ шифра, длина текста)
+    using entry = std::pair<planKey, std::shared_ptr<const plan>>; ///< Элемент списка LRU
+
+    size_t maxBytes; ///< Наибольший объём планов в байтах
+    std::list<entry> lru; ///< Планы от недавно использованных к давно не использованным
+    std::map<planKey, std::list<entry>::iterator> index; ///< Поиск плана в списке
+    stats counters; ///< Счётчики
+    mutable std::mutex lock; ///< Защита от одновременного доступа
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    tablePlanCache() = delete;
+
+    /**
+     * @brief Конструктор с ограничением объёма
+     * @param bytes Наибольший объём планов в байтах
+     */
+    explicit tablePlanCache(size_t bytes);
+
+    /**
+     * @brief Получение плана
+     * @details При промахе план строится и помещается в кэш
+     * @param key Количество столбцов
+     * @param length Длина текста
+     * @return План или nullptr, если план больше объёма кэша
+     */
+    std::shared_ptr<const plan> get(int key, size_t length);
+
+    /**
+     * @brief Снимок счётчиков
+     * @return Счётчики кэша
+     */
+    stats snapshot() const;
+
+    /**
+     * @brief Очистка кэша
+     * @details Счётчики попаданий и промахов сохраняются
+     */
+    void clear();
+};
@@ -1,8 +1,21 @@
 #include <UnitTest++/UnitTest++.h>
 #include "tableCipher.h"
+#include "tablePlanCache.h"
+#include "tableCipherFixed.h"
+#include "tableAnalyzer.h"
+#include "tableBlockPipeline.h"
+#include "../common/russianText.h"
+#include "../common/filePipeline.h"
+#include "../common/testAllocations.h"
+#include <algorithm>
 #include <iostream>
 #include <locale>
 #include <codecvt>
+#include <random>
+#include <utility>
+#include <vector>
+#include <cstdio>
+#include <unistd.h>
 
 // Макрос для сравнения wstring с правильной конвертацией в string для вывода ошибок
 #define CHECK_EQUAL_WSTR(expected, actual) \
@@ -20,6 +33,22 @@
         } \
     } while(0)
 
+// Перевод строки в UTF-8
+static std::string toUtf8(const std::wstring& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.to_bytes(s);
+}
+
+// Случайный текст из n символов алфавита alpha
+static std::wstring randomText(std::mt19937& rng, const std::wstring& alpha, size_t n) {
+    std::wstring text;
+    text.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        text += alpha[rng() % alpha.size()];
+    }
+    return text;
+}
+
 // Тестовый сценарий для конструктора (KeyTest)
 SUITE(KeyTest) {
     TEST(ValidKey) {
@@ -162,6 +191,820 @@ SUITE(DecryptTest) {
         tableCipher cipher(8);
         CHECK_EQUAL_WSTR(L"ПРОГРАММИРОВАНИЕ", cipher.decrypt(L"МЕМИАНРАГВООРРПИ"));
     }
+
+    TEST(DecryptWideKeysAndLongText) {
+        std::mt19937 rng(8);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::wstring text = randomText(rng, alpha, 200000);
+        for (int key : {3, 7, 64, 1000, 4096, 199999}) {
+            tableCipher cipher(key);
+            CHECK(cipher.decrypt(cipher.encrypt(text)) == text);
+        }
+    }
+
+    TEST(DecryptKeyOneLessThanLength) {
+        tableCipher cipher(8);
+        CHECK_EQUAL_WSTR(L"ММАРГОРПИ", cipher.encrypt(L"ПРОГРАММИ"));
+        CHECK_EQUAL_WSTR(L"ПРОГРАММИ", cipher.decrypt(L"ММАРГОРПИ"));
+    }
+}
+
+// Результат шифрования или текст исключения для сравнения двух интерфейсов
+template <typename F>
+static std::string outcome(F f) {
+    try {
+        return f();
+    } catch (const tableCipher_error& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Тестовый сценарий для интерфейса UTF-8
+SUITE(Utf8Test) {
+    TEST_FIXTURE(Key3_fixture, EncryptUtf8) {
+        CHECK_EQUAL(toUtf8(L"ИТРРЕИПВМ"), p->encrypt(std::string_view(toUtf8(L"Привет Мир"))));
+    }
+
+    TEST_FIXTURE(Key3_fixture, DecryptUtf8) {
+        CHECK_EQUAL(toUtf8(L"ПРИВЕТМИР"), p->decrypt(std::string_view(toUtf8(L"итр реи пвм"))));
+    }
+
+    TEST_FIXTURE(Key3_fixture, InvalidUtf8) {
+        CHECK_THROW(p->encrypt(std::string_view("")), tableCipher_error);
+        CHECK_THROW(p->encrypt(std::string_view("   ")), tableCipher_error);
+        CHECK_THROW(p->encrypt(std::string_view(toUtf8(L"ПРИВЕТ123"))), tableCipher_error);
+        CHECK_THROW(p->decrypt(std::string_view(toUtf8(L"ИТР"))), tableCipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("\xD0\x98\xD0")), tableCipher_error);
+    }
+
+    TEST_FIXTURE(Key3_fixture, OverlongUtf8) {
+        // Буквы А, Б, В, Г тремя байтами вместо двух - не кириллица
+        CHECK_THROW(p->encrypt(std::string_view("\xE0\x90\x90\xE0\x90\x91\xE0\x90\x92\xE0\x90\x93")), tableCipher_error);
+        CHECK_THROW(p->decrypt(std::string_view("\xE0\x90\x90\xE0\x90\x91\xE0\x90\x92\xE0\x90\x93")), tableCipher_error);
+    }
+
+    TEST(MatchesWideApi) {
+        std::mt19937 rng(5);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя      ";
+        for (int n = 0; n < 3000; n++) {
+            tableCipher cipher(3 + rng() % 40);
+            size_t len = rng() % (n < 2000 ? 60 : 5000);
+            std::wstring text = randomText(rng, alpha, len);
+            if (n % 50 == 0 && len > 0) {
+                text[len / 2] = L'1';
+            }
+            std::string utf8 = toUtf8(text);
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                        outcome([&] { return cipher.encrypt(std::string_view(utf8)); }));
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.decrypt(text)); }),
+                        outcome([&] { return cipher.decrypt(std::string_view(utf8)); }));
+        }
+    }
+}
+
+// Тестовый сценарий для методов с буфером вызывающего
+SUITE(IntoTest) {
+    TEST_FIXTURE(Key3_fixture, EncryptInto) {
+        wchar_t out[16];
+        size_t n = p->encryptInto(L"Привет Мира", out, 16);
+        CHECK_EQUAL_WSTR(L"ИТРРЕИПВМА", std::wstring(out, n));
+    }
+
+    TEST_FIXTURE(Key3_fixture, DecryptInto) {
+        wchar_t out[16];
+        size_t n = p->decryptInto(L"итр реи пвм а", out, 16);
+        CHECK_EQUAL_WSTR(L"ПРИВЕТМИРА", std::wstring(out, n));
+    }
+
+    TEST_FIXTURE(Key3_fixture, ReportsNeededSize) {
+        wchar_t out[4] = {L'x', L'x', L'x', L'x'};
+        CHECK_EQUAL(10u, p->encryptInto(L"Привет Мира", out, 4));
+        CHECK_EQUAL(10u, p->decryptInto(L"ИТРРЕИПВМА", out, 4));
+        CHECK(out[0] == L'x');
+        char bytes[8];
+        CHECK_EQUAL(20u, p->encryptInto(std::string_view(toUtf8(L"Привет Мира")), bytes, 8));
+    }
+
+    TEST_FIXTURE(Key3_fixture, InvalidText) {
+        wchar_t out[16];
+        CHECK_THROW(p->encryptInto(L"", out, 16), tableCipher_error);
+        CHECK_THROW(p->encryptInto(L"   ", out, 16), tableCipher_error);
+        CHECK_THROW(p->encryptInto(L"ПРИВЕТ123", out, 16), tableCipher_error);
+        CHECK_THROW(p->decryptInto(L"ИТР", out, 16), tableCipher_error);
+        CHECK_THROW(p->decryptInto(L"ИТР", out, 0), tableCipher_error);
+    }
+
+    TEST(MatchesEncrypt) {
+        std::mt19937 rng(11);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя ";
+        std::vector<wchar_t> out(5000);
+        for (int n = 0; n < 500; n++) {
+            tableCipher cipher(3 + rng() % 60);
+            size_t len = 64 + rng() % 4000;
+            std::wstring text = randomText(rng, alpha, len);
+            std::wstring expected = cipher.encrypt(text);
+            CHECK(std::wstring(out.data(), cipher.encryptInto(text, out.data(), out.size())) == expected);
+            CHECK(std::wstring(out.data(), cipher.decryptInto(expected, out.data(), out.size())) == cipher.decrypt(expected));
+        }
+    }
+
+    TEST(NoHeapAllocations) {
+        tableCipher cipher(5);
+        const std::wstring text = L"Съешь же ещё этих мягких французских булок да выпей чаю";
+        const std::string utf8 = toUtf8(text);
+        wchar_t wide[128];
+        wchar_t wideBack[128];
+        char bytes[256];
+        char bytesBack[256];
+        const size_t before = allocationCount;
+        for (int i = 0; i < 1000; i++) {
+            size_t n = cipher.encryptInto(text, wide, 128);
+            cipher.decryptInto(std::wstring_view(wide, n), wideBack, 128);
+            n = cipher.encryptInto(std::string_view(utf8), bytes, sizeof bytes);
+            cipher.decryptInto(std::string_view(bytes, n), bytesBack, sizeof bytesBack);
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Эталонное зашифровывание через таблицу строк
+static std::wstring tableReference(const std::wstring& text, int key) {
+    const int rows = (static_cast<int>(text.size()) + key - 1) / key;
+    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
+    for (size_t index = 0; index < text.size(); index++) {
+        table[index / key][index % key] = text[index];
+    }
+    std::wstring result;
+    for (int j = key - 1; j >= 0; j--) {
+        for (int i = 0; i < rows; i++) {
+            if (table[i][j] != L' ') {
+                result += table[i][j];
+            }
+        }
+    }
+    return result;
+}
+
+// Тестовый сценарий для блочной перестановки длинных текстов (BlockedTest)
+SUITE(BlockedTest) {
+    TEST(MatchesTableReference) {
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::mt19937 rng(10);
+        std::wstring text = randomText(rng, alpha, (1 << 16) + 777);
+        for (int key : {3, 7, 63, 64, 65, 200, 4096}) {
+            tableCipher cipher(key);
+            std::wstring expected = tableReference(text, key);
+            CHECK(cipher.encrypt(text) == expected);
+            CHECK(cipher.decrypt(expected) == text);
+            CHECK(cipher.encrypt(std::string_view(toUtf8(text))) == toUtf8(expected));
+            CHECK(cipher.decrypt(std::string_view(toUtf8(expected))) == toUtf8(text));
+        }
+    }
+
+    TEST(KeyCloseToLength) {
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::mt19937 rng(12);
+        std::wstring text = randomText(rng, alpha, (1 << 16) + 777);
+        const int length = text.size();
+        for (int key : {length / 64 + 1, length / 2, length - 1}) {
+            tableCipher cipher(key);
+            std::wstring expected = tableReference(text, key);
+            CHECK(cipher.encrypt(text) == expected);
+            CHECK(cipher.decrypt(expected) == text);
+        }
+    }
+
+    TEST(ThresholdBoundary) {
+        const std::wstring alpha = L"абвгдеёжзийклмнопрстуфхцчшщъыьэюя ";
+        std::mt19937 rng(11);
+        for (int length : {(1 << 16) - 1, 1 << 16, (1 << 16) + 1}) {
+            std::wstring text;
+            size_t letters = 0;
+            while (letters < static_cast<size_t>(length)) {
+                wchar_t c = alpha[rng() % alpha.size()];
+                text += c;
+                letters += c != L' ';
+            }
+            tableCipher cipher(101);
+            std::wstring upper;
+            for (wchar_t c : text) {
+                if (c != L' ') {
+                    upper += c == L'ё' ? L'Ё' : static_cast<wchar_t>(c - 0x20);
+                }
+            }
+            std::wstring expected = tableReference(upper, 101);
+            CHECK(cipher.encrypt(text) == expected);
+            CHECK(cipher.decrypt(expected) == upper);
+            std::wstring spaced = L"  ";
+            for (size_t i = 0; i < expected.size(); i++) {
+                spaced += expected[i];
+                if (i % 7 == 0) {
+                    spaced += L"  ";
+                }
+            }
+            CHECK(cipher.decrypt(spaced) == upper);
+            CHECK(cipher.decrypt(std::string_view(toUtf8(spaced))) == toUtf8(upper));
+        }
+    }
+}
+
+// Тестовый сценарий для многопоточного режима (ParallelTest)
+SUITE(ParallelTest) {
+    TEST(EncryptMatchesSerial) {
+        std::mt19937 rng(12);
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя ";
+        std::wstring text = randomText(rng, alpha, 300000);
+        const std::string utf8 = toUtf8(text);
+        for (int key : {3, 10, 257}) {
+            tableCipher cipher(key);
+            std::wstring expected = cipher.encrypt(text);
+            std::string expectedUtf8 = cipher.encrypt(std::string_view(utf8));
+            for (unsigned threads = 0; threads <= 8; threads++) {
+                CHECK(cipher.encrypt(text, threads) == expected);
+                CHECK(cipher.encrypt(std::string_view(utf8), threads) == expectedUtf8);
+            }
+        }
+    }
+
+    TEST(DecryptMatchesSerial) {
+        std::mt19937 rng(13);
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        std::wstring text = randomText(rng, alpha, 300001);
+        const std::string utf8 = toUtf8(text);
+        for (int key : {4, 64, 4096}) {
+            tableCipher cipher(key);
+            std::wstring expected = cipher.decrypt(text);
+            for (unsigned threads = 0; threads <= 8; threads++) {
+                CHECK(cipher.decrypt(text, threads) == expected);
+                CHECK(cipher.decrypt(std::string_view(utf8), threads) == toUtf8(expected));
+            }
+            CHECK(cipher.encrypt(expected, 4) == text);
+        }
+    }
+
+    TEST(ErrorsMatchSerial) {
+        tableCipher cipher(5);
+        std::wstring spaces(200000, L' ');
+        std::wstring invalid(200000, L'А');
+        invalid[150000] = L'1';
+        std::string broken = toUtf8(std::wstring(200000, L'Б'));
+        broken[250000] = '\xD0';
+        for (const std::wstring& text : {spaces, invalid}) {
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                        outcome([&] { return toUtf8(cipher.encrypt(text, 4)); }));
+            CHECK_EQUAL(outcome([&] { return toUtf8(cipher.decrypt(text)); }),
+                        outcome([&] { return toUtf8(cipher.decrypt(text, 4)); }));
+        }
+        CHECK_EQUAL(outcome([&] { return cipher.encrypt(std::string_view(broken)); }),
+                    outcome([&] { return cipher.encrypt(std::string_view(broken), 4); }));
+    }
+
+    TEST(ShortTextStaysSerial) {
+        tableCipher cipher(3);
+        CHECK_EQUAL_WSTR(L"ИТРРЕИПВМ", cipher.encrypt(L"ПРИВЕТМИР", 8));
+        CHECK_EQUAL_WSTR(L"ПРИВЕТМИР", cipher.decrypt(L"ИТРРЕИПВМ", 8));
+        CHECK_THROW(cipher.encrypt(L"ПРИ", 8), tableCipher_error);
+    }
+}
+
+// Тестовый сценарий для кэша планов перестановки (PlanCacheTest)
+SUITE(PlanCacheTest) {
+    TEST(HitsAndMisses) {
+        tablePlanCache cache(1 << 20);
+        tableCipher cipher(3, cache);
+        CHECK_EQUAL(toUtf8(L"ИТРРЕИПВМ"), cipher.encrypt(std::string_view(toUtf8(L"ПРИВЕТМИР"))));
+        CHECK_EQUAL_WSTR(L"ПРИВЕТМИР", cipher.decrypt(L"ИТРРЕИПВМ"));
+        tablePlanCache::stats counters = cache.snapshot();
+        CHECK_EQUAL(1u, counters.misses);
+        CHECK_EQUAL(1u, counters.hits);
+        CHECK_EQUAL(1u, counters.entries);
+        CHECK_EQUAL(9 * sizeof(uint32_t), counters.bytes);
+    }
+
+    TEST(EvictsLeastRecentlyUsed) {
+        tablePlanCache cache(2 * 10 * sizeof(uint32_t));
+        CHECK(cache.get(3, 10) != nullptr);
+        CHECK(cache.get(4, 10) != nullptr);
+        CHECK(cache.get(3, 10) != nullptr);
+        CHECK(cache.get(5, 10) != nullptr); // Вытесняет план (4, 10)
+        tablePlanCache::stats counters = cache.snapshot();
+        CHECK_EQUAL(1u, counters.evictions);
+        CHECK_EQUAL(2u, counters.entries);
+        cache.get(3, 10);
+        CHECK_EQUAL(counters.hits + 1, cache.snapshot().hits);
+        cache.get(4, 10);
+        CHECK_EQUAL(counters.misses + 1, cache.snapshot().misses);
+    }
+
+    TEST(BypassesOversizedPlan) {
+        tablePlanCache cache(16);
+        tableCipher cipher(3, cache);
+        CHECK(cache.get(3, 100) == nullptr);
+        CHECK_EQUAL(toUtf8(L"ИТРРЕИПВМ"), cipher.encrypt(std::string_view(toUtf8(L"ПРИВЕТМИР"))));
+        tablePlanCache::stats counters = cache.snapshot();
+        CHECK_EQUAL(2u, counters.bypasses);
+        CHECK_EQUAL(0u, counters.entries);
+    }
+
+    TEST(MatchesUncachedCipher) {
+        tablePlanCache cache(1 << 20);
+        const std::wstring letters = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя";
+        std::mt19937 rng(9);
+        for (int key = 3; key <= 12; key++) {
+            tableCipher plain(key);
+            tableCipher cached(key, cache);
+            for (int length = key + 1; length <= 60; length += 7) {
+                std::wstring text = randomText(rng, letters, length);
+                text.insert(length / 2, L" ");
+                const std::string utf8 = toUtf8(text);
+                std::wstring expected = plain.encrypt(text);
+                wchar_t out[64];
+                CHECK(std::wstring(out, cached.encryptInto(text, out, 64)) == expected);
+                CHECK(cached.encrypt(std::string_view(utf8)) == plain.encrypt(std::string_view(utf8)));
+                CHECK(cached.decrypt(expected) == plain.decrypt(expected));
+                CHECK(cached.decrypt(std::string_view(toUtf8(expected))) == plain.decrypt(std::string_view(toUtf8(expected))));
+            }
+        }
+        CHECK(cache.snapshot().hits > 0);
+    }
+
+    TEST(ErrorsUnchanged) {
+        tablePlanCache cache(1 << 20);
+        tableCipher cipher(5, cache);
+        CHECK_THROW(cipher.decrypt(L"ПРИВ"), tableCipher_error);
+        CHECK_THROW(cipher.decrypt(L"ПРИ1ВЕТ"), tableCipher_error);
+        CHECK_EQUAL(0u, cache.snapshot().misses);
+    }
+}
+
+// Сборка пакета сообщений: общий буфер и границы
+static void makeBatch(const std::vector<std::string>& messages, std::string& text, std::vector<size_t>& offsets) {
+    text.clear();
+    offsets.assign(1, 0);
+    for (const std::string& m : messages) {
+        text += m;
+        offsets.push_back(text.size());
+    }
+}
+
+// Тестовый сценарий для пакетной обработки (BatchTest)
+SUITE(BatchTest) {
+    TEST(MatchesPerCall) {
+        tableCipher cipher(4);
+        std::vector<std::string> messages = {
+            toUtf8(L"Привет мир"), "", toUtf8(L"при вет1"), "      ", toUtf8(L"ключ"),
+            toUtf8(L"съешь же ещё этих мягких булок"), toUtf8(L"ТЕКСТ")
+        };
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<tableCipher::textStatus> status;
+        for (bool decrypting : {false, true}) {
+            size_t done = decrypting
+                ? cipher.decryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status)
+                : cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+            CHECK_EQUAL(3u, done);
+            for (size_t i = 0; i < messages.size(); i++) {
+                std::string_view m(messages[i]);
+                std::string expected = outcome([&] { return decrypting ? cipher.decrypt(m) : cipher.encrypt(m); });
+                std::string actual = arena.substr(arenaOffsets[i], arenaOffsets[i + 1] - arenaOffsets[i]);
+                if (status[i] != tableCipher::textStatus::ok) {
+                    CHECK(actual.empty());
+                    CHECK_EQUAL(0u, expected.find(std::string("error: ") + tableCipher::statusMessage(status[i])));
+                } else {
+                    CHECK_EQUAL(expected, actual);
+                }
+            }
+        }
+        CHECK(status[1] == tableCipher::textStatus::emptyText);
+        CHECK(status[2] == tableCipher::textStatus::invalidText);
+        CHECK(status[3] == tableCipher::textStatus::onlySpaces);
+        CHECK(status[4] == tableCipher::textStatus::tooShort);
+    }
+
+    TEST(WithPlanCache) {
+        tablePlanCache cache(1 << 16);
+        tableCipher cached(5, cache);
+        tableCipher plain(5);
+        std::vector<std::string> messages(100, toUtf8(L"одинаковая длина сообщения"));
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::string expected;
+        std::vector<size_t> arenaOffsets;
+        std::vector<tableCipher::textStatus> status;
+        cached.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+        plain.encryptBatch(text.data(), offsets.data(), messages.size(), expected, arenaOffsets, status);
+        CHECK(arena == expected);
+        CHECK_EQUAL(99u, cache.snapshot().hits);
+    }
+
+    TEST(ReusedBuffersDoNotAllocate) {
+        tableCipher cipher(7);
+        std::vector<std::string> messages;
+        for (int i = 0; i < 1000; i++) {
+            messages.push_back(toUtf8(i % 10 == 0 ? L"коротко" : L"Сообщение для пакетной обработки"));
+        }
+        std::string text;
+        std::vector<size_t> offsets;
+        makeBatch(messages, text, offsets);
+
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<tableCipher::textStatus> status;
+        cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+        const size_t before = allocationCount;
+        for (int i = 0; i < 10; i++) {
+            CHECK_EQUAL(900u, cipher.encryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status));
+            CHECK_EQUAL(900u, cipher.decryptBatch(text.data(), offsets.data(), messages.size(), arena, arenaOffsets, status));
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Тестовый сценарий для методов без исключений (TryTest)
+SUITE(TryTest) {
+    TEST_FIXTURE(Key3_fixture, Statuses) {
+        wchar_t out[16];
+        tableCipher::result r = p->tryEncryptInto(L"Привет Мира", out, 16);
+        CHECK(r);
+        CHECK_EQUAL_WSTR(L"ИТРРЕИПВМА", std::wstring(out, r.size));
+        r = p->tryEncryptInto(L"", out, 16);
+        CHECK(!r && r.status == tableCipher::textStatus::emptyText && r.size == 0);
+        CHECK(p->tryEncryptInto(L"   ", out, 16).status == tableCipher::textStatus::onlySpaces);
+        CHECK(p->tryEncryptInto(L"ПРИВЕТ123", out, 16).status == tableCipher::textStatus::invalidText);
+        r = p->tryDecryptInto(L"И Т Р", out, 0);
+        CHECK(r.status == tableCipher::textStatus::tooShort);
+        CHECK_EQUAL(3u, r.size);
+        r = p->tryDecryptInto(std::string_view(toUtf8(L"ИТР")), nullptr, 0);
+        CHECK(r.status == tableCipher::textStatus::tooShort);
+        CHECK_EQUAL(6u, r.size);
+    }
+
+    TEST_FIXTURE(Key3_fixture, ReportsNeededSize) {
+        wchar_t out[4] = {L'x', L'x', L'x', L'x'};
+        tableCipher::result r = p->tryEncryptInto(L"Привет Мира", out, 4);
+        CHECK(r);
+        CHECK_EQUAL(10u, r.size);
+        CHECK(out[0] == L'x');
+    }
+
+    TEST(MatchesThrowing) {
+        std::mt19937 rng(17);
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя   1,";
+        const std::wstring noDigits = alpha.substr(0, 67);
+        std::string out;
+        std::wstring wide;
+        for (int n = 0; n < 300; n++) {
+            tableCipher cipher(3 + rng() % 20);
+            size_t len = rng() % 4 == 0 ? rng() % 8 : rng() % 3000;
+            std::wstring text = randomText(rng, n % 3 == 0 ? alpha : noDigits, len);
+            std::string utf8 = toUtf8(text);
+            for (bool decrypting : {false, true}) {
+                std::string_view m(utf8);
+                std::string expected = outcome([&] { return decrypting ? cipher.decrypt(m) : cipher.encrypt(m); });
+                tableCipher::textStatus status = decrypting ? cipher.tryDecrypt(m, out) : cipher.tryEncrypt(m, out);
+                if (status == tableCipher::textStatus::ok) {
+                    CHECK_EQUAL(expected, out);
+                } else {
+                    CHECK_EQUAL(0u, expected.find(std::string("error: ") + tableCipher::statusMessage(status)));
+                    CHECK(out.empty());
+                }
+                status = decrypting ? cipher.tryDecrypt(text, wide) : cipher.tryEncrypt(text, wide);
+                if (status == tableCipher::textStatus::ok) {
+                    CHECK_EQUAL(expected, toUtf8(wide));
+                } else {
+                    CHECK_EQUAL(0u, expected.find(std::string("error: ") + tableCipher::statusMessage(status)));
+                }
+            }
+        }
+    }
+
+    TEST(ErrorsDoNotAllocate) {
+        tableCipher cipher(5);
+        const std::string good = toUtf8(L"Съешь же ещё этих мягких французских булок да выпей чаю");
+        const std::string bad[] = {"", "   ", "12345", toUtf8(L"ПРИ,ВЕТ"), toUtf8(L"ключ")};
+        std::string out;
+        cipher.tryEncrypt(std::string_view(good), out);
+        const size_t before = allocationCount;
+        for (int i = 0; i < 1000; i++) {
+            for (const std::string& m : bad) {
+                CHECK(cipher.tryDecrypt(std::string_view(m), out) != tableCipher::textStatus::ok);
+                CHECK(out.empty());
+            }
+            CHECK(cipher.tryEncrypt(std::string_view(good), out) == tableCipher::textStatus::ok);
+        }
+        CHECK_EQUAL(before, allocationCount);
+    }
+}
+
+// Тестовый сценарий для встроенных счётчиков (StatsTest)
+SUITE(StatsTest) {
+    TEST_FIXTURE(Key3_fixture, CountsCallsAndFailures) {
+        const std::wstring open = L"Привет Мира";
+        wchar_t out[16];
+        tableCipher::resetStats();
+        p->encrypt(open);
+        p->tryEncryptInto(L"ПРИВЕТ123", out, 16);
+        CHECK_THROW(p->decrypt(L"И Т Р"), tableCipher_error);
+        CHECK_THROW(p->encrypt(std::string_view("   ")), tableCipher_error);
+        cipherCounters c = tableCipher::statsSnapshot();
+        using status = tableCipher::textStatus;
+        if (cipherStats<tableCipher>::enabled) {
+            CHECK_EQUAL(4ull, c.calls);
+            CHECK_EQUAL(open.size() + 9 + 5 + 3, c.chars);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::invalidText)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::tooShort)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(status::onlySpaces)]);
+            CHECK_EQUAL(0ull, c.failures[static_cast<unsigned>(status::emptyText)]);
+            CHECK(c.allocatedBytes >= open.size() * sizeof(wchar_t));
+        } else {
+            CHECK_EQUAL(0ull, c.calls);
+            CHECK_EQUAL(0ull, c.chars);
+            CHECK_EQUAL(0ull, c.allocatedBytes);
+        }
+        tableCipher::resetStats();
+        CHECK_EQUAL(0ull, tableCipher::statsSnapshot().calls);
+    }
+
+    TEST(CountsParallelAndBatch) {
+        tableCipher cipher(7);
+        std::wstring text;
+        for (size_t i = 0; i < 300000; i++) {
+            text += i % 5 == 4 ? L' ' : L'А' + static_cast<wchar_t>(i % 32);
+        }
+        std::vector<std::string> messages = {toUtf8(L"Привет мир"), "", toUtf8(L"при вет1"), toUtf8(L"ключ")};
+        std::string batch;
+        std::vector<size_t> offsets;
+        makeBatch(messages, batch, offsets);
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<tableCipher::textStatus> status;
+        tableCipher::resetStats();
+        cipher.encrypt(text, 4);
+        CHECK_THROW(cipher.encrypt(text + L"!", 4), tableCipher_error);
+        cipher.encryptBatch(batch.data(), offsets.data(), messages.size(), arena, arenaOffsets, status);
+        cipherCounters c = tableCipher::statsSnapshot();
+        if (cipherStats<tableCipher>::enabled) {
+            CHECK_EQUAL(6ull, c.calls);
+            CHECK_EQUAL(2 * text.size() + 1 + batch.size(), c.chars);
+            CHECK_EQUAL(2ull, c.failures[static_cast<unsigned>(tableCipher::textStatus::invalidText)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(tableCipher::textStatus::emptyText)]);
+            CHECK_EQUAL(1ull, c.failures[static_cast<unsigned>(tableCipher::textStatus::tooShort)]);
+        } else {
+            CHECK_EQUAL(0ull, c.calls);
+        }
+    }
+}
+
+// Проверка специализации tableCipherFixed<K> по обычному tableCipher(K)
+template <int K>
+static void checkFixed(const std::vector<std::wstring>& texts) {
+    tableCipher cipher(K);
+    tableCipherDispatch dispatch(K);
+    CHECK(dispatch.specialized());
+    for (const std::wstring& text : texts) {
+        const std::string utf8 = toUtf8(text);
+        CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                    outcome([&] { return toUtf8(tableCipherFixed<K>::encrypt(text)); }));
+        CHECK_EQUAL(outcome([&] { return toUtf8(cipher.decrypt(text)); }),
+                    outcome([&] { return toUtf8(tableCipherFixed<K>::decrypt(text)); }));
+        CHECK_EQUAL(outcome([&] { return cipher.encrypt(std::string_view(utf8)); }),
+                    outcome([&] { return tableCipherFixed<K>::encrypt(std::string_view(utf8)); }));
+        CHECK_EQUAL(outcome([&] { return cipher.decrypt(std::string_view(utf8)); }),
+                    outcome([&] { return tableCipherFixed<K>::decrypt(std::string_view(utf8)); }));
+        CHECK_EQUAL(outcome([&] { return toUtf8(cipher.encrypt(text)); }),
+                    outcome([&] { return toUtf8(dispatch.encrypt(text)); }));
+        CHECK_EQUAL(outcome([&] { return cipher.decrypt(std::string_view(utf8)); }),
+                    outcome([&] { return dispatch.decrypt(std::string_view(utf8)); }));
+    }
+}
+
+template <int... I>
+static void checkFixedKeys(const std::vector<std::wstring>& texts, std::integer_sequence<int, I...>) {
+    (checkFixed<I + 3>(texts), ...);
+}
+
+// Тестовый сценарий для перестановки с ключом на этапе компиляции (FixedTest)
+SUITE(FixedTest) {
+    TEST(MatchesRuntimeKey) {
+        const std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя ";
+        std::mt19937 rng(17);
+        std::vector<std::wstring> texts = {L"", L"   ", L"ПРИВЕТ1", L"ИТР", L"Привет Мир", L" итр реи пвм "};
+        for (int length : {5, 16, 17, 33, 250, 1000, 70000}) {
+            std::wstring text = randomText(rng, alpha, length);
+            texts.push_back(text);
+        }
+        checkFixedKeys(texts, std::make_integer_sequence<int, 14>());
+    }
+
+    TEST(SameErrorMessages) {
+        auto message = [](auto f) {
+            try {
+                f();
+            } catch (const tableCipher_error& e) {
+                return std::string(e.what());
+            }
+            return std::string();
+        };
+        CHECK_EQUAL(message([] { tableCipher(5).encrypt(L"ПРИ ВЕ"); }),
+                    message([] { tableCipherFixed<5>::encrypt(L"ПРИ ВЕ"); }));
+        CHECK_EQUAL(message([] { tableCipher(7).decrypt(L"ПРИВЕТ"); }),
+                    message([] { tableCipherFixed<7>::decrypt(L"ПРИВЕТ"); }));
+        CHECK_EQUAL(message([] { tableCipher(5).encrypt(L"ПРИВЕТ!"); }),
+                    message([] { tableCipherFixed<5>::encrypt(L"ПРИВЕТ!"); }));
+        CHECK_EQUAL(message([] { tableCipher(5).encrypt(L"    "); }),
+                    message([] { tableCipherFixed<5>::encrypt(L"    "); }));
+        CHECK(!message([] { tableCipherFixed<7>::decrypt(L"ПРИВЕТ"); }).empty());
+    }
+
+    TEST(IntoRespectsCapacity) {
+        wchar_t buffer[16];
+        CHECK_EQUAL(9u, tableCipherFixed<3>::encryptInto(std::wstring_view(L"Привет Мир"), buffer, 8));
+        CHECK_EQUAL(9u, tableCipherFixed<3>::encryptInto(std::wstring_view(L"Привет Мир"), buffer, 9));
+        CHECK_EQUAL_WSTR(L"ИТРРЕИПВМ", std::wstring(buffer, 9));
+        char bytes[32];
+        CHECK_EQUAL(18u, tableCipherFixed<3>::decryptInto(std::string_view(toUtf8(L"итр реи пвм")), bytes, 18));
+        CHECK_EQUAL(toUtf8(L"ПРИВЕТМИР"), std::string(bytes, 18));
+    }
+
+    TEST(DispatchFallsBackForOtherKeys) {
+        CHECK(!tableCipherDispatch(17).specialized());
+        CHECK(!tableCipherDispatch(1000).specialized());
+        CHECK_THROW(tableCipherDispatch(2), tableCipher_error);
+        CHECK_THROW(tableCipherDispatch(0), tableCipher_error);
+        std::wstring text(100, L'Ж');
+        for (size_t i = 0; i < text.size(); i++) {
+            text[i] = static_cast<wchar_t>(L'А' + i % 32);
+        }
+        for (int key : {17, 40, 99}) {
+            CHECK_EQUAL_WSTR(tableCipher(key).encrypt(text), tableCipherDispatch(key).encrypt(text));
+        }
+    }
+}
+
+// Русский текст для проверки поиска ключа (не совпадает с текстом обучения модели)
+static const std::wstring analyzerProse =
+    L"Весной в деревне начинается работа. Мужики чинят плуги, женщины сажают огород, "
+    L"старики сидят на лавочке у ворот и обсуждают погоду. Если лето выдастся тёплым, "
+    L"урожай будет хорошим, и осенью на ярмарке можно будет продать зерно и купить "
+    L"новую лошадь. Если же пойдут дожди, придётся снова ждать следующего года. Так "
+    L"живут здесь уже много веков, и никто не жалуется, потому что земля кормит тех, "
+    L"кто о ней заботится. Учитель нашей школы говорил, что каждый человек должен "
+    L"хотя бы раз в жизни увидеть море. Он родился на севере, долго служил на флоте и "
+    L"знал о кораблях всё, что только можно знать. По субботам он собирал учеников в "
+    L"большом зале, раскладывал на столе старые карты и объяснял, как моряки находили "
+    L"дорогу по звёздам, как измеряли глубину и скорость течения, как пережидали шторм "
+    L"в открытом океане. Мы слушали его с открытыми ртами и мечтали о дальних странах, "
+    L"о тёплых островах и высоких горах. Потом мы выросли, разъехались по разным "
+    L"городам, и многие из нас действительно увидели море.";
+
+// Буквы analyzerProse без пробелов и знаков препинания
+static std::wstring analyzerLetters() {
+    std::wstring text;
+    for (wchar_t c : analyzerProse) {
+        if (russianText::isLetter(c)) {
+            text += c;
+        }
+    }
+    return text;
+}
+
+// Тестовый сценарий для поиска количества столбцов (AnalyzerTest)
+SUITE(AnalyzerTest) {
+    TEST(FindsKnownKeys) {
+        for (int key : {3, 4, 7, 12, 25, 60}) {
+            tableAnalyzer analyzer(tableCipher(key).encrypt(analyzerLetters()));
+            std::vector<tableAnalyzer::candidate> candidates = analyzer.search(5);
+            CHECK_EQUAL(5u, candidates.size());
+            CHECK_EQUAL(key, candidates[0].key);
+            for (size_t i = 1; i < candidates.size(); i++) {
+                CHECK(candidates[i - 1].score >= candidates[i].score);
+            }
+        }
+    }
+
+    TEST(WideKeysAmongCandidates) {
+        const std::wstring text = analyzerLetters();
+        const int length = text.size();
+        for (int key : {length / 3, length / 2, length - 2}) {
+            tableAnalyzer analyzer(tableCipher(key).encrypt(text));
+            std::vector<tableAnalyzer::candidate> candidates = analyzer.search(10);
+            auto found = std::find_if(candidates.begin(), candidates.end(),
+                                      [&](const tableAnalyzer::candidate& c) { return c.key == key; });
+            CHECK(found != candidates.end());
+        }
+    }
+
+    TEST(ScoreMatchesSearch) {
+        tableAnalyzer analyzer(std::string_view(toUtf8(tableCipher(9).encrypt(analyzerLetters()))));
+        for (const tableAnalyzer::candidate& c : analyzer.search(20)) {
+            CHECK_CLOSE(analyzer.score(c.key), c.score, 1e-9);
+        }
+        CHECK(analyzer.score(9) > analyzer.score(8));
+        CHECK(analyzer.score(9) > analyzer.score(10));
+        CHECK_THROW(analyzer.score(2), tableCipher_error);
+        CHECK_THROW(analyzer.score(-1), tableCipher_error);
+        CHECK_THROW(analyzer.score(static_cast<int>(analyzer.length())), tableCipher_error);
+    }
+
+    TEST(ThreadCountDoesNotChangeResult) {
+        tableAnalyzer analyzer(tableCipher(11).encrypt(analyzerLetters()));
+        std::vector<tableAnalyzer::candidate> serial = analyzer.search(8, 1);
+        for (unsigned threads : {0u, 2u, 5u}) {
+            std::vector<tableAnalyzer::candidate> parallel = analyzer.search(8, threads);
+            CHECK_EQUAL(serial.size(), parallel.size());
+            for (size_t i = 0; i < serial.size() && i < parallel.size(); i++) {
+                CHECK_EQUAL(serial[i].key, parallel[i].key);
+                CHECK_EQUAL(serial[i].score, parallel[i].score);
+            }
+        }
+    }
+
+    TEST(ShortAndInvalidTexts) {
+        CHECK(tableAnalyzer(std::wstring(L"АБВ")).search(3).empty());
+        CHECK_EQUAL(1u, tableAnalyzer(std::wstring(L"АБВГ")).search(3).size());
+        CHECK_THROW(tableAnalyzer(std::wstring()), tableCipher_error);
+        CHECK_THROW(tableAnalyzer(std::wstring(L"   ")), tableCipher_error);
+        CHECK_THROW(tableAnalyzer(std::string_view("ABC")), tableCipher_error);
+    }
+}
+
+// Прогон блочного режима табличного шифра над текстом через временные файлы
+static std::string blockRun(const tableCipher& cipher, const std::string& text, bool decrypting, size_t blockSize) {
+    std::FILE* in = std::tmpfile();
+    std::FILE* out = std::tmpfile();
+    std::fwrite(text.data(), 1, text.size(), in);
+    std::fflush(in);
+    std::rewind(in);
+    filePipeline::options settings;
+    settings.blockSize = blockSize;
+    settings.workers = 3;
+    const tableBlockPipeline pipeline(cipher, decrypting, settings);
+    std::string result;
+    try {
+        pipeline.run(fileno(in), fileno(out));
+        result.resize(static_cast<size_t>(lseek(fileno(out), 0, SEEK_END)));
+        CHECK_EQUAL(static_cast<ssize_t>(result.size()), pread(fileno(out), &result[0], result.size(), 0));
+    } catch (...) {
+        std::fclose(in);
+        std::fclose(out);
+        throw;
+    }
+    std::fclose(in);
+    std::fclose(out);
+    return result;
+}
+
+// Тестовый сценарий для блочного режима обработки файлов (PipelineTest)
+SUITE(PipelineTest) {
+    TEST(BlocksRoundTrip) {
+        std::mt19937 rng(31);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ ";
+        for (int n = 0; n < 30; n++) {
+            tableCipher cipher(3 + n % 5);
+            size_t len = 100 + rng() % 4000;
+            std::wstring text = randomText(rng, alpha, len);
+            std::wstring letters = text;
+            letters.erase(std::remove(letters.begin(), letters.end(), L' '), letters.end());
+            size_t blockSize = 64 + rng() % 300;
+            std::string encrypted = blockRun(cipher, toUtf8(text) + "\n", false, blockSize);
+            CHECK(std::count(encrypted.begin(), encrypted.end(), '\n') >= 1);
+            CHECK(blockRun(cipher, encrypted, true, blockSize) == toUtf8(letters));
+        }
+    }
+
+    TEST(SingleBlockMatchesEncrypt) {
+        tableCipher cipher(4);
+        std::string text = toUtf8(L"ПРОГРАММИРОВАНИЕ НА ЯЗЫКЕ СИ");
+        std::string out(text.size(), '\0');
+        out.resize(cipher.encryptInto(std::string_view(text), &out[0], out.size()));
+        CHECK(blockRun(cipher, text, false, 1024) == out + "\n");
+    }
+
+    TEST(DecryptCrLfLines) {
+        tableCipher cipher(4);
+        std::string first = toUtf8(L"ПРОГРАММИРОВАНИЕ");
+        std::string second = toUtf8(L"НАЯЗЫКЕСИ");
+        std::string encrypted = cipher.encrypt(std::string_view(first)) + "\r\n\r\n" +
+                                cipher.encrypt(std::string_view(second)) + "\r\n";
+        CHECK(blockRun(cipher, encrypted, true, 64) == first + second);
+    }
+
+    TEST(InvalidBlockStopsPipeline) {
+        tableCipher cipher(3);
+        std::string text;
+        for (int i = 0; i < 200; i++) {
+            text += toUtf8(L"ПРИВЕТ МИР ");
+        }
+        CHECK_THROW(blockRun(cipher, text + "1" + text, false, 64), tableCipher_error);
+        CHECK_THROW(blockRun(cipher, toUtf8(L"ПРИВЕТ\nМИР,\n"), true, 64), tableCipher_error);
+    }
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,313 @@
+/**
+ * @file anyCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация общего интерфейса шифров и реестра шифров
+ */
+
+#include "anyCipher.h"
+#include "russianText.h"
+#include "../1_Zadanie/modAlphaCipher.h"
+#include "../2_Zadanie/tableCipher.h"
+#include <charconv>
+
+namespace {
+
+/**
+ * @brief Общий результат проверки для результата шифра Гронсфельда
+ * @param status Результат проверки модуля
+ * @return Общий результат проверки
+ */
+cipherStatus unified(modAlphaCipher::textStatus status)
+{
+    switch (status) {
+    case modAlphaCipher::textStatus::ok:
+        return cipherStatus::ok;
+    case modAlphaCipher::textStatus::emptyOpenText:
+    case modAlphaCipher::textStatus::emptyCipherText:
+        return cipherStatus::emptyText;
+    default:
+        return cipherStatus::invalidText;
+    }
+}
+
+/**
+ * @brief Общий результат проверки для результата табличной перестановки
+ * @param status Результат проверки модуля
+ * @return Общий результат проверки
+ */
+cipherStatus unified(tableCipher::textStatus status)
+{
+    switch (status) {
+    case tableCipher::textStatus::ok:
+        return cipherStatus::ok;
+    case tableCipher::textStatus::emptyText:
+    case tableCipher::textStatus::onlySpaces:
+        return cipherStatus::emptyText;
+    case tableCipher::textStatus::invalidText:
+        return cipherStatus::invalidText;
+    default:
+        return cipherStatus::tooShort;
+    }
+}
+
+/**
+ * @brief Таблица функций модуля шифра
+ * @details Cipher - modAlphaCipher или tableCipher, Error - класс его
+ *          исключений; функции вызывают методы шифра напрямую и приводят
+ *          результаты проверки к cipherStatus.
+ */
+template <typename Cipher, typename Error>
+struct kernelFor {
+    /**
+     * @brief Преобразование сообщения без исключений
+     * @param cipher Объект шифра
+     * @param text Текст в UTF-8
+     * @param out Строка результата
+     * @param decrypting true - расшифровывание, false - зашифровывание
+     * @return Результат проверки текста
+     */
+    static cipherStatus tryRun(const void* cipher, std::string_view text, std::string& out, bool decrypting)
+    {
+        const Cipher& c = *static_cast<const Cipher*>(cipher);
+        return unified(decrypting ? c.tryDecrypt(text, out) : c.tryEncrypt(text, out));
+    }
+
+    /**
+     * @brief Преобразование сообщения с исключением при ошибке
+     * @details Текст ошибки берётся у бросающего метода модуля, который
+     *          вызывается повторно только для уже отвергнутого текста.
+     * @param cipher Объект шифра
+     * @param text Текст в UTF-8
+     * @param decrypting true - расшифровывание, false - зашифровывание
+     * @return Результат преобразования
+     * @throw anyCipher_error Если текст не подходит шифру
+     */
+    static std::string run(const void* cipher, std::string_view text, bool decrypting)
+    {
+        std::string out;
+        const cipherStatus status = tryRun(cipher, text, out, decrypting);
+        if (status == cipherStatus::ok) {
+            return out;
+        }
+        const Cipher& c = *static_cast<const Cipher*>(cipher);
+        try {
+            return decrypting ? c.decrypt(text) : c.encrypt(text);
+        } catch (const Error& e) {
+            throw anyCipher_error(status, e.what());
+        }
+    }
+
+    /**
+     * @brief Преобразование пакета сообщений
+     * @details Результаты проверки модуля записываются в буфер потока и
+     *          переводятся в cipherStatus после пакета.
+     * @param cipher Объект шифра
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @param decrypting true - расшифровывание, false - зашифровывание
+     * @return Количество успешно обработанных сообщений
+     */
+    static size_t batch(const void* cipher, const char* text, const size_t* offsets, size_t count,
+                        std::string& arena, std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status,
+                        bool decrypting)
+    {
+        thread_local std::vector<typename Cipher::textStatus> moduleStatus;
+        const Cipher& c = *static_cast<const Cipher*>(cipher);
+        const size_t done = decrypting ? c.decryptBatch(text, offsets, count, arena, arenaOffsets, moduleStatus)
+                                       : c.encryptBatch(text, offsets, count, arena, arenaOffsets, moduleStatus);
+        status.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            status[i] = unified(moduleStatus[i]);
+        }
+        return done;
+    }
+
+    static const anyCipher::kernel table; ///< Таблица функций модуля
+};
+
+using gronsfeldOps = kernelFor<modAlphaCipher, cipher_error>; ///< Функции шифра Гронсфельда
+using tableOps = kernelFor<tableCipher, tableCipher_error>; ///< Функции табличной перестановки
+
+template <>
+const anyCipher::kernel gronsfeldOps::table = {"gronsfeld", run, tryRun, batch};
+
+template <>
+const anyCipher::kernel tableOps::table = {"table", run, tryRun, batch};
+
+/**
+ * @brief Декодирование ключа из UTF-8
+ * @param key Ключ в UTF-8
+ * @return Ключ в широкой строке
+ */
+std::wstring wideKey(std::string_view key)
+{
+    std::wstring result;
+    const char* p = key.data();
+    const char* end = p + key.size();
+    while (p != end) {
+        result += static_cast<wchar_t>(russianText::decodeUtf8(p, end));
+    }
+    return result;
+}
+
+/**
+ * @brief Разбор количества столбцов
+ * @param key Количество столбцов в десятичной записи
+ * @return Количество столбцов
+ * @throw anyCipher_error Если ключ не целое число
+ */
+int columnsKey(std::string_view key)
+{
+    int columns = 0;
+    const char* end = key.data() + key.size();
+    const std::from_chars_result r = std::from_chars(key.data(), end, columns);
+    if (key.empty() || r.ec != std::errc() || r.ptr != end) {
+        throw anyCipher_error(cipherStatus::invalidKey,
+                              "Количество столбцов должно быть целым числом: " + std::string(key));
+    }
+    return columns;
+}
+
+} // namespace
+
+/**
+ * @brief Зашифровывание сообщения в UTF-8
+ * @param open_text Открытый текст
+ * @return Шифртекст
+ * @throw anyCipher_error Если текст не подходит шифру
+ */
+std::string anyCipher::encrypt(std::string_view open_text) const
+{
+    return ops->run(cipher.get(), open_text, false);
+}
+
+/**
+ * @brief Расшифровывание сообщения в UTF-8
+ * @param cipher_text Шифртекст
+ * @return Открытый текст
+ * @throw anyCipher_error Если текст не подходит шифру
+ */
+std::string anyCipher::decrypt(std::string_view cipher_text) const
+{
+    return ops->run(cipher.get(), cipher_text, true);
+}
+
+/**
+ * @brief Зашифровывание сообщения в UTF-8 без исключений
+ * @param open_text Открытый текст
+ * @param out Строка результата
+ * @return Результат проверки текста
+ */
+cipherStatus anyCipher::tryEncrypt(std::string_view open_text, std::string& out) const
+{
+    return ops->tryRun(cipher.get(), open_text, out, false);
+}
+
+/**
+ * @brief Расшифровывание сообщения в UTF-8 без исключений
+ * @param cipher_text Шифртекст
+ * @param out Строка результата
+ * @return Результат проверки текста
+ */
+cipherStatus anyCipher::tryDecrypt(std::string_view cipher_text, std::string& out) const
+{
+    return ops->tryRun(cipher.get(), cipher_text, out, true);
+}
+
+/**
+ * @brief Пакетное зашифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно зашифрованных сообщений
+ */
+size_t anyCipher::encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                               std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status) const
+{
+    return ops->batch(cipher.get(), text, offsets, count, arena, arenaOffsets, status, false);
+}
+
+/**
+ * @brief Пакетное расшифровывание сообщений в UTF-8
+ * @param text Буфер всех сообщений
+ * @param offsets Границы сообщений, count + 1 элемент
+ * @param count Количество сообщений
+ * @param arena Общий буфер результатов
+ * @param arenaOffsets Границы результатов, count + 1 элемент
+ * @param status Результат проверки каждого сообщения
+ * @return Количество успешно расшифрованных сообщений
+ */
+size_t anyCipher::decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                               std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status) const
+{
+    return ops->batch(cipher.get(), text, offsets, count, arena, arenaOffsets, status, true);
+}
+
+/**
+ * @brief Конструктор реестра со встроенными шифрами
+ * @details Ошибки ключа модулей переводятся в anyCipher_error с причиной invalidKey.
+ */
+cipherRegistry::cipherRegistry()
+{
+    factories["gronsfeld"] = [](std::string_view key) {
+        try {
+            return anyCipher::wrap(std::make_shared<const modAlphaCipher>(wideKey(key)), gronsfeldOps::table);
+        } catch (const cipher_error& e) {
+            throw anyCipher_error(cipherStatus::invalidKey, e.what());
+        }
+    };
+    factories["table"] = [](std::string_view key) {
+        const int columns = columnsKey(key);
+        try {
+            return anyCipher::wrap(std::make_shared<const tableCipher>(columns), tableOps::table);
+        } catch (const tableCipher_error& e) {
+            throw anyCipher_error(cipherStatus::invalidKey, e.what());
+        }
+    };
+}
+
+/**
+ * @brief Регистрация шифра под именем
+ * @param name Имя шифра, без двоеточия
+ * @param make Создание шифра по ключу
+ * @throw anyCipher_error Если имя пустое или содержит двоеточие
+ */
+void cipherRegistry::add(const std::string& name, factory make)
+{
+    if (name.empty() || name.find(':') != std::string::npos) {
+        throw anyCipher_error(cipherStatus::invalidConfig, "Недопустимое имя шифра: " + name);
+    }
+    factories[name] = std::move(make);
+}
+
+/**
+ * @brief Создание шифра по строке конфигурации
+ * @param config Строка вида имя:ключ
+ * @return Шифр
+ * @throw anyCipher_error С причиной invalidConfig, если строка не разобрана
+ *        или имя неизвестно, и invalidKey, если ключ невалиден
+ */
+anyCipher cipherRegistry::make(std::string_view config) const
+{
+    const size_t colon = config.find(':');
+    if (colon == std::string_view::npos) {
+        throw anyCipher_error(cipherStatus::invalidConfig,
+                              "Конфигурация шифра должна иметь вид имя:ключ: " + std::string(config));
+    }
+    const auto it = factories.find(config.substr(0, colon));
+    if (it == factories.end()) {
+        throw anyCipher_error(cipherStatus::invalidConfig,
+                              "Неизвестный шифр: " + std::string(config.substr(0, colon)));
+    }
+    return it->second(config.substr(colon + 1));
+}
@@ -0,0 +1,251 @@
+/**
+ * @file anyCipher.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для общего интерфейса шифров и реестра шифров
+ */
+
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Результат проверки текста или причина ошибки, общие для всех шифров
+ * @details Значения textStatus модулей сводятся к первым четырём:
+ *          пустой текст и текст из одних пробелов - emptyText, недопустимые
+ *          символы или текст без букв - invalidText, букв не больше, чем
+ *          столбцов таблицы - tooShort. Последние два значения бывают только
+ *          у исключений при создании шифра.
+ */
+enum class cipherStatus : unsigned char {
+    ok, ///< Текст обработан
+    emptyText, ///< Текст пустой или состоит из пробелов
+    invalidText, ///< Текст содержит недопустимые символы или не содержит букв
+    tooShort, ///< Текст короче, чем требует ключ
+    invalidKey, ///< Ключ шифра невалиден
+    invalidConfig ///< Строка конфигурации не разобрана или шифр неизвестен
+};
+
+/**
+ * @brief Класс исключений общего интерфейса шифров
+ * @details Заменяет cipher_error и tableCipher_error: текст сообщения
+ *          берётся из модуля шифра, причина доступна через status.
+ */
+class anyCipher_error : public std::runtime_error
+{
+private:
+    cipherStatus reason; ///< Причина ошибки
+
+public:
+    /**
+     * @brief Конструктор с причиной и сообщением об ошибке
+     * @param status Причина ошибки
+     * @param what_arg Сообщение об ошибке
+     */
+    anyCipher_error(cipherStatus status, const std::string& what_arg) : std::runtime_error(what_arg), reason(status) {}
+
+    /**
+     * @brief Причина ошибки
+     * @return Значение cipherStatus, не ok
+     */
+    cipherStatus status() const { return reason; }
+};
+
+/**
+ * @brief Шифр любого модуля за общим интерфейсом
+ * @details Хранит неизменяемый объект шифра и указатель на таблицу функций
+ *          его модуля. Одно сообщение обходится в один косвенный вызов, как
+ *          виртуальная функция; пакет сообщений передаётся пакетному методу
+ *          модуля целиком, так что косвенный вызов приходится один на пакет,
+ *          а внутри пакета методы шифра вызываются напрямую. Копии объекта
+ *          разделяют один шифр и могут использоваться из разных потоков.
+ *          Встроенные шифры создаются через cipherRegistry, шифры других
+ *          модулей - через wrap с таблицей функций своего модуля.
+ */
+class anyCipher
+{
+public:
+    /**
+     * @brief Таблица функций модуля шифра
+     * @details Функции получают объект шифра как const void* и приводят его
+     *          к типу шифра модуля. Таблица должна жить до конца программы,
+     *          обычно это статическая константа модуля.
+     */
+    struct kernel {
+        const char* name; ///< Имя шифра в строке конфигурации
+
+        /**
+         * @brief Преобразование сообщения с исключением при ошибке
+         * @throw anyCipher_error При ошибке текста
+         */
+        std::string (*run)(const void* cipher, std::string_view text, bool decrypting);
+
+        /**
+         * @brief Преобразование сообщения без исключений
+         */
+        cipherStatus (*tryRun)(const void* cipher, std::string_view text, std::string& out, bool decrypting);
+
+        /**
+         * @brief Преобразование пакета сообщений
+         */
+        size_t (*batch)(const void* cipher, const char* text, const size_t* offsets, size_t count,
+                        std::string& arena, std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status,
+                        bool decrypting);
+    };
+
+private:
+    std::shared_ptr<const void> cipher; ///< Объект шифра модуля
+    const kernel* ops; ///< Таблица функций модуля
+
+    /**
+     * @brief Конструктор из объекта шифра и таблицы функций его модуля
+     * @param c Объект шифра
+     * @param k Таблица функций
+     */
+    anyCipher(std::shared_ptr<const void> c, const kernel& k) : cipher(std::move(c)), ops(&k) {}
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    anyCipher() = delete;
+
+    /**
+     * @brief Шифр модуля за общим интерфейсом
+     * @details Функции k получают указатель на объект cipher; run при ошибке
+     *          текста должна бросать anyCipher_error, tryRun и batch - только
+     *          возвращать cipherStatus.
+     * @param cipher Неизменяемый объект шифра
+     * @param k Таблица функций модуля для типа Cipher
+     * @return Шифр за общим интерфейсом
+     */
+    template <typename Cipher>
+    static anyCipher wrap(std::shared_ptr<const Cipher> cipher, const kernel& k)
+    {
+        return anyCipher(std::move(cipher), k);
+    }
+
+    /**
+     * @brief Имя шифра
+     * @return Имя в строке конфигурации, например gronsfeld
+     */
+    const char* name() const { return ops->name; }
+
+    /**
+     * @brief Зашифровывание сообщения в UTF-8
+     * @param open_text Открытый текст
+     * @return Шифртекст
+     * @throw anyCipher_error Если текст не подходит шифру
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Расшифровывание сообщения в UTF-8
+     * @param cipher_text Шифртекст
+     * @return Открытый текст
+     * @throw anyCipher_error Если текст не подходит шифру
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Зашифровывание сообщения в UTF-8 без исключений
+     * @details Строка out переиспользуется, при ошибке она пустая.
+     * @param open_text Открытый текст
+     * @param out Строка результата
+     * @return Результат проверки текста
+     */
+    cipherStatus tryEncrypt(std::string_view open_text, std::string& out) const;
+
+    /**
+     * @brief Расшифровывание сообщения в UTF-8 без исключений
+     * @details Аналогично tryEncrypt.
+     * @param cipher_text Шифртекст
+     * @param out Строка результата
+     * @return Результат проверки текста
+     */
+    cipherStatus tryDecrypt(std::string_view cipher_text, std::string& out) const;
+
+    /**
+     * @brief Пакетное зашифровывание сообщений в UTF-8
+     * @details Формат буферов - как у encryptBatch модулей: сообщение i
+     *          занимает в text байты [offsets[i], offsets[i + 1]), результат -
+     *          байты [arenaOffsets[i], arenaOffsets[i + 1]) в arena. Ошибка
+     *          в сообщении не прерывает пакет, её причина записывается в status[i].
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно зашифрованных сообщений
+     */
+    size_t encryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status) const;
+
+    /**
+     * @brief Пакетное расшифровывание сообщений в UTF-8
+     * @details Аналогично encryptBatch.
+     * @param text Буфер всех сообщений
+     * @param offsets Границы сообщений, count + 1 элемент
+     * @param count Количество сообщений
+     * @param arena Общий буфер результатов
+     * @param arenaOffsets Границы результатов, count + 1 элемент
+     * @param status Результат проверки каждого сообщения
+     * @return Количество успешно расшифрованных сообщений
+     */
+    size_t decryptBatch(const char* text, const size_t* offsets, size_t count, std::string& arena,
+                        std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status) const;
+};
+
+/**
+ * @brief Реестр шифров, создающий шифр по строке конфигурации
+ * @details Строка конфигурации имеет вид имя:ключ. Встроенные шифры:
+ *          gronsfeld:КЛЮЧ - шифр Гронсфельда (ключ в UTF-8) и table:5 -
+ *          табличная перестановка с заданным количеством столбцов. Ошибки
+ *          ключа модулей приводятся к anyCipher_error с причиной invalidKey.
+ */
+class cipherRegistry
+{
+public:
+    /**
+     * @brief Создание шифра по ключу из строки конфигурации
+     * @throw anyCipher_error Если ключ невалиден
+     */
+    using factory = std::function<anyCipher(std::string_view key)>;
+
+private:
+    std::map<std::string, factory, std::less<>> factories; ///< Создание шифра по имени
+
+public:
+    /**
+     * @brief Конструктор реестра со встроенными шифрами
+     */
+    cipherRegistry();
+
+    /**
+     * @brief Регистрация шифра под именем
+     * @details Прежний шифр с тем же именем заменяется. Фабрика создаёт шифр
+     *          нового модуля через anyCipher::wrap или задаёт имя для шифра с
+     *          фиксированным ключом через make.
+     * @param name Имя шифра, без двоеточия
+     * @param make Создание шифра по ключу
+     * @throw anyCipher_error Если имя пустое или содержит двоеточие
+     */
+    void add(const std::string& name, factory make);
+
+    /**
+     * @brief Создание шифра по строке конфигурации
+     * @param config Строка вида имя:ключ
+     * @return Шифр
+     * @throw anyCipher_error С причиной invalidConfig, если строка не разобрана
+     *        или имя неизвестно, и invalidKey, если ключ невалиден
+     */
+    anyCipher make(std::string_view config) const;
+};
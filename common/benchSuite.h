@@ -0,0 +1,435 @@
+/**
+ * @file benchSuite.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Общие средства программ замера производительности шифров
+ * @details Выделения памяти и выделенные байты на вызов считаются заменой
+ *          глобальных operator new и operator delete в benchAlloc.cpp.
+ *          Программа замера собирается вместе с benchAlloc.cpp и filePipeline.cpp.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "filePipeline.h"
+#include "russianText.h"
+
+/**
+ * @brief Счётчик выделений памяти через operator new всех форм
+ */
+extern std::atomic<size_t> benchAllocations;
+
+/**
+ * @brief Счётчик байтов, выделенных через operator new всех форм
+ */
+extern std::atomic<size_t> benchAllocatedBytes;
+
+/**
+ * @brief Случайный русский текст в UTF-8
+ * @details Заглавные буквы, при withSpaces примерно каждый восьмой символ -
+ *          пробел (но не первый). Генератор детерминирован, поэтому прогоны
+ *          на одной машине обрабатывают одинаковые тексты.
+ * @param chars Количество символов
+ * @param withSpaces Вставлять пробелы
+ * @param letters Количество букв в тексте
+ * @return Текст в UTF-8
+ */
+inline std::string benchText(size_t chars, bool withSpaces, size_t& letters)
+{
+    const std::wstring& alpha = russianText::alphabet();
+    std::string text;
+    text.reserve(2 * chars);
+    letters = 0;
+    unsigned state = 1;
+    for (size_t i = 0; i < chars; i++) {
+        state = state * 1103515245u + 12345u;
+        const unsigned r = state >> 16;
+        if (withSpaces && i > 0 && r % 8 == 0) {
+            text += ' ';
+        } else {
+            char letter[2];
+            russianText::encodeLetter(alpha[r % alpha.size()], letter);
+            text.append(letter, 2);
+            letters++;
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Перевод текста из UTF-8 в широкую строку
+ * @param text Текст в UTF-8
+ * @return Широкая строка
+ */
+inline std::wstring benchWide(const std::string& text)
+{
+    std::wstring result;
+    result.reserve(text.size());
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p != end) {
+        result += static_cast<wchar_t>(russianText::decodeUtf8(p, end));
+    }
+    return result;
+}
+
+/**
+ * @brief Перевод широкой строки в UTF-8
+ * @param s Широкая строка
+ * @return Текст в UTF-8
+ */
+inline std::string benchUtf8(const std::wstring& s)
+{
+    std::string result;
+    result.reserve(2 * s.size());
+    for (wchar_t c : s) {
+        const unsigned u = static_cast<unsigned>(c);
+        if (u < 0x80) {
+            result += static_cast<char>(u);
+        } else if (u < 0x800) {
+            result += static_cast<char>(0xC0 | (u >> 6));
+            result += static_cast<char>(0x80 | (u & 0x3F));
+        } else if (u < 0x10000) {
+            result += static_cast<char>(0xE0 | (u >> 12));
+            result += static_cast<char>(0x80 | ((u >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (u & 0x3F));
+        } else {
+            result += static_cast<char>(0xF0 | (u >> 18));
+            result += static_cast<char>(0x80 | ((u >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((u >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (u & 0x3F));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Результат замера одной операции
+ */
+struct benchResult {
+    double nsPerChar; ///< Наносекунды на символ текста
+    double mbPerSecond; ///< Мегабайты входного текста в секунду
+    double allocationsPerCall; ///< Выделений памяти на вызов
+    double allocatedBytesPerChar; ///< Выделенных байтов на символ текста (промежуточные копии и результат)
+};
+
+/**
+ * @brief Параметры запуска программы замера
+ */
+struct benchOptions {
+    bool json = false; ///< Вывод в JSON вместо CSV
+    size_t maxBytes = size_t(1) << 30; ///< Наибольший размер текста в байтах UTF-8
+    size_t minChars = 8; ///< Наименьшая длина текста в символах
+    const char* mode = nullptr; ///< Дополнительный режим программы или nullptr
+
+    /**
+     * @brief Разбор аргументов командной строки
+     * @details Допускаются --json, --csv, --max-mb N, --min-chars N и одно
+     *          слово режима, например batch.
+     * @param argc Количество аргументов
+     * @param argv Аргументы
+     * @return false, если встретился неизвестный аргумент
+     */
+    bool parse(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--json") {
+                json = true;
+            } else if (arg == "--csv") {
+                json = false;
+            } else if (arg == "--max-mb" && i + 1 < argc) {
+                maxBytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+            } else if (arg == "--min-chars" && i + 1 < argc) {
+                minChars = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg[0] != '-' && mode == nullptr) {
+                mode = argv[i];
+            } else {
+                return false;
+            }
+        }
+        return minChars > 0;
+    }
+};
+
+/**
+ * @brief Среднее время обработки одного сообщения пакета
+ * @details Сумма результатов f печатается, если она нулевая, чтобы
+ *          компилятор не выбросил замеряемую работу.
+ * @param f Обработка всего пакета, возвращает размер результата
+ * @param messages Количество сообщений в пакете
+ * @param rounds Количество повторов пакета
+ * @return Наносекунды на сообщение
+ */
+template <typename F>
+double benchNsPerMessage(F f, size_t messages, int rounds)
+{
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        sink += f();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sink == 0) {
+        std::printf("#\n");
+    }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / rounds / messages;
+}
+
+/**
+ * @brief Замер операции над текстом
+ * @details Короткие тексты обрабатываются многократно, пока через операцию не
+ *          пройдёт около 32 миллионов символов, чтобы замер длился заметное время.
+ *          Первый вызов выполняется до замера и прогревает кэши и пулы памяти.
+ * @param f Операция, возвращает размер результата
+ * @param chars Количество символов текста
+ * @param bytes Размер входного текста в байтах
+ * @return Результат замера
+ */
+template <typename F>
+benchResult benchMeasure(F f, size_t chars, size_t bytes)
+{
+    size_t sink = f();
+    const size_t iterations = chars >= (32u << 20) ? 1 : (32u << 20) / chars;
+    const size_t allocationsBefore = benchAllocations.load(std::memory_order_relaxed);
+    const size_t bytesBefore = benchAllocatedBytes.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        sink += f();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    const size_t allocations = benchAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+    const size_t allocated = benchAllocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+    if (sink == 0) {
+        std::fprintf(stderr, "# empty result\n");
+    }
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    return {ns / iterations / chars, static_cast<double>(bytes) * iterations / ns * 1e3,
+            static_cast<double>(allocations) / iterations, static_cast<double>(allocated) / iterations / chars};
+}
+
+/**
+ * @brief Вывод результатов замеров в CSV или JSON
+ * @details Одна строка CSV или один объект JSON на замер, с одинаковым
+ *          набором полей для обоих модулей, чтобы прогоны можно было сравнивать diff.
+ */
+class benchReport
+{
+private:
+    bool json; ///< Вывод в JSON
+    bool first = true; ///< Ещё не выведено ни одной строки
+
+public:
+    /**
+     * @brief Конструктор, печатает заголовок CSV или начало массива JSON
+     * @param asJson Вывод в JSON
+     */
+    explicit benchReport(bool asJson) : json(asJson)
+    {
+        if (json) {
+            std::printf("[");
+        } else {
+            std::printf("module,operation,api,chars,bytes,key,threads,ns_per_char,mb_per_s,allocs_per_call,alloc_bytes_per_char\n");
+        }
+    }
+
+    /**
+     * @brief Деструктор, закрывает массив JSON
+     */
+    ~benchReport()
+    {
+        if (json) {
+            std::printf("\n]\n");
+        }
+    }
+
+    benchReport(const benchReport&) = delete;
+    benchReport& operator=(const benchReport&) = delete;
+
+    /**
+     * @brief Вывод одного замера
+     * @param module Имя модуля
+     * @param operation encrypt или decrypt
+     * @param api Вариант интерфейса
+     * @param chars Количество символов текста
+     * @param bytes Размер текста в байтах
+     * @param key Длина ключа или количество столбцов
+     * @param threads Количество потоков
+     * @param r Результат замера
+     */
+    void add(const char* module, const char* operation, const char* api, size_t chars, size_t bytes,
+             size_t key, unsigned threads, const benchResult& r)
+    {
+        if (json) {
+            std::printf("%s\n  {\"module\": \"%s\", \"operation\": \"%s\", \"api\": \"%s\", \"chars\": %zu, "
+                        "\"bytes\": %zu, \"key\": %zu, \"threads\": %u, \"ns_per_char\": %.3f, "
+                        "\"mb_per_s\": %.1f, \"allocs_per_call\": %.2f, \"alloc_bytes_per_char\": %.2f}",
+                        first ? "" : ",", module, operation, api, chars, bytes, key, threads,
+                        r.nsPerChar, r.mbPerSecond, r.allocationsPerCall, r.allocatedBytesPerChar);
+        } else {
+            std::printf("%s,%s,%s,%zu,%zu,%zu,%u,%.3f,%.1f,%.2f,%.2f\n", module, operation, api, chars, bytes,
+                        key, threads, r.nsPerChar, r.mbPerSecond, r.allocationsPerCall, r.allocatedBytesPerChar);
+        }
+        first = false;
+        std::fflush(stdout);
+    }
+};
+
+/**
+ * @brief Запись файла со случайным русским текстом
+ * @details Файл состоит из повторов текста benchText по 8 МБ и заканчивается
+ *          переводом строки, его размер - не меньше bytes.
+ * @param path Имя файла
+ * @param bytes Наименьший размер текста в байтах
+ * @return false при ошибке создания или записи
+ */
+inline bool benchWriteFile(const char* path, size_t bytes)
+{
+    size_t letters = 0;
+    const std::string chunk = benchText(size_t(1) << 22, true, letters);
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t written = 0; ok && written < bytes; written += chunk.size()) {
+        ok = write(fd, chunk.data(), chunk.size()) == static_cast<ssize_t>(chunk.size());
+    }
+    ok = ok && write(fd, "\n", 1) == 1;
+    return close(fd) == 0 && ok;
+}
+
+/**
+ * @brief Закрытие входного и выходного файлов замера
+ * @details Закрываются только открытые дескрипторы: при ошибке открытия
+ *          одного из файлов другой всё равно нужно закрыть.
+ * @param in Дескриптор входного файла или -1
+ * @param out Дескриптор выходного файла или -1
+ */
+inline void benchCloseFiles(int in, int out)
+{
+    if (in >= 0) {
+        close(in);
+    }
+    if (out >= 0) {
+        close(out);
+    }
+}
+
+/**
+ * @brief Последовательная обработка файла целиком через отображение в память
+ * @details Как файловый режим программы шифра: вход отображается только для
+ *          чтения, выход создаётся размером со вход и после обработки
+ *          усекается. Чтение и запись идут внутри f через страничные
+ *          прерывания и не перекрываются с преобразованием.
+ * @param inputPath Имя входного файла
+ * @param outputPath Имя выходного файла
+ * @param f Преобразование текста без завершающего перевода строки в буфер,
+ *          возвращает размер результата
+ * @return Итоги обработки; время стадий не разделяется и учтено в seconds
+ * @throw filePipeline_error При ошибке открытия, отображения или записи файлов
+ */
+template <typename F>
+filePipeline::report benchMapped(const char* inputPath, const char* outputPath, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const int in = open(inputPath, O_RDONLY);
+    const int out = open(outputPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    struct stat st;
+    if (in < 0 || out < 0 || fstat(in, &st) != 0 || st.st_size == 0 || ftruncate(out, st.st_size) != 0) {
+        benchCloseFiles(in, out);
+        throw filePipeline_error("не удалось подготовить файлы замера");
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* text = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, in, 0);
+    void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, out, 0);
+    if (text == MAP_FAILED || result == MAP_FAILED) {
+        // Снимается только то отображение, которое удалось создать
+        if (text != MAP_FAILED) {
+            munmap(text, size);
+        }
+        if (result != MAP_FAILED) {
+            munmap(result, size);
+        }
+        benchCloseFiles(in, out);
+        throw filePipeline_error("не удалось отобразить файлы замера в память");
+    }
+    std::string_view view(static_cast<const char*>(text), size);
+    if (view.back() == '\n') {
+        view.remove_suffix(1);
+    }
+    const size_t n = f(view, static_cast<char*>(result), size);
+    munmap(text, size);
+    munmap(result, size);
+    const bool ok = ftruncate(out, static_cast<off_t>(n)) == 0;
+    close(in);
+    if (close(out) != 0 || !ok) {
+        throw filePipeline_error("не удалось записать результат замера");
+    }
+    filePipeline::report report;
+    report.bytesIn = size;
+    report.bytesOut = n;
+    report.blocks = 1;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+/**
+ * @brief Обработка файла конвейером
+ * @param pipeline Конвейер
+ * @param inputPath Имя входного файла
+ * @param outputPath Имя выходного файла
+ * @return Итоги работы конвейера
+ * @throw filePipeline_error При ошибке открытия файлов или работы конвейера
+ */
+inline filePipeline::report benchPipeline(const filePipeline& pipeline, const char* inputPath, const char* outputPath)
+{
+    const int in = open(inputPath, O_RDONLY);
+    const int out = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (in < 0 || out < 0) {
+        benchCloseFiles(in, out);
+        throw filePipeline_error("не удалось открыть файлы замера");
+    }
+    filePipeline::report report;
+    try {
+        report = pipeline.run(in, out);
+    } catch (...) {
+        close(in);
+        close(out);
+        throw;
+    }
+    close(in);
+    if (close(out) != 0) {
+        throw filePipeline_error("не удалось записать результат замера");
+    }
+    return report;
+}
+
+/**
+ * @brief Вывод строки CSV замера обработки файла
+ * @details Столбцы: module, operation, api, workers, bytes, seconds, mb_per_s,
+ *          read_s, transform_s, write_s. Скорость считается по входному файлу.
+ * @param module Имя модуля
+ * @param operation encrypt или decrypt
+ * @param api mapped или pipeline
+ * @param workers Количество рабочих потоков
+ * @param r Итоги обработки
+ */
+inline void benchFileRow(const char* module, const char* operation, const char* api, unsigned workers,
+                         const filePipeline::report& r)
+{
+    std::printf("%s,%s,%s,%u,%llu,%.3f,%.1f,%.3f,%.3f,%.3f\n", module, operation, api, workers, r.bytesIn,
+                r.seconds, r.seconds > 0 ? r.bytesIn / r.seconds / (1 << 20) : 0.0, r.readSeconds,
+                r.transformSeconds, r.writeSeconds);
+    std::fflush(stdout);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bench_anyCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Замер накладных расходов общего интерфейса шифров на коротких сообщениях
+ * @details Для обоих шифров и сообщений из 8, 16, 64 и 256 символов печатает
+ *          в CSV наносекунды на сообщение для прямого вызова tryEncrypt
+ *          модуля, tryEncrypt через anyCipher, пакета модуля и пакета через
+ *          anyCipher, а также разницу между прямым вызовом и anyCipher.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "anyCipher.h"
+#include "benchSuite.h"
+#include "../1_Zadanie/modAlphaCipher.h"
+#include "../2_Zadanie/tableCipher.h"
+
+/**
+ * @brief Замер одного шифра для сообщений разной длины
+ * @param direct Шифр модуля
+ * @param any Тот же шифр за общим интерфейсом
+ */
+template <typename Cipher>
+void run(const Cipher& direct, const anyCipher& any)
+{
+    const std::wstring sample = L"СЪЕШЬ ЖЕ ЕЩЁ ЭТИХ МЯГКИХ ФРАНЦУЗСКИХ БУЛОК ДА ВЫПЕЙ ЧАЮ ";
+    for (size_t chars : {8, 16, 64, 256}) {
+        const size_t count = 200000 / (chars / 8);
+        std::vector<std::string> messages(count);
+        std::string text;
+        std::vector<size_t> offsets(1, 0);
+        for (size_t i = 0; i < count; i++) {
+            std::wstring message;
+            for (size_t j = 0; j < chars; j++) {
+                message += sample[(i + j) % sample.size()];
+            }
+            messages[i] = benchUtf8(message);
+            text += messages[i];
+            offsets.push_back(text.size());
+        }
+
+        const int rounds = 10;
+        std::string out;
+        double directCall = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                n += direct.tryEncrypt(std::string_view(m), out) == Cipher::textStatus::ok;
+            }
+            return n;
+        }, count, rounds);
+        double anyCall = benchNsPerMessage([&] {
+            size_t n = 0;
+            for (const std::string& m : messages) {
+                n += any.tryEncrypt(m, out) == cipherStatus::ok;
+            }
+            return n;
+        }, count, rounds);
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<typename Cipher::textStatus> directStatus;
+        double directBatch = benchNsPerMessage([&] {
+            return direct.encryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, directStatus);
+        }, count, rounds);
+        std::vector<cipherStatus> status;
+        double anyBatch = benchNsPerMessage([&] {
+            return any.encryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, status);
+        }, count, rounds);
+        std::printf("%s,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", any.name(), chars, count, directCall, anyCall,
+                    directBatch, anyBatch, anyCall - directCall, anyBatch - directBatch);
+    }
+}
+
+/**
+ * @brief Главная функция программы
+ * @return 0 при успешном выполнении
+ */
+int main()
+{
+    cipherRegistry registry;
+    std::printf("cipher,chars,messages,direct_call_ns,any_call_ns,direct_batch_ns,any_batch_ns,"
+                "call_overhead_ns,batch_overhead_ns\n");
+    run(modAlphaCipher(L"ИНТЕРФЕЙС"), registry.make("gronsfeld:ИНТЕРФЕЙС"));
+    run(tableCipher(5), registry.make("table:5"));
+    return 0;
+}
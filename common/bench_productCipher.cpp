@@ -0,0 +1,76 @@
+/**
+ * @file bench_productCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Сравнение составного шифра с последовательным применением двух шифров
+ * @details Перебирает длины текста от --min-chars символов до --max-mb в UTF-8
+ *          и количества столбцов и печатает в CSV (--json - в JSON) замеры
+ *          цепочки modAlphaCipher и tableCipher (api chain) и productCipher
+ *          (api fused) для UTF-8 и широких строк. Столбец выделенных байтов
+ *          на символ показывает промежуточную строку цепочки.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include "productCipher.h"
+#include "benchSuite.h"
+
+/**
+ * @brief Главная функция программы
+ * @param argc Количество аргументов
+ * @param argv Аргументы: [--json|--csv] [--max-mb N] [--min-chars N]
+ * @return 0 при успешном выполнении, 1 при неверных аргументах
+ */
+int main(int argc, char** argv)
+{
+    benchOptions options;
+    if (!options.parse(argc, argv) || options.mode != nullptr) {
+        std::fprintf(stderr, "Использование: %s [--json|--csv] [--max-mb N] [--min-chars N]\n", argv[0]);
+        return 1;
+    }
+    // Широкие строки занимают вдвое больше UTF-8, для них длина текста ограничена
+    const size_t maxWideChars = size_t(1) << 26;
+    const std::wstring key = L"СОСТАВНОЙКЛЮЧ";
+    modAlphaCipher substitution(key);
+
+    benchReport report(options.json);
+    for (size_t chars = std::max<size_t>(options.minChars, 64); 2 * chars <= options.maxBytes; chars *= 4) {
+        size_t letters = 0;
+        const std::string text = benchText(chars, true, letters);
+        const std::wstring wide = chars <= maxWideChars ? benchWide(text) : std::wstring();
+        for (int columns : {5, 64}) {
+            if (static_cast<size_t>(columns) >= letters) {
+                continue;
+            }
+            tableCipher transposition(columns);
+            productCipher product(key, columns);
+            const std::string cipherText = product.encrypt(std::string_view(text));
+
+            auto add = [&](const char* operation, const char* api, size_t bytes, auto f) {
+                report.add("product", operation, api, chars, bytes, columns, 1, benchMeasure(f, chars, bytes));
+            };
+            add("encrypt", "chain_utf8", text.size(), [&] {
+                return transposition.encrypt(std::string_view(substitution.encrypt(std::string_view(text)))).size();
+            });
+            add("encrypt", "fused_utf8", text.size(), [&] { return product.encrypt(std::string_view(text)).size(); });
+            add("decrypt", "chain_utf8", cipherText.size(), [&] {
+                return substitution.decrypt(std::string_view(transposition.decrypt(std::string_view(cipherText)))).size();
+            });
+            add("decrypt", "fused_utf8", cipherText.size(), [&] {
+                return product.decrypt(std::string_view(cipherText)).size();
+            });
+            if (wide.empty()) {
+                continue;
+            }
+            const size_t wideBytes = wide.size() * sizeof(wchar_t);
+            add("encrypt", "chain_wide", wideBytes, [&] {
+                return transposition.encrypt(substitution.encrypt(wide)).size();
+            });
+            add("encrypt", "fused_wide", wideBytes, [&] { return product.encrypt(wide).size(); });
+        }
+    }
+    return 0;
+}
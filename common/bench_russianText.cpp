@@ -0,0 +1,86 @@
+/**
+ * @file bench_russianText.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Сравнение стоимости нормализации сообщения через std::locale и по таблицам russianText
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <locale>
+#include <string>
+#include "russianText.h"
+
+/**
+ * @brief Нормализация так, как её выполняли модули до перехода на таблицы
+ * @details Локаль создаётся заново для каждого сообщения, каждый символ
+ *          приводится к верхнему регистру через фасет локали.
+ * @param s Входная строка
+ * @param name Имя локали
+ * @return Строка в верхнем регистре без пробелов
+ */
+std::wstring localeStripUpper(const std::wstring& s, const char* name)
+{
+    std::wstring result;
+    std::locale loc(name);
+    for (wchar_t c : s) {
+        if (c != L' ') {
+            result.push_back(std::toupper(c, loc));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Среднее время обработки одного сообщения
+ * @param f Нормализация одного сообщения
+ * @param text Сообщение
+ * @param iterations Количество повторов
+ * @return Наносекунды на сообщение
+ */
+template <typename F>
+double nsPerMessage(F f, const std::wstring& text, int iterations)
+{
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += f(text).size();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sink == 0) {
+        std::printf("#\n");
+    }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+/**
+ * @brief Главная функция программы
+ * @return 0 при успешном выполнении
+ */
+int main()
+{
+    // Локаль ru_RU.UTF-8 может отсутствовать, тогда для сравнения берётся C.UTF-8
+    const char* name = "ru_RU.UTF-8";
+    try {
+        std::locale probe(name);
+    } catch (const std::exception&) {
+        name = "C.UTF-8";
+    }
+
+    const std::wstring sample = L"Съешь же ещё этих мягких французских булок, да выпей чаю ";
+    std::printf("chars,locale_ns_per_msg,table_ns_per_msg,speedup  # locale %s\n", name);
+    for (size_t chars : {16, 64, 256, 4096}) {
+        std::wstring text;
+        while (text.size() < chars) {
+            text += sample;
+        }
+        text.resize(chars);
+        const int iterations = static_cast<int>(4000000 / chars) + 100;
+        double before = nsPerMessage([&](const std::wstring& s) { return localeStripUpper(s, name); }, text, iterations);
+        double after = nsPerMessage(russianText::stripUpper, text, iterations);
+        std::printf("%zu,%.1f,%.1f,%.1f\n", chars, before, after, before / after);
+    }
+    return 0;
+}
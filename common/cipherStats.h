@@ -0,0 +1,329 @@
+/**
+ * @file cipherStats.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Встроенные счётчики горячего пути шифров
+ * @details Счётчики включаются при сборке с -DCIPHER_STATS. Без этого
+ *          макроса все функции записи пустые и встраиваются в ничто, таймеры
+ *          не обращаются к часам, а snapshot возвращает нули. Включённые
+ *          счётчики читают часы несколько раз за вызов, поэтому заметно
+ *          замедляют только короткие сообщения.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#ifdef CIPHER_STATS
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+#endif
+
+/**
+ * @brief Этап обработки текста
+ */
+enum class cipherStage : unsigned char {
+    normalize, ///< Декодирование, приведение регистра и удаление пробелов
+    validate, ///< Отдельный проход проверки текста
+    transform, ///< Сдвиг или перестановка букв
+    encode ///< Запись результата в строку или буфер
+};
+
+/**
+ * @brief Снимок счётчиков модуля
+ * @details Этапы, которые модуль выполняет за один общий проход, учитываются
+ *          в том этапе, которым проход заканчивается (для перестановки -
+ *          transform), поэтому время отдельного этапа может быть нулевым.
+ */
+struct cipherCounters {
+    static constexpr size_t stageCount = 4; ///< Количество этапов cipherStage
+    static constexpr size_t reasonCount = 8; ///< Наибольшее количество значений textStatus модуля
+
+    unsigned long long calls = 0; ///< Вызовы зашифровывания и расшифровывания (сообщения пакета - по одному)
+    unsigned long long chars = 0; ///< Обработанные единицы входного текста (wchar_t или байты UTF-8)
+    unsigned long long failures[reasonCount] = {}; ///< Отказы по причинам, индекс - значение textStatus модуля
+    unsigned long long allocatedBytes = 0; ///< Байты, выделенные модулем под результаты и рабочие буферы
+    unsigned long long stageNs[stageCount] = {}; ///< Суммарное время этапов в наносекундах, индекс - cipherStage
+
+    /**
+     * @brief Запись снимка в JSON
+     * @param module Имя модуля
+     * @return Объект JSON в одну строку
+     */
+    std::string toJson(const char* module) const
+    {
+        char buffer[512];
+        std::snprintf(buffer, sizeof buffer,
+                      "{\"module\": \"%s\", \"calls\": %llu, \"chars\": %llu, \"allocated_bytes\": %llu, "
+                      "\"normalize_ns\": %llu, \"validate_ns\": %llu, \"transform_ns\": %llu, \"encode_ns\": %llu, "
+                      "\"failures\": [",
+                      module, calls, chars, allocatedBytes, stageNs[0], stageNs[1], stageNs[2], stageNs[3]);
+        std::string result = buffer;
+        for (size_t i = 0; i < reasonCount; i++) {
+            result += (i == 0 ? "" : ", ") + std::to_string(failures[i]);
+        }
+        return result + "]}";
+    }
+};
+
+/**
+ * @brief Счётчики горячего пути модуля
+ * @details У каждого потока свой набор счётчиков для каждого модуля Module,
+ *          поэтому запись не использует атомарных операций чтения-изменения:
+ *          поток-владелец сам читает и перезаписывает свои значения, а
+ *          snapshot складывает наборы всех потоков. Набор завершившегося
+ *          потока остаётся в сумме и достаётся следующему новому потоку,
+ *          поэтому наборов не больше, чем потоков, одновременно ведущих
+ *          счётчики, даже если потоки создаются на каждый вызов.
+ * @tparam Module Класс шифра, для которого ведутся счётчики
+ */
+template <typename Module>
+class cipherStats
+{
+public:
+#ifdef CIPHER_STATS
+    static constexpr bool enabled = true; ///< Счётчики включены при сборке
+#else
+    static constexpr bool enabled = false; ///< Счётчики включены при сборке
+#endif
+
+private:
+#ifdef CIPHER_STATS
+    static constexpr size_t failuresField = 3; ///< Первое поле отказов
+    static constexpr size_t stageField = failuresField + cipherCounters::reasonCount; ///< Первое поле этапов
+    static constexpr size_t fieldCount = stageField + cipherCounters::stageCount; ///< Количество полей набора
+
+    /**
+     * @brief Набор счётчиков одного потока
+     */
+    struct slot {
+        std::atomic<unsigned long long> values[fieldCount] = {}; ///< calls, chars, allocatedBytes, отказы, этапы
+    };
+
+    /**
+     * @brief Защита списка наборов
+     * @return Мьютекс модуля
+     */
+    static std::mutex& lock()
+    {
+        static std::mutex instance;
+        return instance;
+    }
+
+    /**
+     * @brief Наборы счётчиков всех потоков
+     * @return Список наборов, адреса элементов не меняются
+     */
+    static std::deque<slot>& slots()
+    {
+        static std::deque<slot> instance;
+        return instance;
+    }
+
+    /**
+     * @brief Наборы завершившихся потоков, ожидающие нового владельца
+     * @return Список свободных наборов
+     */
+    static std::vector<slot*>& idle()
+    {
+        static std::vector<slot*> instance;
+        return instance;
+    }
+
+    /**
+     * @brief Возврат набора в список свободных при завершении потока
+     */
+    struct owner {
+        slot*& mine; ///< Указатель потока на его набор
+
+        /**
+         * @brief Деструктор, освобождающий набор потока
+         */
+        ~owner()
+        {
+            std::lock_guard<std::mutex> guard(lock());
+            idle().push_back(mine);
+            mine = nullptr;
+        }
+    };
+
+    /**
+     * @brief Набор счётчиков текущего потока
+     * @details Берётся при первой записи в потоке из свободных наборов или
+     *          создаётся; значения свободного набора сохраняются, так что
+     *          поток продолжает их сумму.
+     * @return Набор потока
+     */
+    static slot& local()
+    {
+        thread_local slot* mine = nullptr;
+        if (mine == nullptr) {
+            {
+                std::lock_guard<std::mutex> guard(lock());
+                if (idle().empty()) {
+                    mine = &slots().emplace_back();
+                } else {
+                    mine = idle().back();
+                    idle().pop_back();
+                }
+            }
+            thread_local owner release{mine};
+        }
+        return *mine;
+    }
+
+    /**
+     * @brief Увеличение счётчика текущего потока
+     * @param field Номер поля
+     * @param n Приращение
+     */
+    static void add(size_t field, unsigned long long n)
+    {
+        std::atomic<unsigned long long>& value = local().values[field];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Текущее время в наносекундах
+     * @return Показание монотонных часов
+     */
+    static unsigned long long now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+#endif
+
+public:
+    /**
+     * @brief Учёт вызова
+     * @param chars Количество единиц входного текста
+     */
+    static void call(size_t chars)
+    {
+#ifdef CIPHER_STATS
+        add(0, 1);
+        add(1, chars);
+#else
+        (void)chars;
+#endif
+    }
+
+    /**
+     * @brief Учёт отказа
+     * @param reason Значение textStatus модуля, меньше reasonCount
+     */
+    static void failure(unsigned reason)
+    {
+#ifdef CIPHER_STATS
+        add(failuresField + reason % cipherCounters::reasonCount, 1);
+#else
+        (void)reason;
+#endif
+    }
+
+    /**
+     * @brief Учёт выделенной памяти
+     * @param bytes Количество байтов
+     */
+    static void allocated(size_t bytes)
+    {
+#ifdef CIPHER_STATS
+        add(2, bytes);
+#else
+        (void)bytes;
+#endif
+    }
+
+    /**
+     * @brief Сумма счётчиков всех потоков
+     * @return Снимок счётчиков; без CIPHER_STATS - нули
+     */
+    static cipherCounters snapshot()
+    {
+        cipherCounters result;
+#ifdef CIPHER_STATS
+        std::lock_guard<std::mutex> guard(lock());
+        for (const slot& s : slots()) {
+            auto get = [&](size_t field) { return s.values[field].load(std::memory_order_relaxed); };
+            result.calls += get(0);
+            result.chars += get(1);
+            result.allocatedBytes += get(2);
+            for (size_t i = 0; i < cipherCounters::reasonCount; i++) {
+                result.failures[i] += get(failuresField + i);
+            }
+            for (size_t i = 0; i < cipherCounters::stageCount; i++) {
+                result.stageNs[i] += get(stageField + i);
+            }
+        }
+#endif
+        return result;
+    }
+
+    /**
+     * @brief Количество наборов счётчиков
+     * @return Наибольшее число потоков, одновременно ведших счётчики; без
+     *         CIPHER_STATS - ноль
+     */
+    static size_t slotCount()
+    {
+#ifdef CIPHER_STATS
+        std::lock_guard<std::mutex> guard(lock());
+        return slots().size();
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Обнуление счётчиков всех потоков
+     * @details Запись, идущая в другом потоке одновременно со сбросом,
+     *          может вернуть прежнее значение своего счётчика.
+     */
+    static void reset()
+    {
+#ifdef CIPHER_STATS
+        std::lock_guard<std::mutex> guard(lock());
+        for (slot& s : slots()) {
+            for (std::atomic<unsigned long long>& value : s.values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Секундомер этапов
+     * @details lap относит время с создания или с прошлого lap к этапу,
+     *          так что последовательные этапы одного прохода замеряются без
+     *          пропусков одним чтением часов на границу.
+     */
+    class stopwatch
+    {
+#ifdef CIPHER_STATS
+    private:
+        unsigned long long last = now(); ///< Время последней отметки
+#endif
+
+    public:
+        /**
+         * @brief Отметка конца этапа
+         * @param s Завершившийся этап
+         */
+        void lap(cipherStage s)
+        {
+#ifdef CIPHER_STATS
+            const unsigned long long t = now();
+            add(stageField + static_cast<size_t>(s), t - last);
+            last = t;
+#else
+            (void)s;
+#endif
+        }
+    };
+};
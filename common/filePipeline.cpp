@@ -0,0 +1,381 @@
+/**
+ * @file filePipeline.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация модуля конвейерной обработки файлов
+ */
+
+#include "filePipeline.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using steadyClock = std::chrono::steady_clock;
+
+/**
+ * @brief Время в секундах с заданного момента
+ * @param start Начало отсчёта
+ * @return Прошедшее время в секундах
+ */
+inline double since(steadyClock::time_point start)
+{
+    return std::chrono::duration<double>(steadyClock::now() - start).count();
+}
+
+/**
+ * @brief Буфер кольца
+ */
+struct slot {
+    std::string in; ///< Блок входа
+    std::string out; ///< Результат преобразования блока
+    bool done = false; ///< Результат готов к записи
+};
+
+/**
+ * @brief Общее состояние потоков конвейера
+ * @details Все поля, кроме содержимого буферов, защищены lock. Буфер блока i
+ *          принадлежит потоку чтения до публикации, затем рабочему потоку до
+ *          done, затем потоку записи до освобождения.
+ */
+struct pipelineState {
+    std::vector<slot> ring; ///< Кольцо буферов
+    std::mutex lock; ///< Защита состояния
+    std::condition_variable changed; ///< Изменение любого счётчика
+    size_t published = 0; ///< Количество блоков, переданных рабочим потокам
+    bool eof = false; ///< Поток чтения опубликовал последний блок
+    size_t taken = 0; ///< Следующий блок для рабочего потока
+    size_t ordered = 0; ///< Следующий блок для сложения смещений
+    unsigned long long offset = 0; ///< Сумма мер блоков до ordered
+    size_t written = 0; ///< Количество записанных блоков
+    bool stop = false; ///< Работа прервана ошибкой
+    std::exception_ptr failure; ///< Первая ошибка
+    double transformSeconds = 0; ///< Время занятости преобразования
+
+    /**
+     * @brief Остановка конвейера из-за ошибки
+     * @param e Исключение
+     */
+    void fail(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!stop) {
+            stop = true;
+            failure = e;
+        }
+        changed.notify_all();
+    }
+};
+
+/**
+ * @brief Продолжающий байт последовательности UTF-8
+ * @param c Байт
+ * @return true для байтов 10xxxxxx
+ */
+inline bool isContinuation(char c)
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+/**
+ * @brief Конец блока в режиме utf8
+ * @details Незавершённая последовательность UTF-8 и, если перед ней есть
+ *          другие данные, завершающий перевод строки переносятся в следующий
+ *          блок, чтобы перевод строки в конце файла можно было отбросить.
+ * @param s Прочитанные данные
+ * @return Длина блока, остаток переносится в следующий блок
+ */
+size_t cutUtf8(const std::string& s)
+{
+    size_t cut = s.size();
+    size_t k = cut;
+    while (k > 0 && cut - k < 3 && isContinuation(s[k - 1])) {
+        k--;
+    }
+    if (k > 0) {
+        const unsigned char lead = static_cast<unsigned char>(s[k - 1]);
+        const size_t need = lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        if (cut - (k - 1) < need) {
+            cut = k - 1;
+        }
+    }
+    size_t keep = cut;
+    if (keep > 0 && s[keep - 1] == '\n') {
+        keep--;
+        if (keep > 0 && s[keep - 1] == '\r') {
+            keep--;
+        }
+    }
+    return keep > 0 ? keep : cut;
+}
+
+/**
+ * @brief Поток чтения
+ * @param state Состояние конвейера
+ * @param fd Дескриптор входа
+ * @param settings Параметры конвейера
+ * @param capacity Наибольший размер блока в байтах
+ * @param readSeconds Время занятости чтения
+ * @param bytesIn Прочитано байтов
+ */
+void readerLoop(pipelineState& state, int fd, const filePipeline::options& settings, size_t capacity,
+                double& readSeconds, unsigned long long& bytesIn)
+{
+    struct stat st;
+    const bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    const unsigned long long fileSize = regular ? static_cast<unsigned long long>(st.st_size) : 0;
+
+    std::string carry;
+    carry.reserve(capacity);
+    bool eof = false;
+    for (size_t index = 0; !eof; index++) {
+        {
+            std::unique_lock<std::mutex> guard(state.lock);
+            state.changed.wait(guard, [&] { return state.stop || index - state.written < state.ring.size(); });
+            if (state.stop) {
+                return;
+            }
+        }
+        slot& s = state.ring[index % state.ring.size()];
+
+        // Остаток обычного файла, помещающийся в один буфер, читается одним блоком
+        size_t want = settings.cut == filePipeline::framing::lines ? capacity : settings.blockSize;
+        if (regular && fileSize >= bytesIn && carry.size() + (fileSize - bytesIn) <= capacity) {
+            want = carry.size() + static_cast<size_t>(fileSize - bytesIn);
+        }
+        s.in.swap(carry);
+        size_t n = s.in.size();
+        s.in.resize(want);
+        const steadyClock::time_point start = steadyClock::now();
+        while (n < want) {
+            const ssize_t r = ::read(fd, &s.in[n], want - n);
+            if (r < 0 && errno == EINTR) {
+                continue;
+            }
+            if (r < 0) {
+                throw filePipeline_error(std::string("ошибка чтения: ") + std::strerror(errno));
+            }
+            if (r == 0) {
+                eof = true;
+                break;
+            }
+            n += static_cast<size_t>(r);
+            bytesIn += static_cast<unsigned long long>(r);
+        }
+        // Обычный файл читается до размера, который был у него при запуске
+        if (regular && bytesIn >= fileSize) {
+            eof = true;
+        }
+        readSeconds += since(start);
+        s.in.resize(n);
+
+        size_t length = n;
+        size_t cut = n;
+        if (eof && settings.cut == filePipeline::framing::utf8) {
+            // Завершающий перевод строки файла не входит в текст
+            if (length > 0 && s.in[length - 1] == '\n') {
+                length--;
+                if (length > 0 && s.in[length - 1] == '\r') {
+                    length--;
+                }
+            }
+        } else if (settings.cut == filePipeline::framing::utf8) {
+            cut = length = cutUtf8(s.in);
+        } else if (!eof) {
+            const char* last = static_cast<const char*>(memrchr(s.in.data(), '\n', n));
+            if (last == nullptr) {
+                throw filePipeline_error("строка длиннее блока конвейера");
+            }
+            cut = length = last + 1 - s.in.data();
+        }
+        carry.assign(s.in, cut, std::string::npos);
+        s.in.resize(length);
+        if (s.in.empty()) {
+            // Пустой блок не публикуется, буфер остаётся свободным
+            index--;
+            if (eof) {
+                break;
+            }
+            continue;
+        }
+
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.published = index + 1;
+        state.eof = eof;
+        state.changed.notify_all();
+    }
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.eof = true;
+    state.changed.notify_all();
+}
+
+/**
+ * @brief Рабочий поток
+ * @param state Состояние конвейера
+ * @param measure Мера блока или пустая функция
+ * @param transform Преобразование блока
+ */
+void workerLoop(pipelineState& state, const filePipeline::measureFn& measure,
+                const filePipeline::transformFn& transform)
+{
+    for (;;) {
+        size_t index = 0;
+        {
+            std::unique_lock<std::mutex> guard(state.lock);
+            state.changed.wait(guard, [&] { return state.stop || state.taken < state.published || state.eof; });
+            if (state.stop || state.taken == state.published) {
+                return;
+            }
+            index = state.taken++;
+        }
+        slot& s = state.ring[index % state.ring.size()];
+
+        const steadyClock::time_point start = steadyClock::now();
+        const unsigned long long m = measure ? measure(s.in) : 0;
+        double busy = since(start);
+        unsigned long long offset = 0;
+        {
+            std::unique_lock<std::mutex> guard(state.lock);
+            state.changed.wait(guard, [&] { return state.stop || state.ordered == index; });
+            if (state.stop) {
+                return;
+            }
+            offset = state.offset;
+            state.offset += m;
+            state.ordered++;
+            state.changed.notify_all();
+        }
+        const steadyClock::time_point resumed = steadyClock::now();
+        transform(s.in, offset, s.out);
+        busy += since(resumed);
+
+        std::lock_guard<std::mutex> guard(state.lock);
+        s.done = true;
+        state.transformSeconds += busy;
+        state.changed.notify_all();
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор конвейера
+ * @param o Параметры
+ * @param m Мера блока; пустая функция - смещения всех блоков равны нулю
+ * @param t Преобразование блока
+ * @throw filePipeline_error Если размер блока меньше 16 байтов
+ */
+filePipeline::filePipeline(const options& o, measureFn m, transformFn t)
+    : settings(o), measure(std::move(m)), transform(std::move(t))
+{
+    if (settings.blockSize < 16) {
+        throw filePipeline_error("размер блока конвейера меньше 16 байтов");
+    }
+    if (settings.workers == 0) {
+        settings.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (settings.ringBlocks == 0) {
+        settings.ringBlocks = 2 * static_cast<size_t>(settings.workers) + 2;
+    }
+    settings.ringBlocks = std::max<size_t>(settings.ringBlocks, 2);
+}
+
+/**
+ * @brief Обработка входа до конца
+ * @param inputFd Дескриптор входного файла, открытого на чтение
+ * @param outputFd Дескриптор выходного файла, открытого на запись
+ * @return Итоги работы
+ * @throw filePipeline_error При ошибке чтения или записи или слишком длинной строке в режиме lines
+ */
+filePipeline::report filePipeline::run(int inputFd, int outputFd) const
+{
+    const steadyClock::time_point started = steadyClock::now();
+    // Блок может быть длиннее blockSize на присоединённый остаток файла
+    const size_t capacity = settings.blockSize + settings.blockSize / 2;
+    pipelineState state;
+    state.ring.resize(settings.ringBlocks);
+    for (slot& s : state.ring) {
+        s.in.reserve(capacity);
+    }
+
+    report result;
+    std::thread reader([&] {
+        try {
+            readerLoop(state, inputFd, settings, capacity, result.readSeconds, result.bytesIn);
+        } catch (...) {
+            state.fail(std::current_exception());
+        }
+    });
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < settings.workers; t++) {
+        workers.emplace_back([&] {
+            try {
+                workerLoop(state, measure, transform);
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        });
+    }
+
+    // Запись в вызывающем потоке, строго по порядку блоков
+    try {
+        for (size_t index = 0;; index++) {
+            {
+                std::unique_lock<std::mutex> guard(state.lock);
+                state.changed.wait(guard, [&] {
+                    return state.stop || (index < state.published && state.ring[index % state.ring.size()].done)
+                        || (state.eof && index == state.published);
+                });
+                if (state.stop || index == state.published) {
+                    break;
+                }
+            }
+            slot& s = state.ring[index % state.ring.size()];
+            const steadyClock::time_point start = steadyClock::now();
+            size_t done = 0;
+            while (done < s.out.size()) {
+                const ssize_t w = ::write(outputFd, s.out.data() + done, s.out.size() - done);
+                if (w < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (w < 0) {
+                    throw filePipeline_error(std::string("ошибка записи: ") + std::strerror(errno));
+                }
+                done += static_cast<size_t>(w);
+            }
+            result.writeSeconds += since(start);
+            result.bytesOut += s.out.size();
+
+            std::lock_guard<std::mutex> guard(state.lock);
+            s.done = false;
+            state.written = index + 1;
+            state.changed.notify_all();
+        }
+    } catch (...) {
+        state.fail(std::current_exception());
+    }
+
+    reader.join();
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    if (state.failure) {
+        std::rethrow_exception(state.failure);
+    }
+    result.blocks = state.written;
+    result.measured = state.offset;
+    result.transformSeconds = state.transformSeconds;
+    result.seconds = since(started);
+    return result;
+}
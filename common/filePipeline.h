@@ -0,0 +1,138 @@
+/**
+ * @file filePipeline.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для модуля конвейерной обработки файлов
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Класс исключений для ошибок ввода-вывода конвейера
+ */
+class filePipeline_error : public std::runtime_error
+{
+public:
+    /**
+     * @brief Конструктор с сообщением об ошибке
+     * @param what_arg Сообщение об ошибке
+     */
+    explicit filePipeline_error(const std::string& what_arg) : std::runtime_error(what_arg) {}
+
+    /**
+     * @brief Конструктор с сообщением об ошибке
+     * @param what_arg Сообщение об ошибке
+     */
+    explicit filePipeline_error(const char* what_arg) : std::runtime_error(what_arg) {}
+};
+
+/**
+ * @brief Конвейер чтение - преобразование - запись для больших файлов
+ * @details Поток чтения заполняет кольцо буферов фиксированного размера,
+ *          рабочие потоки преобразуют блоки независимо друг от друга, а
+ *          вызывающий поток записывает результаты строго в порядке блоков.
+ *          Поток чтения ждёт, пока освободится буфер кольца, поэтому память
+ *          ограничена размером кольца и не зависит от размера файла, а чтение,
+ *          преобразование и запись идут одновременно.
+ *
+ *          Преобразованию блока передаётся смещение - сумма значений measure
+ *          всех предыдущих блоков (например, количество букв перед блоком для
+ *          фазы ключа). measure вызывается в рабочих потоках параллельно, и
+ *          только сложение смещений идёт по порядку блоков.
+ *
+ *          Блок заканчивается на границе символа UTF-8 или, в режиме lines,
+ *          после перевода строки. Завершающий перевод строки файла (\\n или
+ *          \\r\\n) в режиме utf8 не передаётся в преобразование. Если входной
+ *          файл обычный и после блока осталось меньше половины блока, остаток
+ *          присоединяется к последнему блоку, чтобы он не оказался коротким.
+ */
+class filePipeline
+{
+public:
+    /**
+     * @brief Способ деления входа на блоки
+     */
+    enum class framing {
+        utf8, ///< По границе символа UTF-8
+        lines ///< После последнего перевода строки блока
+    };
+
+    /**
+     * @brief Параметры конвейера
+     */
+    struct options {
+        size_t blockSize = size_t(1) << 22; ///< Размер блока чтения в байтах
+        unsigned workers = 0; ///< Количество рабочих потоков, 0 - по числу ядер процессора
+        size_t ringBlocks = 0; ///< Количество буферов кольца, 0 - два на рабочий поток и ещё два
+        framing cut = framing::utf8; ///< Способ деления входа на блоки
+    };
+
+    /**
+     * @brief Итоги работы конвейера
+     * @details Время занятости стадии - время внутри чтения, преобразования
+     *          (сумма по рабочим потокам) и записи. Стадия, занятая почти всё
+     *          время работы, ограничивает скорость конвейера.
+     */
+    struct report {
+        unsigned long long bytesIn = 0; ///< Прочитано байтов
+        unsigned long long bytesOut = 0; ///< Записано байтов
+        unsigned long long blocks = 0; ///< Количество блоков
+        unsigned long long measured = 0; ///< Сумма measure по всем блокам
+        double seconds = 0; ///< Время работы конвейера
+        double readSeconds = 0; ///< Время занятости чтения
+        double transformSeconds = 0; ///< Время занятости преобразования
+        double writeSeconds = 0; ///< Время занятости записи
+    };
+
+    /**
+     * @brief Мера блока, от которой зависят смещения следующих блоков
+     */
+    using measureFn = std::function<unsigned long long(std::string_view block)>;
+
+    /**
+     * @brief Преобразование блока
+     * @details Записывает результат в out (строка переиспользуется между
+     *          блоками одного буфера кольца) и выбрасывает исключение при
+     *          ошибке в данных.
+     */
+    using transformFn = std::function<void(std::string_view block, unsigned long long offset, std::string& out)>;
+
+private:
+    options settings; ///< Параметры конвейера
+    measureFn measure; ///< Мера блока или пустая функция
+    transformFn transform; ///< Преобразование блока
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    filePipeline() = delete;
+
+    /**
+     * @brief Конструктор конвейера
+     * @param o Параметры
+     * @param m Мера блока; пустая функция - смещения всех блоков равны нулю
+     * @param t Преобразование блока
+     * @throw filePipeline_error Если размер блока меньше 16 байтов
+     */
+    filePipeline(const options& o, measureFn m, transformFn t);
+
+    /**
+     * @brief Обработка входа до конца
+     * @details После ошибки все потоки останавливаются; записанная к этому
+     *          моменту часть результата остаётся в выходном файле.
+     * @param inputFd Дескриптор входного файла, открытого на чтение
+     * @param outputFd Дескриптор выходного файла, открытого на запись
+     * @return Итоги работы
+     * @throw filePipeline_error При ошибке чтения или записи или слишком длинной строке в режиме lines
+     * @throw Исключение преобразования блока, если оно выброшено первым
+     */
+    report run(int inputFd, int outputFd) const;
+};
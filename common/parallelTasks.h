@@ -0,0 +1,58 @@
+/**
+ * @file parallelTasks.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для запуска задачи в нескольких потоках
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Запуск задачи в нескольких потоках, общий для модулей шифров
+ * @details Потоки создаются на время одной задачи и не переиспользуются,
+ *          поэтому задача должна быть достаточно большой, чтобы окупить их
+ *          создание; меньшие задачи выполняются в вызывающем потоке.
+ */
+class parallelTasks
+{
+public:
+    /**
+     * @brief Количество потоков для заданного числа независимых задач
+     * @param threads Запрошенное количество, 0 - по числу ядер процессора
+     * @param tasks Количество задач
+     * @return Количество потоков от 1 до tasks
+     */
+    static unsigned threadCount(unsigned threads, size_t tasks)
+    {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, tasks)));
+    }
+
+    /**
+     * @brief Выполнение задачи для каждого номера потока
+     * @details Задача с номером 0 выполняется в вызывающем потоке, остальные
+     *          - в потоках, созданных на время вызова.
+     * @param threads Количество потоков
+     * @param task Задача, принимающая номер потока
+     */
+    template <typename Task>
+    static void run(unsigned threads, const Task& task)
+    {
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) {
+            workers.emplace_back(task, t);
+        }
+        task(0u);
+        for (std::thread& w : workers) {
+            w.join();
+        }
+    }
+};
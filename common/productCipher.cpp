@@ -0,0 +1,336 @@
+/**
+ * @file productCipher.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация составного шифра: Гронсфельд, затем табличная перестановка
+ */
+
+#include "productCipher.h"
+#include "russianText.h"
+#include <vector>
+
+namespace {
+
+using stats = cipherStats<productCipher>; ///< Счётчики модуля
+
+constexpr int alphaSize = 33; ///< Количество букв алфавита
+constexpr unsigned substitutionReasons = 4; ///< Смещение отказов шифра Гронсфельда в счётчиках
+
+/**
+ * @brief Количество единиц строки на одну букву
+ * @details Буква занимает один wchar_t или два байта UTF-8
+ */
+template <typename Char>
+constexpr size_t unitsPerLetter = sizeof(Char) == 1 ? 2 : 1;
+
+/**
+ * @brief Буквы алфавита по номеру в обеих кодировках
+ */
+struct letterTable {
+    wchar_t wide[alphaSize]; ///< Буква по номеру
+    char utf8[alphaSize][2]; ///< Буква по номеру в кодировке UTF-8
+};
+
+/**
+ * @brief Получение таблицы букв
+ * @details Таблица строится один раз на процесс при первом обращении
+ * @return Ссылка на таблицу
+ */
+const letterTable& letters()
+{
+    static const letterTable t = [] {
+        letterTable r;
+        for (int i = 0; i < alphaSize; i++) {
+            r.wide[i] = russianText::alphabet()[i];
+            russianText::encodeLetter(r.wide[i], r.utf8[i]);
+        }
+        return r;
+    }();
+    return t;
+}
+
+/**
+ * @brief Очередной символ широкой строки
+ * @param p Текущая позиция, сдвигается на символ
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const wchar_t*& p, const wchar_t*)
+{
+    return static_cast<char32_t>(*p++);
+}
+
+/**
+ * @brief Очередной символ строки UTF-8
+ * @param p Текущая позиция, сдвигается за символ
+ * @param end Конец текста
+ * @return Кодовая точка
+ */
+inline char32_t nextChar(const char*& p, const char* end)
+{
+    return russianText::decodeUtf8(p, end);
+}
+
+/**
+ * @brief Запись буквы по номеру в широкую строку
+ * @param t Таблица букв
+ * @param index Номер буквы
+ * @param out Начало результата
+ * @param pos Номер буквы в результате
+ */
+inline void putLetter(const letterTable& t, int index, wchar_t* out, size_t pos)
+{
+    out[pos] = t.wide[index];
+}
+
+/**
+ * @brief Запись буквы по номеру в строку UTF-8
+ * @param t Таблица букв
+ * @param index Номер буквы
+ * @param out Начало результата
+ * @param pos Номер буквы в результате
+ */
+inline void putLetter(const letterTable& t, int index, char* out, size_t pos)
+{
+    out[2 * pos] = t.utf8[index][0];
+    out[2 * pos + 1] = t.utf8[index][1];
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор составного шифра
+ * @param key Ключ шифра Гронсфельда
+ * @param columns Количество столбцов таблицы
+ * @throw cipher_error Если ключ шифра Гронсфельда невалиден
+ * @throw tableCipher_error Если количество столбцов невалидно
+ */
+productCipher::productCipher(const std::wstring& key, int columns) : substitution(key), transposition(columns)
+{
+}
+
+/**
+ * @brief Зашифровывание в строку результата
+ * @param open_text Открытый текст
+ * @return Шифртекст
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ * @throw tableCipher_error Если букв не больше, чем столбцов
+ */
+template <typename Char>
+std::basic_string<Char> productCipher::encryptText(std::basic_string_view<Char> open_text) const
+{
+    stats::stopwatch watch;
+    stats::call(open_text.size());
+
+    // Проверки шифра Гронсфельда; длина для перестановки - по тем же буквам
+    size_t text_len = 0;
+    bool hasNonSpace = false;
+    const Char* p = open_text.data();
+    const Char* end = p + open_text.size();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        hasNonSpace = true;
+        text_len += russianText::letterIndex(c) >= 0;
+    }
+    watch.lap(cipherStage::validate);
+    if (text_len == 0) {
+        const modAlphaCipher::textStatus status = hasNonSpace ? modAlphaCipher::textStatus::invalidOpenText
+                                                              : modAlphaCipher::textStatus::emptyOpenText;
+        stats::failure(substitutionReasons + static_cast<unsigned>(status));
+        throw cipher_error(modAlphaCipher::statusMessage(status));
+    }
+    const size_t k = transposition.key;
+    if (text_len <= k) {
+        stats::failure(static_cast<unsigned>(tableCipher::textStatus::tooShort));
+        throw tableCipher_error(tableCipher::lengthMessage(text_len, transposition.key, "encryption"));
+    }
+
+    std::basic_string<Char> result(unitsPerLetter<Char> * text_len, Char(0));
+    stats::allocated(result.size() * sizeof(Char));
+    const letterTable& t = letters();
+    const std::vector<int>& shift = substitution.key;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
+
+    // Буква номер i * key + j сдвигается по ключу и сразу записывается в
+    // строку i столбца j шифртекста. Столбцы идут в шифртексте справа
+    // налево, поэтому следующий столбец строки начинается на его высоту
+    // раньше: rows букв при j < full, rows - 1 иначе
+    const size_t first = transposition.columnStart(0, rows, full);
+    size_t i = 0;
+    size_t j = 0;
+    size_t target = first;
+    size_t position = 0;
+    Char* out = &result[0];
+    p = open_text.data();
+    while (p != end) {
+        int index = russianText::letterIndex(nextChar(p, end));
+        if (index < 0) {
+            continue;
+        }
+        index += shift[position];
+        putLetter(t, index >= alphaSize ? index - alphaSize : index, out, target);
+        if (++position == shift.size()) {
+            position = 0;
+        }
+        if (++j == k) {
+            j = 0;
+            target = first + ++i;
+        } else {
+            target -= j < full ? rows : rows - 1;
+        }
+    }
+    watch.lap(cipherStage::transform);
+    return result;
+}
+
+/**
+ * @brief Расшифровывание в строку результата
+ * @param cipher_text Шифртекст
+ * @return Открытый текст
+ * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+ */
+template <typename Char>
+std::basic_string<Char> productCipher::decryptText(std::basic_string_view<Char> cipher_text) const
+{
+    stats::stopwatch watch;
+    stats::call(cipher_text.size());
+
+    // Проверки перестановки; её результат всегда допустим для шифра Гронсфельда
+    tableCipher::textStatus status = tableCipher::textStatus::ok;
+    size_t text_len = 0;
+    const Char* p = cipher_text.data();
+    const Char* end = p + cipher_text.size();
+    while (p != end && status == tableCipher::textStatus::ok) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        if (!russianText::isLetter(c)) {
+            status = tableCipher::textStatus::invalidText;
+        }
+        text_len++;
+    }
+    watch.lap(cipherStage::validate);
+    const size_t k = transposition.key;
+    if (cipher_text.empty()) {
+        status = tableCipher::textStatus::emptyText;
+    } else if (status == tableCipher::textStatus::ok && text_len == 0) {
+        status = tableCipher::textStatus::onlySpaces;
+    } else if (status == tableCipher::textStatus::ok && text_len <= k) {
+        stats::failure(static_cast<unsigned>(tableCipher::textStatus::tooShort));
+        throw tableCipher_error(tableCipher::lengthMessage(text_len, transposition.key, "decryption"));
+    }
+    if (status != tableCipher::textStatus::ok) {
+        stats::failure(static_cast<unsigned>(status));
+        throw tableCipher_error(tableCipher::statusMessage(status));
+    }
+
+    std::basic_string<Char> result(unitsPerLetter<Char> * text_len, Char(0));
+    stats::allocated(result.size() * sizeof(Char));
+    const letterTable& t = letters();
+    const std::vector<int>& shift = substitution.key;
+    const size_t period = shift.size();
+    const size_t step = k % period;
+    const size_t rows = (text_len + k - 1) / k;
+    const size_t full = text_len - (rows - 1) * k;
+
+    // Шифртекст состоит из столбцов j = key-1..0; буква строки i столбца j
+    // стоит в открытом тексте на месте i * key + j, и позиция ключа для неё
+    // растёт вдоль столбца на key
+    size_t i = 0;
+    size_t j = k - 1;
+    size_t height = j < full ? rows : rows - 1;
+    size_t target = j;
+    size_t position = j % period;
+    Char* out = &result[0];
+    p = cipher_text.data();
+    while (p != end) {
+        char32_t c = nextChar(p, end);
+        if (c == U' ') {
+            continue;
+        }
+        const int index = russianText::letterIndex(c) - shift[position];
+        putLetter(t, index < 0 ? index + alphaSize : index, out, target);
+        target += k;
+        position += step;
+        if (position >= period) {
+            position -= period;
+        }
+        if (++i == height && j > 0) {
+            i = 0;
+            target = --j;
+            height = j < full ? rows : rows - 1;
+            position = j % period;
+        }
+    }
+    watch.lap(cipherStage::transform);
+    return result;
+}
+
+/**
+ * @brief Зашифровывание
+ * @param open_text Открытый текст
+ * @return Шифртекст из заглавных русских букв
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ * @throw tableCipher_error Если букв не больше, чем столбцов
+ */
+std::wstring productCipher::encrypt(const std::wstring& open_text) const
+{
+    return encryptText(std::wstring_view(open_text));
+}
+
+/**
+ * @brief Расшифровывание
+ * @param cipher_text Шифртекст; пробелы пропускаются, регистр не важен
+ * @return Открытый текст из заглавных русских букв
+ * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+ */
+std::wstring productCipher::decrypt(const std::wstring& cipher_text) const
+{
+    return decryptText(std::wstring_view(cipher_text));
+}
+
+/**
+ * @brief Зашифровывание текста в UTF-8
+ * @param open_text Открытый текст в UTF-8
+ * @return Шифртекст в UTF-8
+ * @throw cipher_error Если текст пустой или не содержит русских букв
+ * @throw tableCipher_error Если букв не больше, чем столбцов
+ */
+std::string productCipher::encrypt(std::string_view open_text) const
+{
+    return encryptText(open_text);
+}
+
+/**
+ * @brief Расшифровывание текста в UTF-8
+ * @param cipher_text Шифртекст в UTF-8
+ * @return Открытый текст в UTF-8
+ * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+ */
+std::string productCipher::decrypt(std::string_view cipher_text) const
+{
+    return decryptText(cipher_text);
+}
+
+/**
+ * @brief Снимок счётчиков модуля
+ * @return Сумма счётчиков всех потоков
+ */
+cipherCounters productCipher::statsSnapshot()
+{
+    return stats::snapshot();
+}
+
+/**
+ * @brief Обнуление счётчиков модуля
+ */
+void productCipher::resetStats()
+{
+    stats::reset();
+}
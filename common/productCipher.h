@@ -0,0 +1,123 @@
+/**
+ * @file productCipher.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для составного шифра: Гронсфельд, затем табличная перестановка
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include "../1_Zadanie/modAlphaCipher.h"
+#include "../2_Zadanie/tableCipher.h"
+#include "cipherStats.h"
+
+/**
+ * @brief Составной шифр: шифр Гронсфельда, затем табличная перестановка
+ * @details Результат совпадает с последовательным применением
+ *          modAlphaCipher::encrypt и tableCipher::encrypt (расшифровывание -
+ *          tableCipher::decrypt, затем modAlphaCipher::decrypt), включая тип и
+ *          текст исключений. Вместо двух нормализаций, двух промежуточных
+ *          строк и двух проверок текст проверяется и буквы считаются одним
+ *          проходом, после чего каждая буква за второй проход сдвигается по
+ *          ключу и сразу записывается на своё место маршрута в строку
+ *          результата. Строка результата - единственное выделение памяти.
+ *
+ *          Выход шифра Гронсфельда всегда допустим для перестановки, поэтому
+ *          из её проверок при зашифровывании остаётся только длина текста.
+ *          При расшифровывании шифртекст проверяется по правилам перестановки,
+ *          а её результат всегда допустим для шифра Гронсфельда.
+ */
+class productCipher
+{
+private:
+    modAlphaCipher substitution; ///< Шифр Гронсфельда: ключ и таблицы алфавита
+    tableCipher transposition; ///< Перестановка: количество столбцов и маршрут
+
+    /**
+     * @brief Зашифровывание в строку результата
+     * @param open_text Открытый текст
+     * @return Шифртекст
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     * @throw tableCipher_error Если букв не больше, чем столбцов
+     */
+    template <typename Char>
+    std::basic_string<Char> encryptText(std::basic_string_view<Char> open_text) const;
+
+    /**
+     * @brief Расшифровывание в строку результата
+     * @param cipher_text Шифртекст
+     * @return Открытый текст
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+     */
+    template <typename Char>
+    std::basic_string<Char> decryptText(std::basic_string_view<Char> cipher_text) const;
+
+public:
+    /**
+     * @brief Запрет конструктора без параметров
+     */
+    productCipher() = delete;
+
+    /**
+     * @brief Конструктор составного шифра
+     * @param key Ключ шифра Гронсфельда
+     * @param columns Количество столбцов таблицы
+     * @throw cipher_error Если ключ шифра Гронсфельда невалиден
+     * @throw tableCipher_error Если количество столбцов невалидно
+     */
+    productCipher(const std::wstring& key, int columns);
+
+    /**
+     * @brief Зашифровывание
+     * @param open_text Открытый текст
+     * @return Шифртекст из заглавных русских букв
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     * @throw tableCipher_error Если букв не больше, чем столбцов
+     */
+    std::wstring encrypt(const std::wstring& open_text) const;
+
+    /**
+     * @brief Расшифровывание
+     * @param cipher_text Шифртекст; пробелы пропускаются, регистр не важен
+     * @return Открытый текст из заглавных русских букв
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+     */
+    std::wstring decrypt(const std::wstring& cipher_text) const;
+
+    /**
+     * @brief Зашифровывание текста в UTF-8
+     * @param open_text Открытый текст в UTF-8
+     * @return Шифртекст в UTF-8
+     * @throw cipher_error Если текст пустой или не содержит русских букв
+     * @throw tableCipher_error Если букв не больше, чем столбцов
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Расшифровывание текста в UTF-8
+     * @param cipher_text Шифртекст в UTF-8
+     * @return Открытый текст в UTF-8
+     * @throw tableCipher_error Если текст пустой, содержит недопустимые символы или недостаточной длины
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Снимок счётчиков модуля
+     * @details Счётчики ведутся только при сборке с -DCIPHER_STATS, иначе
+     *          снимок нулевой. Отказы учитываются по значениям
+     *          tableCipher::textStatus, отказы шифра Гронсфельда - по
+     *          modAlphaCipher::textStatus со смещением 4. Проход проверки и
+     *          подсчёта букв учитывается как validate, общий проход сдвига и
+     *          перестановки - как transform.
+     * @return Сумма счётчиков всех потоков
+     */
+    static cipherCounters statsSnapshot();
+
+    /**
+     * @brief Обнуление счётчиков модуля
+     */
+    static void resetStats();
+};
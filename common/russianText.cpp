@@ -0,0 +1,99 @@
+/**
+ * @file russianText.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Реализация модуля нормализации русского текста
+ */
+
+#include "russianText.h"
+
+/**
+ * @brief Построение таблиц на этапе компиляции
+ * @details Номера букв соответствуют алфавиту АБВГДЕЁЖЗ...Я: буквы А..Е имеют
+ *          номера 0..5, Ё - 6, Ж..Я - 7..32.
+ */
+constexpr russianText::tables::tables() : upper(), index(), upperIndex()
+{
+    for (unsigned i = 0; i < span; i++) {
+        upper[i] = 0;
+        index[i] = -1;
+        upperIndex[i] = -1;
+    }
+    for (unsigned c = U'А'; c <= U'Я'; c++) {
+        const signed char n = static_cast<signed char>(c - U'А' + (c > U'Е' ? 1 : 0));
+        upper[c - base] = static_cast<char16_t>(c);
+        upper[c + (U'а' - U'А') - base] = static_cast<char16_t>(c);
+        index[c - base] = n;
+        index[c + (U'а' - U'А') - base] = n;
+        upperIndex[c - base] = n;
+    }
+    upper[U'Ё' - base] = U'Ё';
+    upper[U'ё' - base] = U'Ё';
+    index[U'Ё' - base] = 6;
+    index[U'ё' - base] = 6;
+    upperIndex[U'Ё' - base] = 6;
+}
+
+constexpr russianText::tables russianText::data;
+
+/**
+ * @brief Алфавит в порядке номеров букв
+ * @return Строка из 33 заглавных букв (Ё после Е)
+ */
+const std::wstring& russianText::alphabet()
+{
+    static const std::wstring letters = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    return letters;
+}
+
+/**
+ * @brief Приведение строки к верхнему регистру с удалением пробелов
+ * @param s Входная строка
+ * @return Строка без пробелов, русские буквы в верхнем регистре
+ */
+std::wstring russianText::stripUpper(const std::wstring& s)
+{
+    std::wstring result;
+    result.reserve(s.size());
+    for (wchar_t c : s) {
+        if (c != L' ') {
+            result.push_back(static_cast<wchar_t>(toUpper(c)));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Декодирование многобайтовой последовательности UTF-8
+ * @param lead Первый байт последовательности
+ * @param p Позиция за первым байтом, сдвигается за последовательность
+ * @param end Конец текста
+ * @return Кодовая точка или U+FFFD, в том числе для избыточно длинной записи и суррогатов
+ */
+char32_t russianText::decodeUtf8Tail(unsigned char lead, const char*& p, const char* end)
+{
+    char32_t c;
+    int need;
+    if ((lead & 0xE0) == 0xC0) {
+        c = lead & 0x1F;
+        need = 1;
+    } else if ((lead & 0xF0) == 0xE0) {
+        c = lead & 0x0F;
+        need = 2;
+    } else if ((lead & 0xF8) == 0xF0) {
+        c = lead & 0x07;
+        need = 3;
+    } else {
+        return U'\uFFFD';
+    }
+    const int length = need + 1;
+    for (; need > 0; need--) {
+        if (p == end || (static_cast<unsigned char>(*p) & 0xC0) != 0x80) {
+            return U'\uFFFD';
+        }
+        c = (c << 6) | (*p++ & 0x3F);
+    }
+    return checkedCodePoint(c, length);
+}
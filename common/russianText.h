@@ -0,0 +1,191 @@
+/**
+ * @file russianText.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Заголовочный файл для модуля нормализации русского текста
+ */
+
+#pragma once
+#include <string>
+
+/**
+ * @brief Нормализация русского текста по статическим таблицам
+ * @details Общий модуль для шифров Гронсфельда и табличной перестановки.
+ *          Приведение к верхнему регистру (включая Ё), определение номера буквы
+ *          в алфавите и удаление пробелов выполняются по таблицам, построенным
+ *          на этапе компиляции, без обращения к std::locale. Поэтому результат
+ *          не зависит от установленных в системе локалей.
+ */
+class russianText
+{
+public:
+    static constexpr int alphaSize = 33; ///< Количество букв алфавита
+    static constexpr unsigned base = 0x400; ///< Первая кодовая точка блока кириллицы
+    static constexpr unsigned span = 0x60; ///< Размер обслуживаемого диапазона кодовых точек
+
+private:
+    /**
+     * @brief Таблицы нормализации
+     */
+    struct tables {
+        char16_t upper[span]; ///< Заглавная буква по (кодовая точка - base), 0 для прочих символов
+        signed char index[span]; ///< Номер буквы любого регистра по (кодовая точка - base), -1 для прочих
+        signed char upperIndex[span]; ///< Номер только заглавной буквы по (кодовая точка - base), -1 для прочих
+
+        /**
+         * @brief Построение таблиц на этапе компиляции
+         */
+        constexpr tables();
+    };
+
+    static const tables data; ///< Таблицы нормализации
+
+public:
+    /**
+     * @brief Запрет создания объектов
+     */
+    russianText() = delete;
+
+    /**
+     * @brief Алфавит в порядке номеров букв
+     * @return Строка из 33 заглавных букв (Ё после Е)
+     */
+    static const std::wstring& alphabet();
+
+    /**
+     * @brief Приведение русской буквы к верхнему регистру
+     * @param c Кодовая точка
+     * @return Заглавная буква для русских букв, иначе c без изменений
+     */
+    static char32_t toUpper(char32_t c)
+    {
+        const unsigned offset = static_cast<unsigned>(c) - base;
+        return offset < span && data.upper[offset] ? data.upper[offset] : c;
+    }
+
+    /**
+     * @brief Номер русской буквы любого регистра
+     * @param c Кодовая точка
+     * @return Номер буквы в алфавите или -1
+     */
+    static int letterIndex(char32_t c)
+    {
+        const unsigned offset = static_cast<unsigned>(c) - base;
+        return offset < span ? data.index[offset] : -1;
+    }
+
+    /**
+     * @brief Номер русской буквы любого регистра на этапе компиляции
+     * @details Вычисляется без таблиц, поэтому пригоден для static_assert;
+     *          результат совпадает с letterIndex.
+     * @param c Кодовая точка
+     * @return Номер буквы в алфавите или -1
+     */
+    static constexpr int constLetterIndex(char32_t c)
+    {
+        if (c == U'Ё' || c == U'ё') {
+            return 6;
+        }
+        if (c >= U'а' && c <= U'я') {
+            c -= U'а' - U'А';
+        }
+        if (c < U'А' || c > U'Я') {
+            return -1;
+        }
+        return static_cast<int>(c - U'А') + (c > U'Е' ? 1 : 0);
+    }
+
+    /**
+     * @brief Номер заглавной русской буквы
+     * @param c Кодовая точка
+     * @return Номер буквы в алфавите или -1, если c не является заглавной русской буквой
+     */
+    static int upperIndex(char32_t c)
+    {
+        const unsigned offset = static_cast<unsigned>(c) - base;
+        return offset < span ? data.upperIndex[offset] : -1;
+    }
+
+    /**
+     * @brief Проверка на русскую букву любого регистра
+     * @param c Кодовая точка
+     * @return true для русских букв
+     */
+    static bool isLetter(char32_t c) { return letterIndex(c) >= 0; }
+
+    /**
+     * @brief Проверка на заглавную русскую букву
+     * @param c Кодовая точка
+     * @return true для заглавных русских букв
+     */
+    static bool isUpperLetter(char32_t c) { return upperIndex(c) >= 0; }
+
+    /**
+     * @brief Приведение строки к верхнему регистру с удалением пробелов
+     * @param s Входная строка
+     * @return Строка без пробелов, русские буквы в верхнем регистре
+     */
+    static std::wstring stripUpper(const std::wstring& s);
+
+    /**
+     * @brief Декодирование одного символа UTF-8
+     * @details Некорректная или оборванная последовательность считается одним
+     *          символом U+FFFD, байт, на котором она оборвалась, не поглощается.
+     * @param p Текущая позиция, сдвигается за декодированный символ
+     * @param end Конец текста
+     * @return Кодовая точка
+     */
+    static char32_t decodeUtf8(const char*& p, const char* end)
+    {
+        const unsigned char b = static_cast<unsigned char>(*p++);
+        if (b < 0x80) {
+            return b;
+        }
+        // Двухбайтовые последовательности (в том числе вся кириллица)
+        // декодируются на месте, остальные - в decodeUtf8Tail
+        if (b >= 0xC2 && b < 0xE0 && p != end && (static_cast<unsigned char>(*p) & 0xC0) == 0x80) {
+            return static_cast<char32_t>(((b & 0x1F) << 6) | (static_cast<unsigned char>(*p++) & 0x3F));
+        }
+        return decodeUtf8Tail(b, p, end);
+    }
+
+    /**
+     * @brief Проверка кодовой точки, собранной из последовательности UTF-8
+     * @details Избыточно длинная запись (например, буква А тремя байтами),
+     *          суррогаты и значения больше U+10FFFF заменяются на U+FFFD.
+     * @param c Кодовая точка
+     * @param length Длина последовательности в байтах, от 2 до 4
+     * @return Кодовая точка или U+FFFD
+     */
+    static char32_t checkedCodePoint(char32_t c, int length)
+    {
+        static constexpr char32_t least[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (c < least[length] || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+            return U'\uFFFD';
+        }
+        return c;
+    }
+
+    /**
+     * @brief Запись заглавной русской буквы в UTF-8
+     * @param c Кодовая точка из диапазона U+0400..U+045F
+     * @param out Позиция записи двух байтов
+     */
+    static void encodeLetter(char32_t c, char* out)
+    {
+        out[0] = static_cast<char>(0xC0 | (c >> 6));
+        out[1] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+
+private:
+    /**
+     * @brief Декодирование многобайтовой последовательности UTF-8
+     * @param lead Первый байт последовательности
+     * @param p Позиция за первым байтом, сдвигается за последовательность
+     * @param end Конец текста
+     * @return Кодовая точка или U+FFFD
+     */
+    static char32_t decodeUtf8Tail(unsigned char lead, const char*& p, const char* end);
+};
@@ -0,0 +1,154 @@
+/**
+ * @file testAllocations.cpp
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Замена глобальных operator new и operator delete с подсчётом выделений для тестов
+ * @details Заменяются все формы: одиночные и для массивов, nothrow и с
+ *          выравниванием, так что ни одно выделение не проходит мимо счётчика.
+ */
+
+#include "testAllocations.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<size_t> allocationCount{0};
+
+namespace {
+
+/**
+ * @brief Выделение памяти с подсчётом
+ * @param size Размер в байтах
+ * @param alignment Выравнивание, 0 - выравнивание malloc
+ * @return Указатель на выделенную память или nullptr
+ */
+void* countedAlloc(size_t size, size_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment == 0) {
+        return std::malloc(size);
+    }
+    // aligned_alloc требует размер, кратный выравниванию
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+/**
+ * @brief Выделение памяти с подсчётом и исключением при нехватке
+ * @param size Размер в байтах
+ * @param alignment Выравнивание, 0 - выравнивание malloc
+ * @return Указатель на выделенную память
+ * @throw std::bad_alloc Если память не выделена
+ */
+void* countedAllocOrThrow(size_t size, size_t alignment)
+{
+    if (void* p = countedAlloc(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return countedAllocOrThrow(size, 0);
+}
+
+void* operator new[](size_t size)
+{
+    return countedAllocOrThrow(size, 0);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return countedAllocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return countedAllocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
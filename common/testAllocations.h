@@ -0,0 +1,21 @@
+/**
+ * @file testAllocations.h
+ * @author Гришин Н.С.
+ * @version 1.0
+ * @date 03.12.2025
+ * @copyright ИБСТ ПГУ
+ * @brief Счётчик выделений памяти для модульных тестов
+ * @details Глобальные operator new и operator delete заменяются в
+ *          testAllocations.cpp, который собирается вместе с программой теста.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Количество выделений памяти в куче через operator new всех форм
+ * @details Счётчик атомарный: тесты конвейера и многопоточных методов
+ *          выделяют память из нескольких потоков одновременно.
+ */
+extern std::atomic<size_t> allocationCount;
@@ -0,0 +1,292 @@
+#include <UnitTest++/UnitTest++.h>
+#include "anyCipher.h"
+#include "../1_Zadanie/modAlphaCipher.h"
+#include "../2_Zadanie/tableCipher.h"
+#include <codecvt>
+#include <memory>
+#include <locale>
+#include <random>
+#include <string>
+#include <vector>
+
+// Перевод строки в UTF-8
+static std::string toUtf8(const std::wstring& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.to_bytes(s);
+}
+
+// Текст исключения общего интерфейса или результат
+template <typename F>
+static std::string outcome(F f) {
+    try {
+        return f();
+    } catch (const anyCipher_error& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Текст исключения модуля или результат
+template <typename F>
+static std::string moduleOutcome(F f) {
+    try {
+        return f();
+    } catch (const cipher_error& e) {
+        return std::string("error: ") + e.what();
+    } catch (const tableCipher_error& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Причина ошибки создания шифра
+static cipherStatus makeStatus(const cipherRegistry& registry, const std::string& config) {
+    try {
+        registry.make(config);
+    } catch (const anyCipher_error& e) {
+        return e.status();
+    }
+    return cipherStatus::ok;
+}
+
+// Сравнение шифра за общим интерфейсом с прямыми вызовами модуля
+template <typename Cipher>
+static void checkMatchesModule(const anyCipher& any, const Cipher& direct, const std::string& text) {
+    CHECK_EQUAL(moduleOutcome([&] { return direct.encrypt(std::string_view(text)); }),
+                outcome([&] { return any.encrypt(text); }));
+    CHECK_EQUAL(moduleOutcome([&] { return direct.decrypt(std::string_view(text)); }),
+                outcome([&] { return any.decrypt(text); }));
+    std::string expected;
+    std::string actual;
+    bool directOk = direct.tryEncrypt(std::string_view(text), expected) == Cipher::textStatus::ok;
+    CHECK_EQUAL(directOk, any.tryEncrypt(text, actual) == cipherStatus::ok);
+    CHECK_EQUAL(expected, actual);
+}
+
+// Шифр нового модуля для проверки расширения реестра: обращение текста
+struct reverseCipher {
+    size_t minLength; // Минимальная длина текста
+};
+
+// Обращение текста без исключений
+static cipherStatus reverseTry(const void* cipher, std::string_view text, std::string& out, bool) {
+    out.assign(text.rbegin(), text.rend());
+    if (text.empty()) {
+        return cipherStatus::emptyText;
+    }
+    return text.size() < static_cast<const reverseCipher*>(cipher)->minLength ? cipherStatus::tooShort
+                                                                              : cipherStatus::ok;
+}
+
+// Обращение текста с исключением при ошибке
+static std::string reverseRun(const void* cipher, std::string_view text, bool decrypting) {
+    std::string out;
+    cipherStatus status = reverseTry(cipher, text, out, decrypting);
+    if (status != cipherStatus::ok) {
+        throw anyCipher_error(status, "Текст не подходит для обращения");
+    }
+    return out;
+}
+
+// Обращение пакета сообщений
+static size_t reverseBatch(const void* cipher, const char* text, const size_t* offsets, size_t count,
+                           std::string& arena, std::vector<size_t>& arenaOffsets, std::vector<cipherStatus>& status,
+                           bool decrypting) {
+    arena.clear();
+    arenaOffsets.assign(1, 0);
+    status.resize(count);
+    size_t done = 0;
+    std::string out;
+    for (size_t i = 0; i < count; i++) {
+        status[i] = reverseTry(cipher, std::string_view(text + offsets[i], offsets[i + 1] - offsets[i]), out, decrypting);
+        if (status[i] == cipherStatus::ok) {
+            arena += out;
+            done++;
+        }
+        arenaOffsets.push_back(arena.size());
+    }
+    return done;
+}
+
+static const anyCipher::kernel reverseKernel = {"reverse", reverseRun, reverseTry, reverseBatch};
+
+// Тестовый сценарий для реестра шифров (RegistryTest)
+SUITE(RegistryTest) {
+    TEST(BuiltinCiphers) {
+        cipherRegistry registry;
+        CHECK_EQUAL(std::string("gronsfeld"), registry.make("gronsfeld:КЛЮЧ").name());
+        CHECK_EQUAL(std::string("table"), registry.make("table:5").name());
+    }
+
+    TEST(InvalidConfig) {
+        cipherRegistry registry;
+        CHECK(makeStatus(registry, "table") == cipherStatus::invalidConfig);
+        CHECK(makeStatus(registry, "caesar:3") == cipherStatus::invalidConfig);
+        CHECK(makeStatus(registry, ":5") == cipherStatus::invalidConfig);
+        CHECK(makeStatus(registry, "table:пять") == cipherStatus::invalidKey);
+        CHECK(makeStatus(registry, "table:5x") == cipherStatus::invalidKey);
+        CHECK(makeStatus(registry, "table:") == cipherStatus::invalidKey);
+        CHECK(makeStatus(registry, "table:2") == cipherStatus::invalidKey);
+        CHECK(makeStatus(registry, "gronsfeld:") == cipherStatus::invalidKey);
+        CHECK(makeStatus(registry, "gronsfeld:КЛЮЧ1") == cipherStatus::invalidKey);
+    }
+
+    TEST(KeyErrorMessages) {
+        cipherRegistry registry;
+        std::string expected = moduleOutcome([] { modAlphaCipher c(L"КЛЮЧ1"); return std::string(); });
+        CHECK_EQUAL(expected, outcome([&] { registry.make("gronsfeld:КЛЮЧ1"); return std::string(); }));
+        expected = moduleOutcome([] { tableCipher c(-4); return std::string(); });
+        CHECK_EQUAL(expected, outcome([&] { registry.make("table:-4"); return std::string(); }));
+    }
+
+    TEST(NewModule) {
+        cipherRegistry registry;
+        registry.add("reverse", [](std::string_view key) {
+            return anyCipher::wrap(std::make_shared<const reverseCipher>(reverseCipher{key.size()}), reverseKernel);
+        });
+        const anyCipher cipher = registry.make("reverse:abc");
+        CHECK_EQUAL(std::string("reverse"), cipher.name());
+        CHECK_EQUAL(std::string("dcba"), cipher.encrypt("abcd"));
+        CHECK_EQUAL(std::string("abcd"), cipher.decrypt("dcba"));
+        std::string out;
+        CHECK(cipher.tryEncrypt("ab", out) == cipherStatus::tooShort);
+        try {
+            cipher.encrypt("");
+            CHECK(false);
+        } catch (const anyCipher_error& e) {
+            CHECK(e.status() == cipherStatus::emptyText);
+        }
+        const std::string text = "abcdxyz";
+        const size_t offsets[] = {0, 4, 4, 7};
+        std::string arena;
+        std::vector<size_t> arenaOffsets;
+        std::vector<cipherStatus> status;
+        CHECK_EQUAL(2u, cipher.encryptBatch(text.data(), offsets, 3, arena, arenaOffsets, status));
+        CHECK_EQUAL(std::string("dcbazyx"), arena);
+        CHECK(status[1] == cipherStatus::emptyText);
+    }
+
+    TEST(CustomCipher) {
+        cipherRegistry registry;
+        registry.add("secret", [&registry](std::string_view) { return registry.make("gronsfeld:ТАЙНА"); });
+        std::string text = toUtf8(L"ПРИВЕТ");
+        CHECK_EQUAL(registry.make("gronsfeld:ТАЙНА").encrypt(text), registry.make("secret:").encrypt(text));
+        CHECK_THROW(registry.add("bad:name", nullptr), anyCipher_error);
+        CHECK_THROW(registry.add("", nullptr), anyCipher_error);
+    }
+}
+
+// Тестовый сценарий для равенства с прямыми вызовами модулей (DispatchTest)
+SUITE(DispatchTest) {
+    TEST(RandomTexts) {
+        cipherRegistry registry;
+        const modAlphaCipher gronsfeld(L"ДИСПЕТЧЕР");
+        const tableCipher table(6);
+        const anyCipher anyGronsfeld = registry.make("gronsfeld:ДИСПЕТЧЕР");
+        const anyCipher anyTable = registry.make("table:6");
+        std::mt19937 rng(47);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгд   019,.!";
+        std::wstring upper = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        for (int n = 0; n < 200; n++) {
+            std::wstring text;
+            size_t len = rng() % 3 == 0 ? rng() % 8 : rng() % 200;
+            const std::wstring& source = n % 2 == 0 ? upper : alpha;
+            for (size_t i = 0; i < len; i++) {
+                text += source[rng() % source.size()];
+            }
+            checkMatchesModule(anyGronsfeld, gronsfeld, toUtf8(text));
+            checkMatchesModule(anyTable, table, toUtf8(text));
+        }
+    }
+
+    TEST(UnifiedErrors) {
+        cipherRegistry registry;
+        const anyCipher gronsfeld = registry.make("gronsfeld:КЛЮЧ");
+        const anyCipher table = registry.make("table:5");
+        std::string out;
+        CHECK(gronsfeld.tryEncrypt("", out) == cipherStatus::emptyText);
+        CHECK(gronsfeld.tryEncrypt("   ", out) == cipherStatus::emptyText);
+        CHECK(gronsfeld.tryEncrypt("12345", out) == cipherStatus::invalidText);
+        CHECK(gronsfeld.tryDecrypt("", out) == cipherStatus::emptyText);
+        CHECK(gronsfeld.tryDecrypt(toUtf8(L"При вет"), out) == cipherStatus::invalidText);
+        CHECK(table.tryEncrypt("", out) == cipherStatus::emptyText);
+        CHECK(table.tryEncrypt("   ", out) == cipherStatus::emptyText);
+        CHECK(table.tryEncrypt("12345", out) == cipherStatus::invalidText);
+        CHECK(table.tryEncrypt(toUtf8(L"ПРИВЕ"), out) == cipherStatus::tooShort);
+        CHECK(table.tryDecrypt(toUtf8(L"ПРИ ВЕ"), out) == cipherStatus::tooShort);
+        try {
+            table.encrypt(toUtf8(L"ПРИВЕ"));
+            CHECK(false);
+        } catch (const anyCipher_error& e) {
+            CHECK(e.status() == cipherStatus::tooShort);
+        }
+    }
+
+    TEST(SharedCopies) {
+        cipherRegistry registry;
+        const anyCipher original = registry.make("table:4");
+        const anyCipher copy = original;
+        std::string text = toUtf8(L"КОПИЯШИФРА");
+        CHECK_EQUAL(original.encrypt(text), copy.encrypt(text));
+    }
+}
+
+// Тестовый сценарий для пакетной обработки (BatchTest)
+SUITE(BatchTest) {
+    // Пакет из сообщений разной длины, включая ошибочные
+    static std::string batchText(std::vector<size_t>& offsets) {
+        std::mt19937 rng(53);
+        std::wstring upper = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ ";
+        std::string text;
+        offsets.assign(1, 0);
+        for (int n = 0; n < 300; n++) {
+            std::wstring message;
+            size_t len = n % 17 == 0 ? 0 : rng() % 40;
+            for (size_t i = 0; i < len; i++) {
+                message += upper[rng() % upper.size()];
+            }
+            text += n % 23 == 0 ? std::string("abc") : toUtf8(message);
+            offsets.push_back(text.size());
+        }
+        return text;
+    }
+
+    // Сравнение пакета за общим интерфейсом с пакетом модуля
+    template <typename Cipher>
+    static void checkBatch(const anyCipher& any, const Cipher& direct, bool decrypting) {
+        std::vector<size_t> offsets;
+        const std::string text = batchText(offsets);
+        const size_t count = offsets.size() - 1;
+        std::string expectedArena;
+        std::string arena;
+        std::vector<size_t> expectedOffsets;
+        std::vector<size_t> arenaOffsets;
+        std::vector<typename Cipher::textStatus> expectedStatus;
+        std::vector<cipherStatus> status;
+        size_t expectedDone = decrypting
+            ? direct.decryptBatch(text.data(), offsets.data(), count, expectedArena, expectedOffsets, expectedStatus)
+            : direct.encryptBatch(text.data(), offsets.data(), count, expectedArena, expectedOffsets, expectedStatus);
+        size_t done = decrypting ? any.decryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, status)
+                                 : any.encryptBatch(text.data(), offsets.data(), count, arena, arenaOffsets, status);
+        CHECK_EQUAL(expectedDone, done);
+        CHECK_EQUAL(expectedArena, arena);
+        CHECK(expectedOffsets == arenaOffsets);
+        CHECK_EQUAL(count, status.size());
+        for (size_t i = 0; i < count && i < status.size(); i++) {
+            std::string out;
+            cipherStatus single = decrypting ? any.tryDecrypt(text.substr(offsets[i], offsets[i + 1] - offsets[i]), out)
+                                             : any.tryEncrypt(text.substr(offsets[i], offsets[i + 1] - offsets[i]), out);
+            CHECK(single == status[i]);
+        }
+    }
+
+    TEST(MatchesModuleBatch) {
+        cipherRegistry registry;
+        checkBatch(registry.make("gronsfeld:ПАКЕТ"), modAlphaCipher(L"ПАКЕТ"), false);
+        checkBatch(registry.make("gronsfeld:ПАКЕТ"), modAlphaCipher(L"ПАКЕТ"), true);
+        checkBatch(registry.make("table:7"), tableCipher(7), false);
+        checkBatch(registry.make("table:7"), tableCipher(7), true);
+    }
+}
+
+int main(int argc, char** argv) {
+    return UnitTest::RunAllTests();
+}
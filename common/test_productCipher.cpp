@@ -0,0 +1,136 @@
+#include <UnitTest++/UnitTest++.h>
+#include "productCipher.h"
+#include "testAllocations.h"
+#include <codecvt>
+#include <locale>
+#include <random>
+#include <string>
+
+// Перевод строки в UTF-8
+static std::string toUtf8(const std::wstring& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.to_bytes(s);
+}
+
+// Результат шифрования или тип и текст исключения для сравнения с цепочкой шифров
+template <typename F>
+static std::string outcome(F f) {
+    try {
+        return f();
+    } catch (const cipher_error& e) {
+        return std::string("cipher_error: ") + e.what();
+    } catch (const tableCipher_error& e) {
+        return std::string("tableCipher_error: ") + e.what();
+    }
+}
+
+// Сравнение составного шифра с последовательным применением двух шифров
+static void checkMatchesChain(const std::wstring& key, int columns, const std::wstring& text) {
+    modAlphaCipher substitution(key);
+    tableCipher transposition(columns);
+    productCipher product(key, columns);
+    std::string utf8 = toUtf8(text);
+
+    CHECK_EQUAL(outcome([&] { return toUtf8(transposition.encrypt(substitution.encrypt(text))); }),
+                outcome([&] { return toUtf8(product.encrypt(text)); }));
+    CHECK_EQUAL(outcome([&] { return transposition.encrypt(std::string_view(substitution.encrypt(std::string_view(utf8)))); }),
+                outcome([&] { return product.encrypt(std::string_view(utf8)); }));
+    CHECK_EQUAL(outcome([&] { return toUtf8(substitution.decrypt(transposition.decrypt(text))); }),
+                outcome([&] { return toUtf8(product.decrypt(text)); }));
+    CHECK_EQUAL(outcome([&] { return substitution.decrypt(std::string_view(transposition.decrypt(std::string_view(utf8)))); }),
+                outcome([&] { return product.decrypt(std::string_view(utf8)); }));
+}
+
+// Тестовый сценарий для конструктора (KeyTest)
+SUITE(KeyTest) {
+    TEST(ValidKeys) {
+        CHECK_THROW(productCipher(L"", 5), cipher_error);
+        CHECK_THROW(productCipher(L"КЛЮЧ1", 5), cipher_error);
+        CHECK_THROW(productCipher(L"КЛЮЧ", 2), tableCipher_error);
+        CHECK_THROW(productCipher(L"КЛЮЧ", -1), tableCipher_error);
+    }
+}
+
+// Тестовый сценарий для равенства с цепочкой шифров (ChainTest)
+SUITE(ChainTest) {
+    TEST(KnownText) {
+        productCipher product(L"КЛЮЧ", 4);
+        std::wstring cipherText = tableCipher(4).encrypt(modAlphaCipher(L"КЛЮЧ").encrypt(L"Привет, мир! Ёжик"));
+        CHECK(product.encrypt(std::wstring(L"Привет, мир! Ёжик")) == cipherText);
+        CHECK(product.decrypt(cipherText) == L"ПРИВЕТМИРЁЖИК");
+    }
+
+    TEST(RandomTexts) {
+        std::mt19937 rng(41);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯабвгдеёжзийклмнопрстуфхцчшщъыьэюя   019,.!";
+        std::wstring upper = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        for (int n = 0; n < 300; n++) {
+            std::wstring key;
+            size_t keyLength = 1 + rng() % 12;
+            while (key.size() < keyLength) {
+                key += upper[rng() % upper.size()];
+            }
+            try {
+                modAlphaCipher check(key);
+            } catch (const cipher_error&) {
+                continue;
+            }
+            std::wstring text;
+            size_t len = rng() % 4 == 0 ? rng() % 8 : rng() % 3000;
+            // Каждый третий текст - только буквы, чтобы проверить и расшифровывание
+            const std::wstring& source = n % 3 == 0 ? upper : alpha;
+            for (size_t i = 0; i < len; i++) {
+                text += source[rng() % source.size()];
+            }
+            checkMatchesChain(key, 3 + rng() % 40, text);
+        }
+    }
+
+    TEST(LongText) {
+        std::mt19937 rng(43);
+        std::wstring alpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ ";
+        std::wstring text;
+        for (size_t i = 0; i < 300000; i++) {
+            text += alpha[rng() % alpha.size()];
+        }
+        for (int columns : {3, 7, 64, 1000}) {
+            checkMatchesChain(L"ДЛИННЫЙКЛЮЧ", columns, text);
+        }
+    }
+
+    TEST(Errors) {
+        checkMatchesChain(L"КЛЮЧ", 5, L"");
+        checkMatchesChain(L"КЛЮЧ", 5, L"     ");
+        checkMatchesChain(L"КЛЮЧ", 5, L"1234+8765=9999");
+        checkMatchesChain(L"КЛЮЧ", 5, L"При вет");
+        checkMatchesChain(L"КЛЮЧ", 5, L"ПРИВ,ЕТМИР");
+        checkMatchesChain(L"КЛЮЧ", 5, L"ПРИВЕ");
+    }
+
+    TEST(RoundTrip) {
+        productCipher product(L"ОБРАТНЫЙ", 6);
+        std::string text = toUtf8(L"Съешь же ещё этих мягких французских булок, да выпей чаю");
+        CHECK_EQUAL(toUtf8(L"СЪЕШЬЖЕЕЩЁЭТИХМЯГКИХФРАНЦУЗСКИХБУЛОКДАВЫПЕЙЧАЮ"),
+                    product.decrypt(std::string_view(product.encrypt(std::string_view(text)))));
+    }
+}
+
+// Тестовый сценарий для единственного выделения памяти (AllocationTest)
+SUITE(AllocationTest) {
+    TEST(SingleAllocation) {
+        productCipher product(L"КЛЮЧ", 5);
+        std::string text = toUtf8(L"Съешь же ещё этих мягких французских булок, да выпей чаю");
+        std::string cipherText = product.encrypt(std::string_view(text));
+        size_t before = allocationCount;
+        std::string again = product.encrypt(std::string_view(text));
+        CHECK_EQUAL(1u, allocationCount - before);
+        before = allocationCount;
+        std::string plain = product.decrypt(std::string_view(cipherText));
+        CHECK_EQUAL(1u, allocationCount - before);
+        CHECK(again == cipherText);
+    }
+}
+
+int main(int argc, char** argv) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,98 @@
+#include <UnitTest++/UnitTest++.h>
+#include "russianText.h"
+#include <string>
+
+SUITE(NormalizeTest) {
+    TEST(UpperCaseLetters) {
+        CHECK(russianText::toUpper(U'а') == U'А');
+        CHECK(russianText::toUpper(U'я') == U'Я');
+        CHECK(russianText::toUpper(U'ё') == U'Ё');
+        CHECK(russianText::toUpper(U'Ж') == U'Ж');
+    }
+
+    TEST(OtherCharactersUnchanged) {
+        CHECK(russianText::toUpper(U'1') == U'1');
+        CHECK(russianText::toUpper(U'a') == U'a');
+        CHECK(russianText::toUpper(U'ѐ') == U'ѐ');
+        CHECK(russianText::toUpper(U'€') == U'€');
+    }
+
+    TEST(LetterIndexFollowsAlphabet) {
+        const std::wstring& alpha = russianText::alphabet();
+        CHECK_EQUAL(33u, alpha.size());
+        for (size_t i = 0; i < alpha.size(); i++) {
+            CHECK_EQUAL(int(i), russianText::upperIndex(alpha[i]));
+            CHECK_EQUAL(int(i), russianText::letterIndex(alpha[i]));
+        }
+        CHECK_EQUAL(6, russianText::letterIndex(U'ё'));
+        CHECK_EQUAL(-1, russianText::upperIndex(U'ё'));
+        CHECK_EQUAL(-1, russianText::letterIndex(U' '));
+        CHECK_EQUAL(-1, russianText::letterIndex(U'Ѐ'));
+    }
+
+    TEST(ConstLetterIndexMatchesTable) {
+        static_assert(russianText::constLetterIndex(U'ё') == 6, "Ё follows Е");
+        for (char32_t c = 0; c < 0x500; c++) {
+            CHECK_EQUAL(russianText::letterIndex(c), russianText::constLetterIndex(c));
+        }
+    }
+
+    TEST(StripUpper) {
+        CHECK(russianText::stripUpper(L" Съешь ещё 12 булок! ") == L"СЪЕШЬЕЩЁ12БУЛОК!");
+        CHECK(russianText::stripUpper(L"   ").empty());
+    }
+
+    TEST(DecodeUtf8) {
+        const std::string text = "a\xD0\x81\xD1\x91\xE2\x82\xAC\xD0";
+        const char* p = text.data();
+        const char* end = p + text.size();
+        CHECK(russianText::decodeUtf8(p, end) == U'a');
+        CHECK(russianText::decodeUtf8(p, end) == U'Ё');
+        CHECK(russianText::decodeUtf8(p, end) == U'ё');
+        CHECK(russianText::decodeUtf8(p, end) == U'€');
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(p == end);
+    }
+
+    TEST(DecodeUtf8OverlongThreeBytes) {
+        // Буква А (U+0410) тремя байтами вместо двух
+        const std::string text = "\xE0\x90\x90\xD0\x90";
+        const char* p = text.data();
+        const char* end = p + text.size();
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(russianText::decodeUtf8(p, end) == U'А');
+        CHECK(p == end);
+    }
+
+    TEST(DecodeUtf8OverlongFourBytes) {
+        // Буква А (U+0410) четырьмя байтами и € (U+20AC) четырьмя байтами
+        const std::string text = "\xF0\x80\x90\x90\xF0\x82\x82\xAC";
+        const char* p = text.data();
+        const char* end = p + text.size();
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(p == end);
+    }
+
+    TEST(DecodeUtf8Surrogates) {
+        const std::string text = "\xED\xA0\x80\xED\xBF\xBF\xED\x9F\xBF";
+        const char* p = text.data();
+        const char* end = p + text.size();
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(russianText::decodeUtf8(p, end) == U'\uFFFD');
+        CHECK(russianText::decodeUtf8(p, end) == U'\uD7FF');
+        CHECK(p == end);
+    }
+
+    TEST(EncodeLetter) {
+        char out[2];
+        russianText::encodeLetter(U'Ё', out);
+        CHECK_EQUAL(std::string("\xD0\x81"), std::string(out, 2));
+        russianText::encodeLetter(U'Я', out);
+        CHECK_EQUAL(std::string("\xD0\xAF"), std::string(out, 2));
+    }
+}
+
+int main(int argc, char** argv) {
+    return UnitTest::RunAllTests();
+}